@@ -0,0 +1,172 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  File Name:  Autotune.cpp                                                  //
+//                                                                            //
+//     Author:  Andreas Buttenschoen <andreas@buttenschoen.ca>                //
+//    Created:  2026-10-19 00:12:08                                           //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Measures the expression assignment, the dot, max and supNorm kernels and
+// the chunked kernels on this host over candidate parameters, and writes the
+// best ones as a tuning profile:
+//
+//      Autotune [profile file] [vector length]
+//
+// Point FASTVECTOR_TUNING_PROFILE at the file to use it.
+//
+// The parameters are tuned one after the other, each with the best values of
+// the ones before: the threads, the chunks of the chunked kernels, the
+// assignment unroll for double and float, the prefetch distance and the
+// streaming store threshold.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <omp.h>
+
+#include "DynamicVector.h"
+#include "DynamicVectorScan.h"
+#include "Timing.h"
+
+namespace {
+
+// the runs per timing, of which the best is kept
+constexpr int Repetitions = 7;
+
+// keeps the results of the reductions alive
+volatile double sink;
+
+template <typename T>
+double time_assignment(std::size_t n)
+{
+    CSVector<T> x(n), y(n, T(1)), z(n, T(2));
+    return Timing::timeit([&]() { x = T(2) * y + z; }, Repetitions);
+}
+
+template <typename T>
+double time_reductions(std::size_t n)
+{
+    CSVector<T> y(n, T(1)), z(n, T(2));
+    return Timing::timeit([&]() { sink = double(dot(y, z)); }, Repetitions)
+         + Timing::timeit([&]() { sink = double(max(y)); }, Repetitions)
+         + Timing::timeit([&]() { sink = double(supNorm(z)); }, Repetitions);
+}
+
+// the kernels split into Tuning::chunks() pieces: the reductions of
+// expressions, argmax and the scan
+template <typename T>
+double time_chunked(std::size_t n)
+{
+    CSVector<T> y(n, T(1)), z(n, T(2)), w(n);
+    return Timing::timeit([&]() { sink = double(sum(y + z)); }, Repetitions)
+         + Timing::timeit([&]() { sink = double(dot(y + z, z - y)); }, Repetitions)
+         + Timing::timeit([&]() { sink = double(argmax(y)); }, Repetitions)
+         + Timing::timeit([&]() { inclusiveScan(y, w); }, Repetitions);
+}
+
+// Sets parameter to each candidate, and leaves it at the fastest
+template <typename Benchmark>
+void tune(const char * name, std::size_t& parameter,
+          const std::vector<std::size_t>& candidates, Benchmark benchmark)
+{
+    std::size_t best = parameter;
+    double bestTime  = std::numeric_limits<double>::max();
+
+    for (const std::size_t candidate : candidates)
+    {
+        parameter = candidate;
+        const double t = benchmark();
+        std::cout << "  " << name << " = " << candidate << ": " << t * 1e3 << " ms" << std::endl;
+
+        if (t < bestTime)
+        {
+            bestTime = t;
+            best     = candidate;
+        }
+    }
+
+    parameter = best;
+    std::cout << name << " = " << best << std::endl;
+}
+
+} // end namespace
+
+int main(int argc, char * argv[])
+{
+    const std::string filename = (argc > 1) ? argv[1] : "fastvector.tuning";
+    const std::size_t n        = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : (1ul << 21);
+
+    Tuning::Profile& profile = Tuning::profile();
+
+    // the cached paths are tuned first, the streaming threshold last
+    const std::size_t streamingThreshold = profile.streamingThreshold;
+    profile.streamingThreshold = std::numeric_limits<std::size_t>::max();
+
+    std::vector<std::size_t> threads;
+    const std::size_t procs = std::size_t(omp_get_num_procs());
+    for (std::size_t t = 1; t < procs; t *= 2)
+        threads.push_back(t);
+    threads.push_back(procs);
+
+    tune("threads", profile.threads, threads,
+         [n]() { return time_assignment<double>(n); });
+
+    // the chunks run as one thread each, a few more than the processors may
+    // even out the imbalance between them
+    std::vector<std::size_t> chunks = threads;
+    chunks.push_back(2 * procs);
+
+    tune("chunks", profile.chunks, chunks,
+         [n]() { return time_chunked<double>(n); });
+
+    tune("block_size_double", profile.blockSizeDouble, {2, 4, 8},
+         [n]() { return time_assignment<double>(n); });
+
+    tune("block_size_float", profile.blockSizeFloat, {2, 4, 8},
+         [n]() { return time_assignment<float>(n); });
+
+    tune("prefetch_distance", profile.prefetchDistance, {1, 2, 4, 8, 16},
+         [n]() { return time_reductions<double>(n) + time_reductions<float>(n); });
+
+    // the smallest destination for which streaming stores beat normal ones
+    std::size_t threshold = streamingThreshold;
+    for (std::size_t bytes = 1ul << 20; bytes <= 1ul << 28; bytes *= 2)
+    {
+        const std::size_t size = bytes / sizeof(double);
+
+        profile.streamingThreshold = std::numeric_limits<std::size_t>::max();
+        const double cached = time_assignment<double>(size);
+
+        profile.streamingThreshold = 0;
+        const double streamed = time_assignment<double>(size);
+
+        std::cout << "  " << bytes << " bytes: " << cached * 1e3 << " ms cached, "
+                  << streamed * 1e3 << " ms streamed" << std::endl;
+
+        if (streamed < cached)
+        {
+            threshold = bytes;
+            break;
+        }
+    }
+
+    profile.streamingThreshold = threshold;
+    std::cout << "streaming_threshold = " << profile.streamingThreshold << std::endl;
+
+    if (!profile.save(filename))
+    {
+        std::cerr << "Could not write " << filename << "!" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "Wrote " << filename << std::endl;
+    return EXIT_SUCCESS;
+}
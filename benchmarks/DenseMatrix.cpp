@@ -0,0 +1,148 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  File Name:  DenseMatrix.cpp                                               //
+//                                                                            //
+//     Author:  Andreas Buttenschoen <andreas@buttenschoen.ca>                //
+//    Created:  2026-10-19 08:47:13                                           //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// The dense matrix products of DynamicMatrix:
+//
+//      DenseMatrix [max size] [threads]
+//
+// For square sizes doubling up to max size (default 2048), times y = A x and
+// y = A^T x in both storage orders, and C = A B, against the plain loops
+// (dot products over the rows, and the i-k-j loop for C). The gemv rows
+// report GB/s of the matrix read, the gemm rows GFLOP/s. The threads default
+// to those of the tuning profile.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "DynamicMatrix.h"
+
+namespace {
+
+// the best of the runs taking at least MinTime in total
+double seconds(const std::function<void()>& kernel)
+{
+    constexpr double MinTime = 0.2;
+
+    kernel();
+
+    double best = 1e30, total = 0.;
+    while (total < MinTime)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        kernel();
+        const double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        best   = std::min(best, t);
+        total += t;
+    }
+
+    return best;
+}
+
+template <StorageOrder Order>
+DynamicMatrix<double, Order> random(std::size_t n, std::mt19937& generator)
+{
+    std::uniform_real_distribution<double> uniform(-1., 1.);
+
+    DynamicMatrix<double, Order> ret(n, n);
+    for (std::size_t i = 0; i < n; ++i)
+        for (std::size_t j = 0; j < n; ++j)
+            ret(i, j) = uniform(generator);
+    return ret;
+}
+
+void row(const std::string& name, std::size_t n, double t, double rate, const char * unit)
+{
+    std::cout << std::left << std::setw(22) << name << std::right
+              << std::setw(7) << n
+              << std::setw(14) << std::setprecision(4) << t * 1e6 << " us"
+              << std::setw(10) << std::setprecision(3) << rate << " " << unit << std::endl;
+}
+
+} // end namespace
+
+int main(int argc, char * argv[])
+{
+    const std::size_t maxSize = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 2048;
+    if (argc > 2)
+        Tuning::profile().threads = std::strtoul(argv[2], nullptr, 10);
+
+    std::cout << "# threads " << Tuning::profile().threads << "\n"
+              << std::left << std::setw(22) << "# kernel" << std::right << std::setw(7) << "n"
+              << std::setw(17) << "time" << std::setw(14) << "rate" << std::endl;
+
+    std::mt19937 generator {42};
+    double sink = 0.;
+
+    for (std::size_t n = 64; n <= maxSize; n *= 2)
+    {
+        const auto a = random<StorageOrder::RowMajor>(n, generator);
+        const auto b = random<StorageOrder::RowMajor>(n, generator);
+        const auto c = random<StorageOrder::ColumnMajor>(n, generator);
+
+        CSVector<double> x(n, 1.), y(n);
+        const double bytes = double(n * n * sizeof(double)) * 1e-9;
+        const double flops = 2. * double(n) * double(n) * double(n) * 1e-9;
+
+        double t = seconds([&] { const auto r = a * x; sink += r[0]; });
+        row("A x, row major", n, t, bytes / t, "GB/s");
+
+        t = seconds([&] { const auto r = x * a; sink += r[0]; });
+        row("A^T x, row major", n, t, bytes / t, "GB/s");
+
+        t = seconds([&] { const auto r = c * x; sink += r[0]; });
+        row("A x, column major", n, t, bytes / t, "GB/s");
+
+        t = seconds([&]
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                double s = 0.;
+                for (std::size_t j = 0; j < n; ++j)
+                    s += a(i, j) * x[j];
+                y[i] = s;
+            }
+            sink += y[0];
+        });
+        row("A x, loops", n, t, bytes / t, "GB/s");
+
+        if (n > 1024)
+            continue;
+
+        t = seconds([&] { auto r = a * b; sink += r(0, 0); });
+        row("A B, gemm", n, t, flops / t, "GFLOP/s");
+
+        t = seconds([&] { auto r = c * b; sink += r(0, 0); });
+        row("A B, column major", n, t, flops / t, "GFLOP/s");
+
+        t = seconds([&]
+        {
+            DynamicMatrix<double> r(n, n);
+            r.setZero();
+            for (std::size_t i = 0; i < n; ++i)
+                for (std::size_t k = 0; k < n; ++k)
+                {
+                    const double aik = a(i, k);
+                    for (std::size_t j = 0; j < n; ++j)
+                        r(i, j) += aik * b(k, j);
+                }
+            sink += r(0, 0);
+        });
+        row("A B, loops", n, t, flops / t, "GFLOP/s");
+    }
+
+    return (sink == 0.) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
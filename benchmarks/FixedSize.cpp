@@ -0,0 +1,251 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  File Name:  FixedSize.cpp                                                 //
+//                                                                            //
+//     Author:  Andreas Buttenschoen <andreas@buttenschoen.ca>                //
+//    Created:  2026-10-19 04:12:51                                           //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Latency and throughput of the fixed size operations on ConstantVector,
+// Matrix<T, 3, 3>, Transform<T> and Quaternion<T>:
+//
+//      FixedSize [operations per measurement] [repetitions]
+//
+// Every operation is timed twice. The latency variant feeds each result into
+// the next call, so that the calls can't overlap. Operations returning a
+// scalar feed it back as a component of the next input, which adds a shuffle
+// to the chain. The throughput variant applies the operation to a small
+// array of independent inputs, which stays in L1.
+//
+// For both the time and the TSC cycles per operation are reported, and where
+// the hardware counters can be read (see PerfCounters.h) the core cycles and
+// the retired instructions per operation. The instruction count shows when a
+// change adds work to these inlined paths, even if the timings hide it.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#endif
+
+#include "Vector.h"
+#include "PerfCounters.h"
+
+using BasicDatatypes::Matrix;
+using BasicDatatypes::Transform;
+
+namespace {
+
+// the independent inputs of the throughput variant
+static constexpr std::size_t Inputs = 256;
+
+inline std::uint64_t ticks()
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// keeps the compiler from dropping or hoisting the computation of a value
+template <typename T>
+inline void escape(const T& value)
+{
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+struct Measurement
+{
+    double       ns;
+    double       ticks;
+    Perf::Sample counts;
+};
+
+// the fastest of the repetitions, per operation
+template <typename Function>
+Measurement measure(const Perf::Counters& counters, Function f, std::size_t ops, int repetitions)
+{
+    f();
+
+    Measurement best{std::numeric_limits<double>::max(), 0., Perf::Sample()};
+    for (int r = 0; r < repetitions; ++r)
+    {
+        const Perf::Sample before = counters.read();
+        const auto start          = std::chrono::steady_clock::now();
+        const std::uint64_t t0    = ticks();
+
+        f();
+
+        const std::uint64_t t1 = ticks();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        const Perf::Sample after = counters.read();
+
+        const double ns = elapsed.count() * 1e9 / double(ops);
+        if (ns < best.ns)
+            best = Measurement{ns, double(t1 - t0) / double(ops), after - before};
+    }
+
+    return best;
+}
+
+void header()
+{
+    std::cout << std::left << std::setw(22) << "operation" << std::setw(12) << "variant" << std::right
+              << std::setw(10) << "ns/op" << std::setw(10) << "tsc/op"
+              << std::setw(10) << "cyc/op" << std::setw(10) << "ins/op" << std::endl;
+}
+
+void print(const Perf::Sample& s, int c, double ops)
+{
+    std::cout << std::setw(10);
+    if (s.valid[c])
+        std::cout << double(s.value[c]) / ops;
+    else
+        std::cout << "-";
+}
+
+void row(const std::string& name, const char * variant, const Measurement& m, std::size_t ops)
+{
+    std::cout << std::left << std::setw(22) << name << std::setw(12) << variant << std::right
+              << std::setw(10) << m.ns << std::setw(10) << m.ticks;
+
+    print(m.counts, Perf::Cycles, double(ops));
+    print(m.counts, Perf::Instructions, double(ops));
+    std::cout << std::endl;
+}
+
+class Suite
+{
+public:
+    Suite(std::size_t ops, int repetitions)
+        : ops(ops), repetitions(repetitions), inputs(Inputs)
+    {
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<double> uniform(-1., 1.);
+        for (auto& v : inputs)
+            v = Normalize(Vector3d(uniform(generator), uniform(generator), uniform(generator)));
+    }
+
+    // The step maps the input of a call to the input of the next, the
+    // operation is applied to the independent inputs
+    template <typename Step, typename Operation>
+    void run(const std::string& name, Step step, Operation operation)
+    {
+        const Vector3d start = inputs[0];
+        row(name, "latency", measure(counters, [&]()
+        {
+            Vector3d v = start;
+            for (std::size_t i = 0; i < ops; ++i)
+            {
+                v = step(v);
+                escape(v);
+            }
+        }, ops, repetitions), ops);
+
+        using Result = decltype(operation(start));
+        std::vector<Result> results(Inputs);
+
+        const std::size_t sweeps = std::max<std::size_t>(ops / Inputs, 1);
+        row(name, "throughput", measure(counters, [&]()
+        {
+            for (std::size_t s = 0; s < sweeps; ++s)
+            {
+                for (std::size_t i = 0; i < Inputs; ++i)
+                    results[i] = operation(inputs[i]);
+                escape(results[0]);
+            }
+        }, sweeps * Inputs, repetitions), sweeps * Inputs);
+    }
+
+private:
+    std::size_t ops;
+    int         repetitions;
+
+    std::vector<Vector3d> inputs;
+
+    // on the calling thread only
+    Perf::Counters counters{1};
+};
+
+} // end namespace
+
+int main(int argc, char * argv[])
+{
+    const std::size_t ops = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : (1ul << 14);
+    const int repetitions = (argc > 2) ? std::atoi(argv[2]) : 5;
+
+    Suite suite(ops, repetitions);
+
+    std::cout << std::fixed << std::setprecision(2);
+    header();
+
+    const Vector3d w(0.5, 0.25, 0.25);
+    const Vector3d axis = Normalize(Vector3d(1., 2., 3.));
+    const Matrix<double, 3, 3> rotation = Matrix<double, 3, 3>::rotate(axis, 0.3);
+
+    suite.run("v + w",
+              [&](const Vector3d& v) { return Vector3d(v + w); },
+              [&](const Vector3d& v) { return Vector3d(v + w); });
+
+    // the weights of w sum to one, so the chain stays bounded
+    suite.run("Dot",
+              [&](const Vector3d& v) { return Vector3d(Dot(v, w), v.x, v.y); },
+              [&](const Vector3d& v) { return Dot(v, w); });
+
+    // a unit vector orthogonal to the chain keeps its norm
+    const Vector3d e_z(0., 0., 1.);
+    suite.run("Cross",
+              [&](const Vector3d& v) { return Cross(v, e_z); },
+              [&](const Vector3d& v) { return Cross(v, w); });
+
+    suite.run("Normalize",
+              [](const Vector3d& v) { return Normalize(v); },
+              [](const Vector3d& v) { return Normalize(v); });
+
+    suite.run("Angle",
+              [&](const Vector3d& v) { return Vector3d(Angle(v, w), v.x, v.y); },
+              [&](const Vector3d& v) { return Angle(v, w); });
+
+    suite.run("Matrix * v",
+              [&](const Vector3d& v) { return rotation * v; },
+              [&](const Vector3d& v) { return rotation * v; });
+
+    // assembling the transform dominates, the angle is taken from the input
+    suite.run("Transform::rotate",
+              [&](const Vector3d& v) { return Transform<double>::rotate(axis, v.x)(v); },
+              [&](const Vector3d& v) { return Transform<double>::rotate(axis, v.x)(v); });
+
+    suite.run("Quaternion::rotate",
+              [&](const Vector3d& v) { return Quaterniond::rotate(axis, v.x)(v); },
+              [&](const Vector3d& v) { return Quaterniond::rotate(axis, v.x)(v); });
+
+    const auto q = Quaterniond::rotate(axis, 0.3);
+    suite.run("Quaternion * v",
+              [&](const Vector3d& v) { return q(v); },
+              [&](const Vector3d& v) { return q(v); });
+
+    suite.run("Rotate",
+              [&](const Vector3d& v) { return Rotate(v, axis, 0.3); },
+              [&](const Vector3d& v) { return Rotate(v, axis, 0.3); });
+
+    suite.run("Rotate_x",
+              [](const Vector3d& v) { return Rotate_x(v, 0.3); },
+              [](const Vector3d& v) { return Rotate_x(v, 0.3); });
+
+    return EXIT_SUCCESS;
+}
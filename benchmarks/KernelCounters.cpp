@@ -0,0 +1,175 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  File Name:  KernelCounters.cpp                                            //
+//                                                                            //
+//     Author:  Andreas Buttenschoen <andreas@buttenschoen.ca>                //
+//    Created:  2026-10-19 02:58:13                                           //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Reads the hardware counters (see PerfCounters.h) around the CSVector
+// kernels, over a range of vector sizes:
+//
+//      KernelCounters [max vector length] [repetitions]
+//
+// For every kernel and size it reports the time, the counts per element, the
+// instructions per cycle, the bytes per cycle and the achieved fraction of
+// the STREAM triad bandwidth, which is measured first. The bytes are those
+// the kernel has to read and write; where the memory controller counters are
+// available the DRAM traffic is reported as well.
+//
+// Counters which can't be read are shown as "-".
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <omp.h>
+
+#include "DynamicVector.h"
+#include "PerfCounters.h"
+#include "Timing.h"
+
+namespace {
+
+volatile double sink;
+
+struct Kernel
+{
+    std::string name;
+
+    // the bytes read and written per element
+    std::size_t bytes;
+
+    std::function<void()> run;
+};
+
+struct Measurement
+{
+    double       seconds;
+    Perf::Sample counts;
+};
+
+// the fastest of the repetitions, with its counts
+Measurement measure(const Perf::Counters& counters, const std::function<void()>& f, int repetitions)
+{
+    f();
+
+    Measurement best{std::numeric_limits<double>::max(), Perf::Sample()};
+    for (int r = 0; r < repetitions; ++r)
+    {
+        const Perf::Sample before = counters.read();
+        const auto start = std::chrono::steady_clock::now();
+
+        f();
+
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        const Perf::Sample after = counters.read();
+
+        if (elapsed.count() < best.seconds)
+            best = Measurement{elapsed.count(), after - before};
+    }
+
+    return best;
+}
+
+void print(const Perf::Sample& s, int c, double per, int width)
+{
+    std::cout << std::setw(width);
+    if (s.valid[c])
+        std::cout << double(s.value[c]) / per;
+    else
+        std::cout << "-";
+}
+
+} // end namespace
+
+int main(int argc, char * argv[])
+{
+    const std::size_t maxLength = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : (1ul << 25);
+    const int repetitions       = (argc > 2) ? std::atoi(argv[2]) : 5;
+
+    const int threads = int(std::max(Tuning::profile().threads, Tuning::chunks()));
+
+    // before any other parallel region, so that the counters follow the team
+    Perf::Counters counters(threads);
+
+    for (int c = 0; c < Perf::NoCounters; ++c)
+        if (!counters.has(c))
+            std::cout << "# " << Perf::counter_name(c) << " not available" << std::endl;
+
+    const double peak = Timing::stream_peak(maxLength, threads);
+    std::cout << "# STREAM triad: " << peak * 1e-9 << " GB/s" << std::endl;
+
+    std::cout << std::left << std::setw(10) << "kernel" << std::right
+              << std::setw(12) << "n" << std::setw(12) << "ns/elem"
+              << std::setw(12) << "cyc/elem" << std::setw(12) << "ins/elem"
+              << std::setw(8) << "IPC" << std::setw(12) << "L1m/elem"
+              << std::setw(12) << "LLCm/elem" << std::setw(12) << "B/cycle"
+              << std::setw(10) << "GB/s" << std::setw(10) << "%STREAM"
+              << std::setw(12) << "DRAM B/elem" << std::endl;
+
+    std::cout << std::fixed << std::setprecision(3);
+
+    for (std::size_t n = 1024; n <= maxLength; n *= 4)
+    {
+        CSVector<double> x(n, 1.), y(n, 2.), z(n, 3.);
+
+        const std::vector<Kernel> kernels = {
+            {"scale",   16, [&]() { x = 2. * y; }},
+            {"axpy",    24, [&]() { x += 2. * y; }},
+            {"triad",   32, [&]() { x = y + 3. * z; }},
+            {"dot",     16, [&]() { sink = dot(y, z); }},
+            {"twoNorm",  8, [&]() { sink = norm(y); }},
+            {"supNorm",  8, [&]() { sink = supNorm(y); }},
+            {"max",      8, [&]() { sink = max(y); }},
+        };
+
+        for (const Kernel& kernel : kernels)
+        {
+            const Measurement m   = measure(counters, kernel.run, repetitions);
+            const Perf::Sample& s = m.counts;
+
+            const double bytes     = double(kernel.bytes * n);
+            const double bandwidth = bytes / m.seconds;
+
+            std::cout << std::left << std::setw(10) << kernel.name << std::right
+                      << std::setw(12) << n << std::setw(12) << m.seconds * 1e9 / double(n);
+
+            print(s, Perf::Cycles, double(n), 12);
+            print(s, Perf::Instructions, double(n), 12);
+
+            std::cout << std::setw(8);
+            if (s.valid[Perf::Cycles] && s.valid[Perf::Instructions])
+                std::cout << s.ratio(Perf::Instructions, Perf::Cycles);
+            else
+                std::cout << "-";
+
+            print(s, Perf::L1Misses, double(n), 12);
+            print(s, Perf::LLCMisses, double(n), 12);
+
+            // over the cycles of all threads
+            std::cout << std::setw(12);
+            if (s.valid[Perf::Cycles] && s.value[Perf::Cycles])
+                std::cout << bytes / double(s.value[Perf::Cycles]);
+            else
+                std::cout << "-";
+
+            std::cout << std::setw(10) << bandwidth * 1e-9
+                      << std::setw(10) << 100. * bandwidth / peak;
+
+            print(s, Perf::DramBytes, double(n), 12);
+            std::cout << std::endl;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
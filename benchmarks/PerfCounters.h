@@ -0,0 +1,287 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  File Name:  PerfCounters.h                                                //
+//                                                                            //
+//     Author:  Andreas Buttenschoen <andreas@buttenschoen.ca>                //
+//    Created:  2026-10-19 02:31:40                                           //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CS_PERF_COUNTERS_H
+#define CS_PERF_COUNTERS_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <omp.h>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <dirent.h>
+#endif
+
+//
+// Hardware performance counters read through Linux perf_event_open.
+//
+// The core events (cycles, instructions, L1 data and last level cache
+// misses) are counted per thread: every thread of the OpenMP team opens its
+// own counters, and the reads sum them. The OpenMP runtime keeps its threads,
+// so the counters follow the kernels as long as the team isn't larger than
+// the one the counters were opened with.
+//
+// The memory controller (uncore_imc) read and write CAS counts give the
+// bytes moved to and from DRAM. They are system wide, and need
+// perf_event_paranoid <= 0 or CAP_PERFMON.
+//
+// An event which can't be opened, e.g. without a PMU in a virtual machine
+// or when the counters aren't permitted, is reported as unavailable and the
+// others are still counted.
+//
+namespace Perf {
+
+enum Counter { Cycles, Instructions, L1Misses, LLCMisses, DramBytes, NoCounters };
+
+inline const char * counter_name(int c)
+{
+    static const char * names[NoCounters] = {"cycles", "instructions", "L1D misses", "LLC misses", "DRAM bytes"};
+    return names[c];
+}
+
+struct Sample
+{
+    std::uint64_t value[NoCounters] = {0};
+    bool valid[NoCounters]          = {false};
+
+    double ratio(int a, int b) const
+    {
+        return (valid[a] && valid[b] && value[b]) ? double(value[a]) / double(value[b]) : 0.;
+    }
+};
+
+#if defined(__linux__)
+
+inline int perf_event_open(perf_event_attr& attr, pid_t pid, int cpu)
+{
+    return int(syscall(__NR_perf_event_open, &attr, pid, cpu, -1, 0));
+}
+
+// an open counter and the scale of its counts
+struct Event
+{
+    int    fd;
+    double scale;
+};
+
+// The type and config of an event of a dynamic PMU, parsed from sysfs e.g.
+// /sys/bus/event_source/devices/uncore_imc_0/events/cas_count_read holds
+// "event=0x04,umask=0x03".
+inline bool sysfs_event(const std::string& pmu, const std::string& name,
+                        std::uint32_t& type, std::uint64_t& config, double& scale)
+{
+    const std::string dir = "/sys/bus/event_source/devices/" + pmu;
+
+    std::ifstream typefile(dir + "/type");
+    std::ifstream eventfile(dir + "/events/" + name);
+    if (!(typefile >> type) || !eventfile)
+        return false;
+
+    std::string terms;
+    std::getline(eventfile, terms);
+
+    // the bit ranges of event and umask are fixed on the Intel uncore
+    config = 0;
+    std::istringstream in(terms);
+    std::string term;
+    while (std::getline(in, term, ','))
+    {
+        const std::size_t eq = term.find('=');
+        if (eq == std::string::npos)
+            continue;
+
+        const std::uint64_t value = std::stoull(term.substr(eq + 1), nullptr, 0);
+        if (term.compare(0, eq, "event") == 0)
+            config |= value;
+        else if (term.compare(0, eq, "umask") == 0)
+            config |= value << 8;
+    }
+
+    // one count is a 64 byte line, the scale file gives it in MiB
+    scale = 64.;
+    std::ifstream scalefile(dir + "/events/" + name + ".scale");
+    double mib;
+    if (scalefile >> mib)
+        scale = mib * 1024. * 1024.;
+
+    return true;
+}
+
+class Counters
+{
+public:
+    // opens the counters for a team of threads
+    explicit Counters(int threads = omp_get_max_threads())
+        : events(NoCounters)
+    {
+        const std::uint64_t l1 = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                               | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+        const std::uint32_t types[4]   = {PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE};
+        const std::uint64_t configs[4] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, l1, PERF_COUNT_HW_CACHE_MISSES};
+
+        std::vector<std::vector<Event> > opened(threads);
+
+        #pragma omp parallel num_threads(threads)
+        {
+            std::vector<Event>& mine = opened[omp_get_thread_num()];
+            for (int c = 0; c < 4; ++c)
+                mine.push_back(Event{open(types[c], configs[c], 0, -1), 1.});
+        }
+
+        for (int c = 0; c < 4; ++c)
+            for (int t = 0; t < threads; ++t)
+                if (opened[t][c].fd >= 0)
+                    events[c].push_back(opened[t][c]);
+                else
+                    available[c] = false;
+
+        open_uncore();
+    }
+
+    ~Counters()
+    {
+        for (auto& counter : events)
+            for (auto& e : counter)
+                close(e.fd);
+    }
+
+    Counters(const Counters&) = delete;
+    Counters& operator=(const Counters&) = delete;
+
+    Sample read() const
+    {
+        Sample s;
+        for (int c = 0; c < NoCounters; ++c)
+        {
+            s.valid[c] = available[c] && !events[c].empty();
+            if (!s.valid[c])
+                continue;
+
+            double total = 0;
+            for (const Event& e : events[c])
+            {
+                // value, time enabled, time running: scale for multiplexing
+                std::uint64_t v[3] = {0, 0, 0};
+                if (::read(e.fd, v, sizeof(v)) != sizeof(v))
+                {
+                    s.valid[c] = false;
+                    break;
+                }
+
+                total += e.scale * double(v[0]) * ((v[2] && v[2] < v[1]) ? double(v[1]) / double(v[2]) : 1.);
+            }
+
+            s.value[c] = std::uint64_t(total);
+        }
+
+        return s;
+    }
+
+    bool has(int c) const { return available[c] && !events[c].empty(); }
+
+private:
+    std::vector<std::vector<Event> > events;
+    bool available[NoCounters] = {true, true, true, true, true};
+
+    static int open(std::uint32_t type, std::uint64_t config, pid_t pid, int cpu)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size           = sizeof(attr);
+        attr.type           = type;
+        attr.config         = config;
+        attr.exclude_kernel = (pid >= 0);
+        attr.exclude_hv     = 1;
+        attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        return perf_event_open(attr, pid, cpu);
+    }
+
+    // one pair of CAS counters per memory controller, each read on one cpu
+    void open_uncore()
+    {
+        DIR * dir = opendir("/sys/bus/event_source/devices");
+        if (dir)
+        {
+            while (dirent * entry = readdir(dir))
+            {
+                const std::string pmu = entry->d_name;
+                if (pmu.compare(0, 11, "uncore_imc_") != 0)
+                    continue;
+
+                for (const char * name : {"cas_count_read", "cas_count_write"})
+                {
+                    std::uint32_t type;
+                    std::uint64_t config;
+                    double scale;
+                    if (!sysfs_event(pmu, name, type, config, scale))
+                        continue;
+
+                    const int fd = open(type, config, -1, first_cpu(pmu));
+                    if (fd >= 0)
+                        events[DramBytes].push_back(Event{fd, scale});
+                }
+            }
+
+            closedir(dir);
+        }
+
+        available[DramBytes] = !events[DramBytes].empty();
+    }
+
+    // the first cpu of the cpumask of a PMU
+    static int first_cpu(const std::string& pmu)
+    {
+        std::ifstream in("/sys/bus/event_source/devices/" + pmu + "/cpumask");
+        int cpu = 0;
+        in >> cpu;
+        return cpu;
+    }
+};
+
+#else
+
+class Counters
+{
+public:
+    explicit Counters(int = 0) {}
+    Sample read() const { return Sample(); }
+    bool has(int) const { return false; }
+};
+
+#endif
+
+// the counts between two samples
+inline Sample operator-(const Sample& b, const Sample& a)
+{
+    Sample d;
+    for (int c = 0; c < NoCounters; ++c)
+    {
+        d.valid[c] = a.valid[c] && b.valid[c];
+        d.value[c] = d.valid[c] ? b.value[c] - a.value[c] : 0;
+    }
+
+    return d;
+}
+
+} // end namespace
+
+#endif
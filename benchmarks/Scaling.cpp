@@ -0,0 +1,251 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  File Name:  Scaling.cpp                                                   //
+//                                                                            //
+//     Author:  Andreas Buttenschoen <andreas@buttenschoen.ca>                //
+//    Created:  2026-10-19 03:40:26                                           //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Thread scaling of the main expression shapes:
+//
+//      Scaling [max threads] [max vector length] [weak length per thread]
+//
+// The kernels are axpy, the triad, x = p * r + a * x, exp, dot and the one,
+// two and sup norms. Every run is repeated for each OpenMP binding in
+// Bindings below. As the binding can only be set before the OpenMP runtime
+// starts, the driver runs itself once per binding with OMP_PROC_BIND and
+// OMP_PLACES set.
+//
+// The strong scaling table keeps the vector length fixed and reports the
+// speedup and parallel efficiency over one thread. The weak scaling table
+// grows the length with the threads, and its efficiency is the ratio of the
+// one thread time to the p thread time. The rows are flagged:
+//
+//      fork/join   the empty parallel region takes over a quarter of the time
+//      bandwidth   out of cache, the kernel moves over 80% of the STREAM
+//                  triad bandwidth
+//      chunks      the reductions use the chunks of the tuning profile (see
+//                  VectorReduction.h), so more threads don't help
+//      serial      the packet kernels of CSVector (dot, supNorm) run on the
+//                  calling thread
+//
+// The assignments use the thread count of the tuning profile, which is set
+// for each run.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <omp.h>
+
+#include "DynamicVector.h"
+#include "Timing.h"
+
+namespace {
+
+// OMP_PROC_BIND and OMP_PLACES of the runs
+const std::vector<std::pair<std::string, std::string> > Bindings = {
+    {"false",  ""},
+    {"close",  "cores"},
+    {"spread", "cores"},
+};
+
+volatile double sink;
+
+// the cost of an empty parallel region with the given threads
+double fork_join(int threads)
+{
+    return Timing::timeit([threads]()
+    {
+        #pragma omp parallel num_threads(threads)
+        {
+            sink = 0;
+        }
+    }, 100);
+}
+
+struct Vectors
+{
+    explicit Vectors(std::size_t n)
+        : x(n, 1.), y(n, 2.), z(n, 3.), p(n, 0.5), r(n, 0.25)
+    {}
+
+    CSVector<double> x, y, z, p, r;
+};
+
+struct Kernel
+{
+    std::string name;
+
+    // bytes read and written per element
+    std::size_t bytes;
+
+    enum Parallelism { Assignment, Chunked, Serial } parallelism;
+
+    std::function<void(Vectors&)> run;
+};
+
+const std::vector<Kernel> Kernels = {
+    {"axpy",    24, Kernel::Assignment, [](Vectors& v) { v.x += 2. * v.y; }},
+    {"triad",   32, Kernel::Assignment, [](Vectors& v) { v.x = v.y + 3. * v.z; }},
+    {"pr+ax",   32, Kernel::Assignment, [](Vectors& v) { v.x = v.p * v.r + 0.5 * v.x; }},
+    {"exp",     24, Kernel::Assignment, [](Vectors& v) { v.x = exp(v.r); }},
+    {"dot",     16, Kernel::Serial,     [](Vectors& v) { sink = dot(v.y, v.z); }},
+    {"oneNorm",  8, Kernel::Chunked,    [](Vectors& v) { sink = oneNorm(v.y); }},
+    {"twoNorm",  8, Kernel::Chunked,    [](Vectors& v) { sink = Norm2(v.y); }},
+    {"supNorm",  8, Kernel::Serial,     [](Vectors& v) { sink = supNorm(v.y); }},
+};
+
+double run(const Kernel& kernel, Vectors& v, int threads)
+{
+    Tuning::profile().threads = std::size_t(threads);
+    return Timing::timeit([&]() { kernel.run(v); });
+}
+
+std::string flags(const Kernel& kernel, std::size_t n, double time, double overhead,
+                  double peak, int threads)
+{
+    const bool forks = (kernel.parallelism == Kernel::Assignment)
+                    || (kernel.parallelism == Kernel::Chunked && n >= ReductionParallelThreshold);
+
+    std::string f;
+    if (forks && overhead > 0.25 * time)
+        f += " fork/join";
+    // only out of cache, the threshold of the streaming stores is about the LLC
+    if (kernel.bytes * n >= Tuning::profile().streamingThreshold && double(kernel.bytes * n) / time > 0.8 * peak)
+        f += " bandwidth";
+    if (kernel.parallelism == Kernel::Chunked && std::size_t(threads) > Tuning::chunks())
+        f += " chunks";
+    if (kernel.parallelism == Kernel::Serial && threads > 1)
+        f += " serial";
+
+    return f;
+}
+
+void header(const char * title)
+{
+    std::cout << "\n" << title << "\n"
+              << std::left << std::setw(10) << "kernel" << std::right
+              << std::setw(12) << "n" << std::setw(9) << "threads"
+              << std::setw(14) << "time [us]" << std::setw(10) << "GB/s"
+              << std::setw(10) << "speedup" << std::setw(12) << "efficiency"
+              << "  flags" << std::endl;
+}
+
+void row(const Kernel& kernel, std::size_t n, int threads, double time,
+         double speedup, double efficiency, const std::string& flags)
+{
+    std::cout << std::left << std::setw(10) << kernel.name << std::right
+              << std::setw(12) << n << std::setw(9) << threads
+              << std::setw(14) << time * 1e6
+              << std::setw(10) << double(kernel.bytes * n) / time * 1e-9
+              << std::setw(10) << speedup << std::setw(12) << efficiency
+              << " " << flags << std::endl;
+}
+
+int child(int maxThreads, std::size_t maxLength, std::size_t weakLength)
+{
+    std::vector<int> threads;
+    for (int t = 1; t < maxThreads; t *= 2)
+        threads.push_back(t);
+    threads.push_back(maxThreads);
+
+    std::vector<double> overhead;
+    double peak = 0;
+    for (int t : threads)
+    {
+        overhead.push_back(fork_join(t));
+        peak = std::max(peak, Timing::stream_peak(maxLength, t));
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "# STREAM triad peak " << peak * 1e-9 << " GB/s, " << omp_get_num_places() << " places" << std::endl;
+    for (std::size_t i = 0; i < threads.size(); ++i)
+        std::cout << "# fork/join with " << threads[i] << " threads: " << overhead[i] * 1e6 << " us" << std::endl;
+
+    header("strong scaling");
+    for (std::size_t n = 1024; n <= maxLength; n *= 16)
+    {
+        Vectors v(n);
+        for (const Kernel& kernel : Kernels)
+        {
+            double serial = 0;
+            for (std::size_t i = 0; i < threads.size(); ++i)
+            {
+                const double t = run(kernel, v, threads[i]);
+                if (i == 0)
+                    serial = t;
+
+                const double speedup = serial / t;
+                row(kernel, n, threads[i], t, speedup, speedup / threads[i],
+                    flags(kernel, n, t, overhead[i], peak, threads[i]));
+            }
+        }
+    }
+
+    header("weak scaling");
+    for (const Kernel& kernel : Kernels)
+    {
+        double serial = 0;
+        for (std::size_t i = 0; i < threads.size(); ++i)
+        {
+            const std::size_t n = weakLength * std::size_t(threads[i]);
+            Vectors v(n);
+
+            const double t = run(kernel, v, threads[i]);
+            if (i == 0)
+                serial = t;
+
+            row(kernel, n, threads[i], t, serial * threads[i] / t, serial / t,
+                flags(kernel, n, t, overhead[i], peak, threads[i]));
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+} // end namespace
+
+int main(int argc, char * argv[])
+{
+    if (argc > 1 && std::string(argv[1]) == "--child")
+        return child(std::atoi(argv[2]), std::strtoul(argv[3], nullptr, 10), std::strtoul(argv[4], nullptr, 10));
+
+    const int maxThreads         = (argc > 1) ? std::atoi(argv[1]) : omp_get_num_procs();
+    const std::size_t maxLength  = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : (1ul << 24);
+    const std::size_t weakLength = (argc > 3) ? std::strtoul(argv[3], nullptr, 10) : (1ul << 18);
+
+    int status = EXIT_SUCCESS;
+    for (const auto& binding : Bindings)
+    {
+        std::cout << "\n# OMP_PROC_BIND=" << binding.first;
+        std::string command = "OMP_PROC_BIND=" + binding.first;
+        if (!binding.second.empty())
+        {
+            std::cout << " OMP_PLACES=" << binding.second;
+            command += " OMP_PLACES=" + binding.second;
+        }
+        std::cout << std::endl;
+
+        command += " \"" + std::string(argv[0]) + "\" --child " + std::to_string(maxThreads)
+                 + " " + std::to_string(maxLength) + " " + std::to_string(weakLength);
+
+        if (std::system(command.c_str()) != 0)
+        {
+            std::cerr << "The run with OMP_PROC_BIND=" << binding.first << " failed!" << std::endl;
+            status = EXIT_FAILURE;
+        }
+    }
+
+    return status;
+}
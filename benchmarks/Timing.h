@@ -0,0 +1,66 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  File Name:  Timing.h                                                      //
+//                                                                            //
+//     Author:  Andreas Buttenschoen <andreas@buttenschoen.ca>                //
+//    Created:  2026-10-19 10:31:05                                           //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CS_TIMING_H
+#define CS_TIMING_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <limits>
+
+#include "DynamicVector.h"
+
+//
+// The timers shared by the benchmark drivers
+//
+namespace Timing {
+
+// the best of the repetitions in seconds, after one run to warm up the
+// caches and the threads
+template <typename Function>
+double timeit(Function f, int repetitions = 5)
+{
+    f();
+
+    double best = std::numeric_limits<double>::max();
+    for (int r = 0; r < repetitions; ++r)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        f();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+
+    return best;
+}
+
+// The bandwidth of the STREAM triad a = b + s * c in bytes per second, on
+// vectors of n elements
+inline double stream_peak(std::size_t n, int threads)
+{
+    CSVector<double> a(n), b(n, 1.), c(n, 2.);
+    double * pa = a.data();
+    const double * pb = b.data();
+    const double * pc = c.data();
+
+    const double t = timeit([&]()
+    {
+        #pragma omp parallel for num_threads(threads)
+        for (std::size_t i = 0; i < n; ++i)
+            pa[i] = pb[i] + 3. * pc[i];
+    }, 10);
+
+    // the write of a also reads it into cache
+    return 4. * double(n * sizeof(double)) / t;
+}
+
+} // end namespace
+
+#endif
@@ -12,6 +12,7 @@
 #define CONCEPTS_H_VERSION 0.1
 
 #include <type_traits>
+#include <complex>
 
 template<bool B, typename T = void>
 using Enable_if = typename std::enable_if<B, T>::type;
@@ -77,6 +78,20 @@ constexpr bool Arithmetic()
     return std::is_arithmetic<T>::value;
 }
 
+template<typename T>
+struct is_complex : std::false_type
+{};
+
+template<typename T>
+struct is_complex<std::complex<T> > : std::true_type
+{};
+
+template<typename T>
+constexpr bool Complex()
+{
+    return is_complex<T>::value;
+}
+
 template<typename T>
 constexpr bool Pointer()
 {
@@ -0,0 +1,434 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  File Name:  DynamicBoolVector.h                                           //
+//                                                                            //
+//     Author:  Andreas Buttenschoen <andreas@buttenschoen.ca>                //
+//    Created:  2026-10-18 16:41:07                                           //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CS_BOOL_VECTOR_CONTAINER_H
+#define CS_BOOL_VECTOR_CONTAINER_H
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include "DynamicVector.h"
+
+//
+// Bit-packed dynamic mask vector. Element i is bit i % 64 of word i / 64. The
+// number of words is padded to a whole number of packets, and all bits past
+// size() are kept zero, so that the word-wise operations and the popcount
+// need no special treatment of the last word.
+//
+// A CSVector<bool> is the result of evaluating a comparison expression
+//
+//      CSVector<bool> mask = (x > 0);
+//      CSVector<bool> small = (abs(r) < tol);
+//
+// and it can be used as the condition in select(mask, a, b).
+//
+template <>
+class CSVector<bool> : public VectorExpression<CSVector<bool> >
+{
+public:
+    using value_type = bool;
+    using size_type  = std::size_t;
+    using word_type  = uint64_t;
+
+    static constexpr size_type WordBits   = 8 * sizeof(word_type);
+    static constexpr size_type VectorSize = __alignment / sizeof(word_type);
+
+    typedef word_type WordPacket __attribute__((vector_size (sizeof(word_type) * VectorSize)));
+
+    // Creates a vector with all elements set to value
+    CSVector(const size_t size = 0, const bool value = false)
+        : mDataSize(size),
+          mWordSize(words_for(size)),
+          mpWords(nullptr)
+    {
+        allocate();
+        fill(value);
+    }
+
+    CSVector(const CSVector& other)
+        : mDataSize(other.mDataSize),
+          mWordSize(other.mWordSize),
+          mpWords(nullptr)
+    {
+        allocate();
+        if (mpWords)
+            memcpy(mpWords, other.mpWords, mWordSize * sizeof(word_type));
+    }
+
+    CSVector(CSVector&& other)
+        : mDataSize(other.mDataSize),
+          mWordSize(other.mWordSize),
+          mpWords(other.mpWords)
+    {
+        other.mpWords   = nullptr;
+        other.mDataSize = 0;
+        other.mWordSize = 0;
+    }
+
+    // Evaluates a boolean vector expression e.g. x > y
+    template <class E, typename = Enable_if<Same<typename E::value_type, bool>() && Different<E, CSVector<bool> >()> >
+    CSVector(const VectorExpression<E>& that)
+        : mDataSize(Expression::size(static_cast<const E&>(that))),
+          mWordSize(words_for(mDataSize)),
+          mpWords(nullptr)
+    {
+        allocate();
+        evaluate(static_cast<const E&>(that));
+    }
+
+    CSVector& operator=(const CSVector& other)
+    {
+        if (this == &other)
+            return *this;
+
+        if (mWordSize != other.mWordSize)
+        {
+            aligned_free(mpWords);
+            mWordSize = other.mWordSize;
+            allocate();
+        }
+
+        mDataSize = other.mDataSize;
+        if (mpWords)
+            memcpy(mpWords, other.mpWords, mWordSize * sizeof(word_type));
+
+        return *this;
+    }
+
+    CSVector& operator=(CSVector&& other)
+    {
+        swap(other);
+        return *this;
+    }
+
+    template <class E, typename = Enable_if<Same<typename E::value_type, bool>() && Different<E, CSVector<bool> >()> >
+    CSVector& operator=(const VectorExpression<E>& that)
+    {
+        const E& e = static_cast<const E&>(that);
+        if (mDataSize != Expression::size(e))
+            throw std::runtime_error("Incompatible vector lengths " + std::to_string(mDataSize)
+                                     + " " + std::to_string(Expression::size(e)) + "(mask) !");
+
+        evaluate(e);
+        return *this;
+    }
+
+    ~CSVector()
+    {
+        aligned_free(mpWords);
+    }
+
+    size_t size() const { return mDataSize; }
+    size_t words() const { return mWordSize; }
+
+    word_type * data() { return mpWords; }
+    const word_type * data() const { return mpWords; }
+
+    bool operator()(size_t index) const
+    {
+        return (mpWords[index / WordBits] >> (index % WordBits)) & word_type(1);
+    }
+
+    bool operator[](size_t index) const
+    {
+        return (*this)(index);
+    }
+
+    bool test(size_t index) const
+    {
+        if (index >= mDataSize)
+            throw std::out_of_range("Index " + std::to_string(index) + " larger than " + std::to_string(mDataSize));
+
+        return (*this)(index);
+    }
+
+    void set(size_t index, bool value = true)
+    {
+        word_type bit = word_type(1) << (index % WordBits);
+        word_type& w  = mpWords[index / WordBits];
+        w = value ? (w | bit) : (w & ~bit);
+    }
+
+    void reset(size_t index) { set(index, false); }
+
+    void fill(bool value);
+    void setZero() { fill(false); }
+
+    void swap(CSVector& other)
+    {
+        using std::swap;
+        swap(mDataSize, other.mDataSize);
+        swap(mWordSize, other.mWordSize);
+        swap(mpWords,   other.mpWords);
+    }
+
+    // the number of true elements
+    size_t count() const;
+
+    // these return as soon as the answer is known
+    bool any() const;
+    bool all() const;
+    bool none() const { return !any(); }
+
+    CSVector operator~() const;
+
+    CSVector& operator&=(const CSVector& other);
+    CSVector& operator|=(const CSVector& other);
+    CSVector& operator^=(const CSVector& other);
+
+private:
+    static size_t words_for(size_t size)
+    {
+        size_t words = (size + WordBits - 1) / WordBits;
+        return (words + VectorSize - 1) / VectorSize * VectorSize;
+    }
+
+    // the valid bits of the last word containing elements
+    word_type tail_mask() const
+    {
+        size_t bits = mDataSize % WordBits;
+        return bits ? (word_type(1) << bits) - 1 : ~word_type(0);
+    }
+
+    void allocate()
+    {
+        mpWords = (word_type *)Memory::aligned_alloc(__alignment, mWordSize * sizeof(word_type));
+    }
+
+    // zero all bits past size()
+    void clear_tail()
+    {
+        size_t used = (mDataSize + WordBits - 1) / WordBits;
+        if (used > 0)
+            mpWords[used - 1] &= tail_mask();
+
+        for (size_t i = used; i < mWordSize; i++)
+            mpWords[i] = 0;
+    }
+
+    template <typename E>
+    void evaluate(const E& e);
+
+    template <typename Functor>
+    void apply(const CSVector& other, Functor f);
+
+    size_t mDataSize;
+    size_t mWordSize;
+
+    word_type * mpWords;
+};
+
+inline typename CSVector<bool>::size_type
+size(const CSVector<bool>& vector)
+{
+    return vector.size();
+}
+
+//
+// Each word is assembled from 64 comparisons. The inner loop is a SIMD
+// reduction, for concrete vectors gcc turns it into packed compares followed
+// by a variable shift and an or-reduction.
+//
+template <typename E>
+inline void CSVector<bool>::evaluate(const E& e)
+{
+    const size_t N = mDataSize;
+    const size_t FULL_WORDS = N / WordBits;
+    const size_t Threads = Tuning::profile().threads;
+
+    #pragma omp parallel for num_threads(Threads)
+    for (size_t w = 0; w < FULL_WORDS; ++w)
+    {
+        word_type bits = 0;
+        const size_t offset = w * WordBits;
+
+        #pragma omp simd reduction(|:bits)
+        for (size_t b = 0; b < WordBits; ++b)
+            bits |= word_type(bool(e(offset + b))) << b;
+
+        mpWords[w] = bits;
+    }
+
+    // deal with left overs
+    if (FULL_WORDS * WordBits < N)
+    {
+        word_type bits = 0;
+        for (size_t i = FULL_WORDS * WordBits; i < N; ++i)
+            bits |= word_type(bool(e(i))) << (i % WordBits);
+
+        mpWords[FULL_WORDS] = bits;
+    }
+
+    for (size_t i = (N + WordBits - 1) / WordBits; i < mWordSize; i++)
+        mpWords[i] = 0;
+}
+
+inline void CSVector<bool>::fill(bool value)
+{
+    if (mpWords)
+        memset(mpWords, value ? 0xFF : 0, mWordSize * sizeof(word_type));
+
+    clear_tail();
+}
+
+template <typename Functor>
+inline void CSVector<bool>::apply(const CSVector<bool>& other, Functor f)
+{
+    if (mDataSize != other.mDataSize)
+        throw std::runtime_error("Incompatible vector lengths " + std::to_string(mDataSize)
+                                 + " " + std::to_string(other.mDataSize) + "(mask) !");
+
+    WordPacket * Av = (WordPacket *) mpWords;
+    const WordPacket * Bv = (const WordPacket *) other.mpWords;
+
+    const size_t NO_LOOPS = mWordSize / VectorSize;
+    for (size_t i = 0; i < NO_LOOPS; ++i)
+        Av[i] = f(Av[i], Bv[i]);
+}
+
+inline CSVector<bool>& CSVector<bool>::operator&=(const CSVector<bool>& other)
+{
+    apply(other, [](const WordPacket& a, const WordPacket& b) { return a & b; });
+    return *this;
+}
+
+inline CSVector<bool>& CSVector<bool>::operator|=(const CSVector<bool>& other)
+{
+    apply(other, [](const WordPacket& a, const WordPacket& b) { return a | b; });
+    return *this;
+}
+
+inline CSVector<bool>& CSVector<bool>::operator^=(const CSVector<bool>& other)
+{
+    apply(other, [](const WordPacket& a, const WordPacket& b) { return a ^ b; });
+    return *this;
+}
+
+inline CSVector<bool> CSVector<bool>::operator~() const
+{
+    CSVector<bool> ret(*this);
+
+    WordPacket * Av = (WordPacket *) ret.mpWords;
+    const size_t NO_LOOPS = mWordSize / VectorSize;
+    for (size_t i = 0; i < NO_LOOPS; ++i)
+        Av[i] = ~Av[i];
+
+    ret.clear_tail();
+    return ret;
+}
+
+inline size_t CSVector<bool>::count() const
+{
+    size_t ret = 0;
+    const size_t W = mWordSize;
+    const size_t Threads = Tuning::profile().threads;
+
+    // the bits past size() are zero, so we can count all words
+    #pragma omp parallel for simd num_threads(Threads) reduction(+:ret)
+    for (size_t i = 0; i < W; ++i)
+        ret += size_t(__builtin_popcountll(mpWords[i]));
+
+    return ret;
+}
+
+//
+// any and all check a block of packets at a time, so that the early exit
+// costs one branch per block.
+//
+inline bool CSVector<bool>::any() const
+{
+    constexpr size_t BLOCK = 8;
+
+    const WordPacket * Av = (const WordPacket *) mpWords;
+    const size_t NO_LOOPS = mWordSize / VectorSize;
+
+    for (size_t i = 0; i < NO_LOOPS; i += BLOCK)
+    {
+        WordPacket acc = {0};
+        const size_t end = std::min(NO_LOOPS, i + BLOCK);
+        for (size_t j = i; j < end; ++j)
+            acc |= Av[j];
+
+        for (size_t k = 0; k < VectorSize; ++k)
+            if (acc[k])
+                return true;
+    }
+
+    return false;
+}
+
+inline bool CSVector<bool>::all() const
+{
+    constexpr size_t BLOCK = 8;
+    const size_t FULL_WORDS = mDataSize / WordBits;
+
+    // full packets
+    const WordPacket * Av = (const WordPacket *) mpWords;
+    const size_t NO_LOOPS = FULL_WORDS / VectorSize;
+
+    for (size_t i = 0; i < NO_LOOPS; i += BLOCK)
+    {
+        WordPacket acc = ~WordPacket{0};
+        const size_t end = std::min(NO_LOOPS, i + BLOCK);
+        for (size_t j = i; j < end; ++j)
+            acc &= Av[j];
+
+        for (size_t k = 0; k < VectorSize; ++k)
+            if (~acc[k])
+                return false;
+    }
+
+    // deal with left overs
+    for (size_t i = NO_LOOPS * VectorSize; i < FULL_WORDS; ++i)
+        if (~mpWords[i])
+            return false;
+
+    if (FULL_WORDS * WordBits < mDataSize)
+        return mpWords[FULL_WORDS] == tail_mask();
+
+    return true;
+}
+
+inline CSVector<bool> operator&(const CSVector<bool>& lhs, const CSVector<bool>& rhs)
+{
+    CSVector<bool> ret(lhs);
+    ret &= rhs;
+    return ret;
+}
+
+inline CSVector<bool> operator|(const CSVector<bool>& lhs, const CSVector<bool>& rhs)
+{
+    CSVector<bool> ret(lhs);
+    ret |= rhs;
+    return ret;
+}
+
+inline CSVector<bool> operator^(const CSVector<bool>& lhs, const CSVector<bool>& rhs)
+{
+    CSVector<bool> ret(lhs);
+    ret ^= rhs;
+    return ret;
+}
+
+inline std::ostream& operator<<(std::ostream& os, const CSVector<bool>& vector)
+{
+    size_t N = vector.size();
+    os << "[";
+    for (size_t i = 0; i < N; i++)
+    {
+        os << vector[i];
+        if (i != (N-1)) os << " ";
+    }
+    os << "]";
+
+    return os;
+}
+
+#endif
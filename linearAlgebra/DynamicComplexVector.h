@@ -0,0 +1,562 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  File Name:  DynamicComplexVector.h                                        //
+//                                                                            //
+//     Author:  Andreas Buttenschoen <andreas@buttenschoen.ca>                //
+//    Created:  2026-10-18 14:03:52                                           //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CS_COMPLEX_VECTOR_CONTAINER_H
+#define CS_COMPLEX_VECTOR_CONTAINER_H
+
+#include <complex>
+#include <cstdint>
+#include <type_traits>
+
+#include "DynamicVector.h"
+
+//
+// Kernels for CSVector<std::complex<T>>. The elements are stored interleaved
+// i.e. re0 im0 re1 im1 ..., so that a packet of 2K reals holds K complex
+// numbers. All kernels work on packets of the real type; the real and the
+// imaginary parts are exchanged within a packet using __builtin_shuffle.
+//
+// For bandwidth bound loops CSSplitComplexVector stores the real and the
+// imaginary parts in two separate CSVector<T>, the kernels on these are plain
+// real packet loops.
+//
+namespace impl {
+
+// integer type of the same width as T, used for the shuffle masks
+template <class T>
+using mask_type = std::conditional_t<sizeof(T) == 8, int64_t, int32_t>;
+
+//
+// Hermitian dot product sum conj(a_k) b_k on interleaved data. With
+//
+//      A = [ar ai], B = [br bi], Bs = [bi br]
+//
+// we accumulate A * B = [ar br, ai bi] whose sum is the real part, and
+// A * Bs = [ar bi, ai br] whose even minus odd lanes is the imaginary part.
+//
+template <class Result, class T>
+std::complex<Result> complex_dot(const std::complex<T> * __restrict__ a,
+                                 const std::complex<T> * __restrict__ b, size_t N)
+{
+    constexpr size_t VECTOR_SIZE = __alignment / sizeof(Result);
+    static_assert(VECTOR_SIZE % 2 == 0, "A packet must hold whole complex numbers!");
+
+    // number of complex elements in a packet
+    constexpr size_t COMPLEX_SIZE = VECTOR_SIZE / 2;
+    constexpr size_t CHUNK_SIZE   = PREFETCH_LENGTH * COMPLEX_SIZE;
+
+    size_t REMAINDER_LOOP_START = 0;
+    Result re = {0}, im = {0};
+
+    if (likely(N >= CHUNK_SIZE))
+    {
+        using M = mask_type<Result>;
+        typedef T lvec __attribute__((vector_size (sizeof(T) * VECTOR_SIZE)));
+        typedef Result vec __attribute__((vector_size (sizeof(Result) * VECTOR_SIZE)));
+        typedef M mvec __attribute__((vector_size (sizeof(M) * VECTOR_SIZE)));
+
+        mvec swap;
+        for (size_t i = 0; i < VECTOR_SIZE; i++)
+            swap[i] = M(i ^ 1);
+
+        vec real1 = {0}, real2 = {0}, imag1 = {0}, imag2 = {0};
+
+        const lvec * Av = (const lvec *) a;
+        const lvec * Bv = (const lvec *) b;
+
+        size_t NO_LOOPS = N / CHUNK_SIZE;
+        const size_t prefetch = Tuning::profile().prefetchDistance;
+        for (size_t i = 0; i < NO_LOOPS; ++i)
+        {
+            __builtin_prefetch(Av + prefetch, 0, 0);
+            __builtin_prefetch(Bv + prefetch, 0, 0);
+
+            vec A = __builtin_convertvector(*Av, vec);
+            vec B = __builtin_convertvector(*Bv, vec);
+            real1 += A * B;
+            imag1 += A * __builtin_shuffle(B, swap);
+            Av++;
+            Bv++;
+
+            A = __builtin_convertvector(*Av, vec);
+            B = __builtin_convertvector(*Bv, vec);
+            real2 += A * B;
+            imag2 += A * __builtin_shuffle(B, swap);
+            Av++;
+            Bv++;
+        }
+
+        real1 += real2;
+        imag1 += imag2;
+
+        for (size_t i = 0; i < VECTOR_SIZE; i += 2)
+        {
+            re += real1[i] + real1[i + 1];
+            im += imag1[i] - imag1[i + 1];
+        }
+
+        // set remainder to consider last few elements
+        REMAINDER_LOOP_START = NO_LOOPS * CHUNK_SIZE;
+    }
+
+    // deal with left overs
+    for (size_t i = REMAINDER_LOOP_START; i < N; i++)
+    {
+        Result ar = Result(a[i].real()), ai = Result(a[i].imag());
+        Result br = Result(b[i].real()), bi = Result(b[i].imag());
+        re += ar * br + ai * bi;
+        im += ar * bi - ai * br;
+    }
+
+    return std::complex<Result>(re, im);
+}
+
+//
+// Element-wise product c = a * b, or c = conj(a) * b, on interleaved data.
+// With Bre = [br br] and Bim = [bi bi]
+//
+//      a * b = A * Bre + [ai ar] * Bim * [-1 1].
+//
+// c may be the same memory as a or b, as in x = x * y, since each packet of
+// c only depends on the packets of a and b at the same position.
+//
+template <bool Conjugate, class T>
+void complex_multiply(std::complex<T> * c, const std::complex<T> * a,
+                      const std::complex<T> * b, size_t N)
+{
+    constexpr size_t VECTOR_SIZE  = __alignment / sizeof(T);
+    constexpr size_t COMPLEX_SIZE = VECTOR_SIZE / 2;
+    static_assert(VECTOR_SIZE % 2 == 0, "A packet must hold whole complex numbers!");
+
+    using M = mask_type<T>;
+    typedef T vec __attribute__((vector_size (sizeof(T) * VECTOR_SIZE)));
+    typedef M mvec __attribute__((vector_size (sizeof(M) * VECTOR_SIZE)));
+
+    mvec swap, dup_re, dup_im;
+    vec sign, conj;
+    for (size_t i = 0; i < VECTOR_SIZE; i++)
+    {
+        swap[i]   = M(i ^ 1);
+        dup_re[i] = M(i & ~size_t(1));
+        dup_im[i] = M(i | 1);
+        sign[i]   = (i % 2 == 0) ? T(-1) : T(1);
+        conj[i]   = (i % 2 == 0) ? T(1) : T(-1);
+    }
+
+    const vec * Av = (const vec *) a;
+    const vec * Bv = (const vec *) b;
+    vec * Cv = (vec *) c;
+
+    const size_t NO_LOOPS = N / COMPLEX_SIZE;
+    const size_t Threads = Tuning::profile().threads;
+
+    #pragma omp parallel for num_threads(Threads)
+    for (size_t i = 0; i < NO_LOOPS; ++i)
+    {
+        vec A = Av[i];
+        if (Conjugate)
+            A *= conj;
+
+        vec B = Bv[i];
+        Cv[i] = A * __builtin_shuffle(B, dup_re)
+              + __builtin_shuffle(A, swap) * __builtin_shuffle(B, dup_im) * sign;
+    }
+
+    // deal with left overs
+    for (size_t i = NO_LOOPS * COMPLEX_SIZE; i < N; i++)
+    {
+        T ar = a[i].real(), ai = Conjugate ? -a[i].imag() : a[i].imag();
+        T br = b[i].real(), bi = b[i].imag();
+        c[i] = std::complex<T>(ar * br - ai * bi, ar * bi + ai * br);
+    }
+}
+
+// max_k |a_k|^2 on interleaved data
+template <class T>
+T complex_max_abs2(const std::complex<T> * __restrict__ a, size_t N)
+{
+    constexpr size_t VECTOR_SIZE  = __alignment / sizeof(T);
+    constexpr size_t COMPLEX_SIZE = VECTOR_SIZE / 2;
+    constexpr size_t CHUNK_SIZE   = PREFETCH_LENGTH * COMPLEX_SIZE;
+
+    size_t REMAINDER_LOOP_START = 0;
+    T res = {0};
+
+    if (likely(N >= CHUNK_SIZE))
+    {
+        using M = mask_type<T>;
+        typedef T vec __attribute__((vector_size (sizeof(T) * VECTOR_SIZE)));
+        typedef M mvec __attribute__((vector_size (sizeof(M) * VECTOR_SIZE)));
+
+        mvec swap;
+        for (size_t i = 0; i < VECTOR_SIZE; i++)
+            swap[i] = M(i ^ 1);
+
+        vec temp1 = {0}, temp2 = {0}, sq;
+        const vec * Av = (const vec *) a;
+
+        size_t NO_LOOPS = N / CHUNK_SIZE;
+        const size_t prefetch = Tuning::profile().prefetchDistance;
+        for (size_t i = 0; i < NO_LOOPS; ++i)
+        {
+            __builtin_prefetch(Av + prefetch, 0, 0);
+
+            // both lanes of a complex number hold re^2 + im^2
+            sq = (*Av) * (*Av);
+            sq += __builtin_shuffle(sq, swap);
+            temp1 = (sq > temp1) ? sq : temp1;
+            Av++;
+
+            sq = (*Av) * (*Av);
+            sq += __builtin_shuffle(sq, swap);
+            temp2 = (sq > temp2) ? sq : temp2;
+            Av++;
+        }
+
+        temp1 = (temp1 > temp2) ? temp1 : temp2;
+        for (size_t i = 0; i < VECTOR_SIZE; i++)
+            res = (temp1[i] > res) ? temp1[i] : res;
+
+        // set remainder to consider last few elements
+        REMAINDER_LOOP_START = NO_LOOPS * CHUNK_SIZE;
+    }
+
+    // deal with left overs
+    for (size_t i = REMAINDER_LOOP_START; i < N; i++)
+    {
+        T sq = a[i].real() * a[i].real() + a[i].imag() * a[i].imag();
+        res = (sq > res) ? sq : res;
+    }
+
+    return res;
+}
+
+} // end namespace
+
+//
+// Hermitian dot product i.e. sum conj(lhs_k) rhs_k. The accumulator defaults
+// to Accumulate_type<T> as in the real case.
+//
+template <class T, class Result = Accumulate_type<T> >
+std::complex<Result> dot(const CSVector<std::complex<T> >& lhs, const CSVector<std::complex<T> >& rhs)
+{
+    size_t N = lhs.size();
+    if (N != rhs.size())
+        throw std::runtime_error("Incompatible vector lengths " + std::to_string(N)
+                                 + " " + std::to_string(rhs.size()) + "(dot) !");
+
+    return impl::complex_dot<Result>(lhs.data(), rhs.data(), N);
+}
+
+template <class T>
+auto norm(const CSVector<std::complex<T> >& lhs)
+{
+    // the imaginary part of conj(x) x vanishes
+    return std::sqrt(dot(lhs, lhs).real());
+}
+
+// the maximum modulus
+template <class T>
+T supNorm(const CSVector<std::complex<T> >& lhs)
+{
+    size_t N = lhs.size();
+    if (N == 0)
+        throw std::runtime_error("Zero length vector!");
+
+    return std::sqrt(impl::complex_max_abs2(lhs.data(), N));
+}
+
+// result = lhs * rhs element-wise
+template <class T>
+void multiply(CSVector<std::complex<T> >& result, const CSVector<std::complex<T> >& lhs,
+              const CSVector<std::complex<T> >& rhs)
+{
+    size_t N = lhs.size();
+    if (N != rhs.size() || N != result.size())
+        throw std::runtime_error("Incompatible vector lengths " + std::to_string(N)
+                                 + " " + std::to_string(rhs.size()) + "(multiply) !");
+
+    impl::complex_multiply<false>(result.data(), lhs.data(), rhs.data(), N);
+}
+
+// result = conj(lhs) * rhs element-wise
+template <class T>
+void conj_multiply(CSVector<std::complex<T> >& result, const CSVector<std::complex<T> >& lhs,
+                   const CSVector<std::complex<T> >& rhs)
+{
+    size_t N = lhs.size();
+    if (N != rhs.size() || N != result.size())
+        throw std::runtime_error("Incompatible vector lengths " + std::to_string(N)
+                                 + " " + std::to_string(rhs.size()) + "(conj_multiply) !");
+
+    impl::complex_multiply<true>(result.data(), lhs.data(), rhs.data(), N);
+}
+
+//
+// z = x * y and z = conj(x) * y on complex vectors are assigned with the
+// packet kernels of multiply and conj_multiply, instead of element by element.
+//
+namespace Expression {
+
+template <typename T>
+struct VectorAssignment<CSVector<std::complex<T> >,
+                        VectorVectorBinaryExpression<CSVector<std::complex<T> >, CSVector<std::complex<T> >,
+                                                     product<std::complex<T>, std::complex<T> > > >
+{
+    using Vector = CSVector<std::complex<T> >;
+    using Source = VectorVectorBinaryExpression<Vector, Vector, product<std::complex<T>, std::complex<T> > >;
+
+    using type = Vector&;
+    type operator()(Vector& vector, const Source& src)
+    {
+        multiply(vector, src.first_argument(), src.second_argument());
+        return vector;
+    }
+};
+
+template <typename T>
+struct VectorAssignment<CSVector<std::complex<T> >,
+                        VectorVectorBinaryExpression<VectorUnaryExpression<CSVector<std::complex<T> >, Conj<std::complex<T> > >,
+                                                     CSVector<std::complex<T> >,
+                                                     product<std::complex<T>, std::complex<T> > > >
+{
+    using Vector = CSVector<std::complex<T> >;
+    using Source = VectorVectorBinaryExpression<VectorUnaryExpression<Vector, Conj<std::complex<T> > >, Vector,
+                                                product<std::complex<T>, std::complex<T> > >;
+
+    using type = Vector&;
+    type operator()(Vector& vector, const Source& src)
+    {
+        conj_multiply(vector, src.first_argument().first_argument(), src.second_argument());
+        return vector;
+    }
+};
+
+} // end namespace
+
+//
+// Split storage: the real and the imaginary parts are stored in separate
+// vectors. The parts are ordinary CSVector<T> and take part in expressions,
+// e.g. the element-wise product is
+//
+//      z.real() = x.real() * y.real() - x.imag() * y.imag();
+//      z.imag() = x.real() * y.imag() + x.imag() * y.real();
+//
+template <class T>
+class CSSplitComplexVector
+{
+    static_assert(Floating_Point<T>(), "CSSplitComplexVector must have a floating point type as base!");
+
+public:
+    using value_type = std::complex<T>;
+    using size_type  = std::size_t;
+
+    CSSplitComplexVector(const size_t size = 0)
+        : mReal(size),
+          mImag(size)
+    {}
+
+    explicit CSSplitComplexVector(const CSVector<std::complex<T> >& other)
+        : mReal(other.size()),
+          mImag(other.size())
+    {
+        split(other);
+    }
+
+    size_t size() const { return mReal.size(); }
+
+    CSVector<T>& real() { return mReal; }
+    const CSVector<T>& real() const { return mReal; }
+
+    CSVector<T>& imag() { return mImag; }
+    const CSVector<T>& imag() const { return mImag; }
+
+    value_type operator()(size_t index) const
+    {
+        return value_type(mReal(index), mImag(index));
+    }
+
+    value_type operator[](size_t index) const
+    {
+        return (*this)(index);
+    }
+
+    void set(size_t index, const value_type& value)
+    {
+        mReal(index) = value.real();
+        mImag(index) = value.imag();
+    }
+
+    void resize(size_t newSize)
+    {
+        mReal.resize(newSize);
+        mImag.resize(newSize);
+    }
+
+    // de-interleave other into the real and imaginary parts
+    void split(const CSVector<std::complex<T> >& other);
+
+    // interleave the real and imaginary parts into other
+    void merge(CSVector<std::complex<T> >& other) const;
+
+    CSVector<std::complex<T> > interleaved() const
+    {
+        CSVector<std::complex<T> > ret(size());
+        merge(ret);
+        return ret;
+    }
+
+private:
+    CSVector<T> mReal;
+    CSVector<T> mImag;
+};
+
+template <class T>
+void CSSplitComplexVector<T>::split(const CSVector<std::complex<T> >& other)
+{
+    size_t N = size();
+    if (N != other.size())
+        throw std::runtime_error("Incompatible vector lengths " + std::to_string(N)
+                                 + " " + std::to_string(other.size()) + "(split) !");
+
+    constexpr size_t VECTOR_SIZE = __alignment / sizeof(T);
+
+    using M = impl::mask_type<T>;
+    typedef T vec __attribute__((vector_size (sizeof(T) * VECTOR_SIZE)));
+    typedef M mvec __attribute__((vector_size (sizeof(M) * VECTOR_SIZE)));
+
+    mvec even, odd;
+    for (size_t i = 0; i < VECTOR_SIZE; i++)
+    {
+        even[i] = M(2 * i);
+        odd[i]  = M(2 * i + 1);
+    }
+
+    // two interleaved packets give one packet of each part
+    const vec * Sv = (const vec *) other.data();
+    vec * Rv = (vec *) mReal.data();
+    vec * Iv = (vec *) mImag.data();
+
+    const size_t NO_LOOPS = N / VECTOR_SIZE;
+    for (size_t i = 0; i < NO_LOOPS; ++i)
+    {
+        Rv[i] = __builtin_shuffle(Sv[2 * i], Sv[2 * i + 1], even);
+        Iv[i] = __builtin_shuffle(Sv[2 * i], Sv[2 * i + 1], odd);
+    }
+
+    // deal with left overs
+    for (size_t i = NO_LOOPS * VECTOR_SIZE; i < N; i++)
+    {
+        mReal(i) = other(i).real();
+        mImag(i) = other(i).imag();
+    }
+}
+
+template <class T>
+void CSSplitComplexVector<T>::merge(CSVector<std::complex<T> >& other) const
+{
+    size_t N = size();
+    if (N != other.size())
+        throw std::runtime_error("Incompatible vector lengths " + std::to_string(N)
+                                 + " " + std::to_string(other.size()) + "(merge) !");
+
+    constexpr size_t VECTOR_SIZE = __alignment / sizeof(T);
+
+    using M = impl::mask_type<T>;
+    typedef T vec __attribute__((vector_size (sizeof(T) * VECTOR_SIZE)));
+    typedef M mvec __attribute__((vector_size (sizeof(M) * VECTOR_SIZE)));
+
+    mvec lo, hi;
+    for (size_t i = 0; i < VECTOR_SIZE; i++)
+    {
+        lo[i] = M(i / 2 + (i % 2) * VECTOR_SIZE);
+        hi[i] = M(i / 2 + VECTOR_SIZE / 2 + (i % 2) * VECTOR_SIZE);
+    }
+
+    const vec * Rv = (const vec *) mReal.data();
+    const vec * Iv = (const vec *) mImag.data();
+    vec * Dv = (vec *) other.data();
+
+    const size_t NO_LOOPS = N / VECTOR_SIZE;
+    for (size_t i = 0; i < NO_LOOPS; ++i)
+    {
+        Dv[2 * i]     = __builtin_shuffle(Rv[i], Iv[i], lo);
+        Dv[2 * i + 1] = __builtin_shuffle(Rv[i], Iv[i], hi);
+    }
+
+    // deal with left overs
+    for (size_t i = NO_LOOPS * VECTOR_SIZE; i < N; i++)
+        other(i) = std::complex<T>(mReal(i), mImag(i));
+}
+
+// Hermitian dot product on split storage
+template <class T, class Result = Accumulate_type<T> >
+std::complex<Result> dot(const CSSplitComplexVector<T>& lhs, const CSSplitComplexVector<T>& rhs)
+{
+    size_t N = lhs.size();
+    if (N != rhs.size())
+        throw std::runtime_error("Incompatible vector lengths " + std::to_string(N)
+                                 + " " + std::to_string(rhs.size()) + "(dot) !");
+
+    constexpr size_t VECTOR_SIZE = __alignment / sizeof(Result);
+
+    typedef T lvec __attribute__((vector_size (sizeof(T) * VECTOR_SIZE)));
+    typedef Result vec __attribute__((vector_size (sizeof(Result) * VECTOR_SIZE)));
+
+    vec real = {0}, imag = {0};
+
+    const lvec * Ar = (const lvec *) lhs.real().data();
+    const lvec * Ai = (const lvec *) lhs.imag().data();
+    const lvec * Br = (const lvec *) rhs.real().data();
+    const lvec * Bi = (const lvec *) rhs.imag().data();
+
+    const size_t NO_LOOPS = N / VECTOR_SIZE;
+    for (size_t i = 0; i < NO_LOOPS; ++i)
+    {
+        vec ar = __builtin_convertvector(Ar[i], vec), ai = __builtin_convertvector(Ai[i], vec);
+        vec br = __builtin_convertvector(Br[i], vec), bi = __builtin_convertvector(Bi[i], vec);
+        real += ar * br + ai * bi;
+        imag += ar * bi - ai * br;
+    }
+
+    Result re = {0}, im = {0};
+    for (size_t i = 0; i < VECTOR_SIZE; i++)
+    {
+        re += real[i];
+        im += imag[i];
+    }
+
+    // deal with left overs
+    for (size_t i = NO_LOOPS * VECTOR_SIZE; i < N; i++)
+    {
+        Result ar = Result(lhs.real()(i)), ai = Result(lhs.imag()(i));
+        Result br = Result(rhs.real()(i)), bi = Result(rhs.imag()(i));
+        re += ar * br + ai * bi;
+        im += ar * bi - ai * br;
+    }
+
+    return std::complex<Result>(re, im);
+}
+
+template <class T>
+auto norm(const CSSplitComplexVector<T>& lhs)
+{
+    return std::sqrt(dot(lhs.real(), lhs.real()) + dot(lhs.imag(), lhs.imag()));
+}
+
+// result = lhs * rhs element-wise on split storage, result must not alias lhs or rhs
+template <class T>
+void multiply(CSSplitComplexVector<T>& result, const CSSplitComplexVector<T>& lhs,
+              const CSSplitComplexVector<T>& rhs)
+{
+    result.real() = lhs.real() * rhs.real() - lhs.imag() * rhs.imag();
+    result.imag() = lhs.real() * rhs.imag() + lhs.imag() * rhs.real();
+}
+
+#endif
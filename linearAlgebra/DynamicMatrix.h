@@ -0,0 +1,742 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  File Name:  DynamicMatrix.h                                               //
+//                                                                            //
+//     Author:  Andreas Buttenschoen <andreas@buttenschoen.ca>                //
+//    Created:  2026-10-19 08:02:51                                           //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CS_DYNAMIC_MATRIX_H
+#define CS_DYNAMIC_MATRIX_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "DynamicVector.h"
+
+//
+// Dense matrices of run time size
+//
+//      DynamicMatrix<double> A(m, n);                          // row major
+//      DynamicMatrix<double, StorageOrder::ColumnMajor> B(n, k);
+//
+//      CSVector<double> y = A * x + b;                         // gemv
+//      CSVector<double> z = x * A;                             // A^T x
+//      auto C = A * B;                                         // gemm
+//
+// The rows (columns) are stored with a leading dimension padded to a multiple
+// of the packet, so that each row (column) starts aligned. The padding is
+// zero. The products return CSVectors, which take part in the expressions of
+// VectorOperations.h; vector expressions on the right are evaluated first.
+//
+enum class StorageOrder { RowMajor, ColumnMajor };
+
+template <class T, StorageOrder Order = StorageOrder::RowMajor>
+class DynamicMatrix
+{
+    static_assert(std::is_arithmetic<T>::value, "DynamicMatrix must have an arithmetic type as base!");
+
+public:
+    using value_type = T;
+    using size_type  = std::size_t;
+
+    static constexpr StorageOrder storage_order = Order;
+    static constexpr size_type VectorSize = __alignment / sizeof(T);
+
+    // Creates the matrix without initializing it, except the padding
+    DynamicMatrix(const size_type rows = 0, const size_type cols = 0)
+        : mRows(rows),
+          mCols(cols),
+          mLeading(padded(Order == StorageOrder::RowMajor ? cols : rows)),
+          mpStart(nullptr)
+    {
+        mpStart = (T *)Memory::aligned_alloc(__alignment, memory_size() * sizeof(T));
+
+        const size_type length = line_length();
+        if (mLeading > length)
+            for (size_type k = 0; k < lines(); ++k)
+                std::fill(data(k) + length, data(k) + mLeading, T(0));
+    }
+
+    DynamicMatrix(const size_type rows, const size_type cols, const T value)
+        : DynamicMatrix(rows, cols)
+    {
+        for (size_type k = 0; k < lines(); ++k)
+            std::fill(data(k), data(k) + line_length(), value);
+    }
+
+    // from the rows
+    DynamicMatrix(std::initializer_list<std::initializer_list<T> > rows)
+        : DynamicMatrix(rows.size(), rows.size() ? rows.begin()->size() : 0)
+    {
+        size_type i = 0;
+        for (const auto& row : rows)
+        {
+            if (row.size() != mCols)
+                throw std::runtime_error("Rows of different lengths in DynamicMatrix!");
+
+            size_type j = 0;
+            for (const auto& value : row)
+                operator()(i, j++) = value;
+            ++i;
+        }
+    }
+
+    DynamicMatrix(const DynamicMatrix& other)
+        : DynamicMatrix(other.mRows, other.mCols)
+    {
+        if (mpStart)
+            memcpy(mpStart, other.mpStart, memory_size() * sizeof(T));
+    }
+
+    DynamicMatrix(DynamicMatrix&& other)
+        : mRows(other.mRows),
+          mCols(other.mCols),
+          mLeading(other.mLeading),
+          mpStart(other.mpStart)
+    {
+        other.mRows     = 0;
+        other.mCols     = 0;
+        other.mLeading  = 0;
+        other.mpStart   = nullptr;
+    }
+
+    DynamicMatrix& operator=(const DynamicMatrix& other)
+    {
+        DynamicMatrix copy(other);
+        swap(copy);
+        return *this;
+    }
+
+    DynamicMatrix& operator=(DynamicMatrix&& other)
+    {
+        swap(other);
+        return *this;
+    }
+
+    ~DynamicMatrix()
+    {
+        aligned_free(mpStart);
+    }
+
+    static DynamicMatrix identity(const size_type n)
+    {
+        DynamicMatrix ret(n, n);
+        ret.setZero();
+        for (size_type i = 0; i < n; ++i)
+            ret(i, i) = T(1);
+        return ret;
+    }
+
+    void swap(DynamicMatrix& other)
+    {
+        using std::swap;
+        swap(mRows,     other.mRows);
+        swap(mCols,     other.mCols);
+        swap(mLeading,  other.mLeading);
+        swap(mpStart,   other.mpStart);
+    }
+
+    size_type index(const size_type i, const size_type j) const
+    {
+        return (Order == StorageOrder::RowMajor) ? i * mLeading + j : j * mLeading + i;
+    }
+
+    T& operator()(const size_type i, const size_type j) { return mpStart[index(i, j)]; }
+    const T& operator()(const size_type i, const size_type j) const { return mpStart[index(i, j)]; }
+
+    T& at(const size_type i, const size_type j)
+    {
+        check(i, j);
+        return operator()(i, j);
+    }
+
+    const T& at(const size_type i, const size_type j) const
+    {
+        check(i, j);
+        return operator()(i, j);
+    }
+
+    size_type rows() const { return mRows; }
+    size_type cols() const { return mCols; }
+    size_type size() const { return mRows * mCols; }
+
+    // the rows (columns) of the storage, their length and their stride
+    size_type lines() const { return (Order == StorageOrder::RowMajor) ? mRows : mCols; }
+    size_type line_length() const { return (Order == StorageOrder::RowMajor) ? mCols : mRows; }
+    size_type leading_dimension() const { return mLeading; }
+
+    size_type memory_size() const { return lines() * mLeading; }
+    size_type alignment() const { return __alignment; }
+
+    // the start of row (column) k
+    T * data(const size_type k = 0) { return mpStart + k * mLeading; }
+    const T * data(const size_type k = 0) const { return mpStart + k * mLeading; }
+
+    void setZero()
+    {
+        if (mpStart)
+            memset(mpStart, 0, memory_size() * sizeof(T));
+    }
+
+private:
+
+    static size_type padded(const size_type n)
+    {
+        return (n + VectorSize - 1) / VectorSize * VectorSize;
+    }
+
+    void check(const size_type i, const size_type j) const
+    {
+        if (!(i < mRows && j < mCols))
+            throw std::out_of_range("Index (" + std::to_string(i) + ", " + std::to_string(j)
+                                    + ") outside of " + std::to_string(mRows) + " x "
+                                    + std::to_string(mCols));
+    }
+
+    size_type mRows;
+    size_type mCols;
+    size_type mLeading;
+
+    T * mpStart;
+};
+
+template <class T, StorageOrder Order>
+inline void swap(DynamicMatrix<T, Order>& lhs, DynamicMatrix<T, Order>& rhs)
+{
+    lhs.swap(rhs);
+}
+
+template <class T, StorageOrder Order>
+using Other_order = DynamicMatrix<T, Order == StorageOrder::RowMajor ? StorageOrder::ColumnMajor
+                                                                      : StorageOrder::RowMajor>;
+
+// The transpose has the same storage in the other order
+template <class T, StorageOrder Order>
+Other_order<T, Order> transpose(const DynamicMatrix<T, Order>& a)
+{
+    Other_order<T, Order> ret(a.cols(), a.rows());
+    if (a.memory_size())
+        memcpy(ret.data(), a.data(), a.memory_size() * sizeof(T));
+    return ret;
+}
+
+template <class T, StorageOrder Order>
+std::ostream& operator<<(std::ostream& os, const DynamicMatrix<T, Order>& a)
+{
+    for (std::size_t i = 0; i < a.rows(); ++i)
+    {
+        for (std::size_t j = 0; j < a.cols(); ++j)
+            os << a(i, j) << ((j + 1 < a.cols()) ? " " : "");
+        os << "\n";
+    }
+    return os;
+}
+
+namespace impl {
+
+// The packets of the matrix kernels. The gemm microkernel uses the widest
+// registers, the gemv kernels the aligned packets of the storage.
+template <class T, std::size_t Bytes>
+struct matrix_packet
+{
+    static constexpr std::size_t size = Bytes / sizeof(T);
+    typedef T type __attribute__((vector_size (Bytes)));
+    typedef T unaligned __attribute__((vector_size (Bytes), aligned (sizeof(T))));
+};
+
+#if defined(__AVX512F__)
+static constexpr std::size_t GemmPacketBytes = 64;
+#else
+static constexpr std::size_t GemmPacketBytes = __alignment;
+#endif
+
+// c + a * b, fused on hardware with FMA
+template <class T, class V>
+inline V packet_madd(const V& a, const V& b, const V& c)
+{
+#if defined(__AVX512F__)
+    if constexpr (sizeof(V) == 64 && std::is_same<T, double>::value)
+        return V(_mm512_fmadd_pd(__m512d(a), __m512d(b), __m512d(c)));
+    if constexpr (sizeof(V) == 64 && std::is_same<T, float>::value)
+        return V(_mm512_fmadd_ps(__m512(a), __m512(b), __m512(c)));
+#endif
+#if defined(__FMA__)
+    if constexpr (sizeof(V) == 32 && std::is_same<T, double>::value)
+        return V(_mm256_fmadd_pd(__m256d(a), __m256d(b), __m256d(c)));
+    if constexpr (sizeof(V) == 32 && std::is_same<T, float>::value)
+        return V(_mm256_fmadd_ps(__m256(a), __m256(b), __m256(c)));
+    if constexpr (sizeof(V) == 16 && std::is_same<T, double>::value)
+        return V(_mm_fmadd_pd(__m128d(a), __m128d(b), __m128d(c)));
+    if constexpr (sizeof(V) == 16 && std::is_same<T, float>::value)
+        return V(_mm_fmadd_ps(__m128(a), __m128(b), __m128(c)));
+#endif
+    return c + a * b;
+}
+
+// The matrix kernels run on one thread below this many multiply-adds
+static constexpr std::size_t MatrixParallelThreshold = 1 << 17;
+
+// Calls kernel(begin, end) on chunks covering [0, n) (see chunked_for in
+// DynamicVector.h), on the calling thread below MatrixParallelThreshold
+// multiply-adds of work
+template <class T, class Kernel>
+inline void matrix_for(std::size_t n, std::size_t work, Kernel kernel)
+{
+    chunked_for<T>(n, work, MatrixParallelThreshold, kernel);
+}
+
+//
+// y_i = sum_j a_ij x_j for the rows i in [begin, end), a_ij = a[i * lda + j].
+// Four rows are reduced at once, so that each packet of x is loaded once
+// for them.
+//
+template <class T>
+void gemv_dot(std::size_t n, const T * a, std::size_t lda, const T * __restrict__ x,
+              T * __restrict__ y, std::size_t begin, std::size_t end)
+{
+    using packet = matrix_packet<T, __alignment>;
+    using P = typename packet::type;
+    constexpr std::size_t VS = packet::size;
+
+    const std::size_t NP = n / VS * VS;
+
+    const auto sum = [](const P& p)
+    {
+        T s = p[0];
+        for (std::size_t l = 1; l < VS; ++l)
+            s += p[l];
+        return s;
+    };
+
+    std::size_t i = begin;
+    for (; i + 4 <= end; i += 4)
+    {
+        const T * a0 = a + i * lda;
+        const T * a1 = a0 + lda;
+        const T * a2 = a1 + lda;
+        const T * a3 = a2 + lda;
+
+        P s0 = {0}, s1 = {0}, s2 = {0}, s3 = {0};
+        for (std::size_t j = 0; j < NP; j += VS)
+        {
+            const P xv = *(const P *)(x + j);
+            s0 = packet_madd<T>(*(const P *)(a0 + j), xv, s0);
+            s1 = packet_madd<T>(*(const P *)(a1 + j), xv, s1);
+            s2 = packet_madd<T>(*(const P *)(a2 + j), xv, s2);
+            s3 = packet_madd<T>(*(const P *)(a3 + j), xv, s3);
+        }
+
+        T t0 = sum(s0), t1 = sum(s1), t2 = sum(s2), t3 = sum(s3);
+        for (std::size_t j = NP; j < n; ++j)
+        {
+            t0 += a0[j] * x[j];
+            t1 += a1[j] * x[j];
+            t2 += a2[j] * x[j];
+            t3 += a3[j] * x[j];
+        }
+
+        y[i] = t0; y[i + 1] = t1; y[i + 2] = t2; y[i + 3] = t3;
+    }
+
+    for (; i < end; ++i)
+    {
+        const T * ai = a + i * lda;
+
+        P s = {0};
+        for (std::size_t j = 0; j < NP; j += VS)
+            s = packet_madd<T>(*(const P *)(ai + j), *(const P *)(x + j), s);
+
+        T t = sum(s);
+        for (std::size_t j = NP; j < n; ++j)
+            t += ai[j] * x[j];
+        y[i] = t;
+    }
+}
+
+//
+// y_i = sum_j a_ji x_j for i in [begin, end), a_ji = a[j * lda + i], i.e.
+// y is the sum of the columns scaled by x. begin is on a packet boundary.
+// The rows of y are blocked, so that the block of y stays in L1 while four
+// columns at a time are added to it.
+//
+template <class T>
+void gemv_axpy(std::size_t n, const T * a, std::size_t lda, const T * __restrict__ x,
+               T * __restrict__ y, std::size_t begin, std::size_t end)
+{
+    using packet = matrix_packet<T, __alignment>;
+    using P = typename packet::type;
+    constexpr std::size_t VS = packet::size;
+    constexpr std::size_t BLOCK_SIZE = 2048 / sizeof(T) * 4;
+
+    std::fill(y + begin, y + end, T(0));
+
+    for (std::size_t ib = begin; ib < end; ib += BLOCK_SIZE)
+    {
+        const std::size_t ie = std::min(end, ib + BLOCK_SIZE);
+        const std::size_t NP = ib + (ie - ib) / VS * VS;
+
+        std::size_t j = 0;
+        for (; j + 4 <= n; j += 4)
+        {
+            const T * c0 = a + j * lda;
+            const T * c1 = c0 + lda;
+            const T * c2 = c1 + lda;
+            const T * c3 = c2 + lda;
+
+            const P x0 = P{} + x[j], x1 = P{} + x[j + 1], x2 = P{} + x[j + 2], x3 = P{} + x[j + 3];
+            for (std::size_t i = ib; i < NP; i += VS)
+            {
+                P yv = *(P *)(y + i);
+                yv = packet_madd<T>(*(const P *)(c0 + i), x0, yv);
+                yv = packet_madd<T>(*(const P *)(c1 + i), x1, yv);
+                yv = packet_madd<T>(*(const P *)(c2 + i), x2, yv);
+                yv = packet_madd<T>(*(const P *)(c3 + i), x3, yv);
+                *(P *)(y + i) = yv;
+            }
+
+            for (std::size_t i = NP; i < ie; ++i)
+                y[i] += c0[i] * x[j] + c1[i] * x[j + 1] + c2[i] * x[j + 2] + c3[i] * x[j + 3];
+        }
+
+        for (; j < n; ++j)
+        {
+            const T * cj = a + j * lda;
+            const P xj = P{} + x[j];
+            for (std::size_t i = ib; i < NP; i += VS)
+                *(P *)(y + i) = packet_madd<T>(*(const P *)(cj + i), xj, *(P *)(y + i));
+
+            for (std::size_t i = NP; i < ie; ++i)
+                y[i] += cj[i] * x[j];
+        }
+    }
+}
+
+//
+// The blocking of gemm, after Goto and van de Geijn: a KC x NC panel of B is
+// packed into strips of NR columns, and an MC x KC block of A into strips of
+// MR rows. The MR x NR microkernel keeps its tile of C in 2 MR packets, and
+// streams the two strips from L1. The sizes are such that a strip of B stays
+// in L1, a block of A in L2 and a panel of B in L3.
+//
+template <class T>
+struct gemm_blocking
+{
+    using packet = matrix_packet<T, GemmPacketBytes>;
+
+    static constexpr std::size_t MR = 6;
+    static constexpr std::size_t NR = 2 * packet::size;
+    static constexpr std::size_t KC = 256;
+    static constexpr std::size_t MC = 16 * MR;
+    static constexpr std::size_t NC = 4096 / NR * NR;
+};
+
+// packs the kc x nc block b(p, j) = b[p * rs + j * cs] into strips of NR
+// columns, padded with zeros
+template <class T>
+void gemm_pack_b(std::size_t kc, std::size_t nc, const T * b, std::size_t rs, std::size_t cs, T * dst)
+{
+    constexpr std::size_t NR = gemm_blocking<T>::NR;
+
+    for (std::size_t js = 0; js < nc; js += NR)
+    {
+        const std::size_t nr = std::min(NR, nc - js);
+        for (std::size_t p = 0; p < kc; ++p)
+        {
+            const T * src = b + p * rs + js * cs;
+            for (std::size_t j = 0; j < nr; ++j)
+                dst[j] = src[j * cs];
+            for (std::size_t j = nr; j < NR; ++j)
+                dst[j] = T(0);
+            dst += NR;
+        }
+    }
+}
+
+// packs the mc x kc block a(i, p) = a[i * rs + p * cs] into strips of MR
+// rows, padded with zeros
+template <class T>
+void gemm_pack_a(std::size_t mc, std::size_t kc, const T * a, std::size_t rs, std::size_t cs, T * dst)
+{
+    constexpr std::size_t MR = gemm_blocking<T>::MR;
+
+    for (std::size_t is = 0; is < mc; is += MR)
+    {
+        const std::size_t mr = std::min(MR, mc - is);
+        for (std::size_t p = 0; p < kc; ++p)
+        {
+            const T * src = a + is * rs + p * cs;
+            for (std::size_t i = 0; i < mr; ++i)
+                dst[i] = src[i * rs];
+            for (std::size_t i = mr; i < MR; ++i)
+                dst[i] = T(0);
+            dst += MR;
+        }
+    }
+}
+
+// C (mr x nr, row major with ldc) = (or +=) the product of the packed strips
+template <class T>
+inline void gemm_micro(std::size_t kc, const T * __restrict__ a, const T * __restrict__ b,
+                       T * __restrict__ c, std::size_t ldc, std::size_t mr, std::size_t nr,
+                       bool accumulate)
+{
+    using blocking = gemm_blocking<T>;
+    using P = typename blocking::packet::type;
+    using U = typename blocking::packet::unaligned;
+    constexpr std::size_t MR = blocking::MR;
+    constexpr std::size_t NR = blocking::NR;
+    constexpr std::size_t PS = blocking::packet::size;
+
+    P acc[MR][2];
+    for (std::size_t r = 0; r < MR; ++r)
+        acc[r][0] = acc[r][1] = P{};
+
+    for (std::size_t p = 0; p < kc; ++p)
+    {
+        const P b0 = *(const P *)(b);
+        const P b1 = *(const P *)(b + PS);
+
+        #pragma GCC unroll 8
+        for (std::size_t r = 0; r < MR; ++r)
+        {
+            const P ar = P{} + a[r];
+            acc[r][0] = packet_madd<T>(ar, b0, acc[r][0]);
+            acc[r][1] = packet_madd<T>(ar, b1, acc[r][1]);
+        }
+
+        a += MR;
+        b += NR;
+    }
+
+    if (mr == MR && nr == NR)
+    {
+        for (std::size_t r = 0; r < MR; ++r)
+        {
+            U * cr = (U *)(c + r * ldc);
+            if (accumulate)
+            {
+                cr[0] += acc[r][0];
+                cr[1] += acc[r][1];
+            }
+            else
+            {
+                cr[0] = acc[r][0];
+                cr[1] = acc[r][1];
+            }
+        }
+        return;
+    }
+
+    // the edges of C go through the tile
+    alignas(GemmPacketBytes) T tile[MR][NR];
+    for (std::size_t r = 0; r < MR; ++r)
+    {
+        *(P *)(tile[r]) = acc[r][0];
+        *(P *)(tile[r] + PS) = acc[r][1];
+    }
+
+    for (std::size_t r = 0; r < mr; ++r)
+        for (std::size_t j = 0; j < nr; ++j)
+            c[r * ldc + j] = accumulate ? c[r * ldc + j] + tile[r][j] : tile[r][j];
+}
+
+//
+// C = A B with C m x n row major with ldc, and the strided operands
+// a(i, p) = a[i * ars + p * acs] and b(p, j) = b[p * brs + j * bcs].
+// The blocks of A are distributed over the threads, which share the packed
+// panel of B.
+//
+template <class T>
+void gemm(std::size_t m, std::size_t n, std::size_t k,
+          const T * a, std::size_t ars, std::size_t acs,
+          const T * b, std::size_t brs, std::size_t bcs,
+          T * c, std::size_t ldc)
+{
+    using blocking = gemm_blocking<T>;
+    constexpr std::size_t MR = blocking::MR;
+    constexpr std::size_t NR = blocking::NR;
+    constexpr std::size_t KC = blocking::KC;
+    constexpr std::size_t MC = blocking::MC;
+    constexpr std::size_t NC = blocking::NC;
+
+    if (m == 0 || n == 0)
+        return;
+
+    if (k == 0)
+    {
+        for (std::size_t i = 0; i < m; ++i)
+            std::fill(c + i * ldc, c + i * ldc + n, T(0));
+        return;
+    }
+
+    const std::size_t ncMax = std::min(NC, (n + NR - 1) / NR * NR);
+    const std::size_t kcMax = std::min(KC, k);
+
+    T * bpack = (T *)Memory::aligned_alloc(GemmPacketBytes, kcMax * ncMax * sizeof(T));
+
+    const std::size_t Threads  = Tuning::profile().threads;
+    const bool parallel        = (m * n * k >= MatrixParallelThreshold) && (m > MC) && (Threads > 1);
+    const std::size_t mBlocks  = (m + MC - 1) / MC;
+
+    #pragma omp parallel num_threads(Threads) if (parallel)
+    {
+        T * apack = (T *)Memory::aligned_alloc(GemmPacketBytes, MC * kcMax * sizeof(T));
+
+        for (std::size_t jc = 0; jc < n; jc += NC)
+        {
+            const std::size_t nc = std::min(NC, n - jc);
+            for (std::size_t pc = 0; pc < k; pc += KC)
+            {
+                const std::size_t kc = std::min(KC, k - pc);
+
+                #pragma omp single
+                gemm_pack_b(kc, nc, b + pc * brs + jc * bcs, brs, bcs, bpack);
+
+                #pragma omp for schedule(static)
+                for (std::size_t ib = 0; ib < mBlocks; ++ib)
+                {
+                    const std::size_t ic = ib * MC;
+                    const std::size_t mc = std::min(MC, m - ic);
+                    gemm_pack_a(mc, kc, a + ic * ars + pc * acs, ars, acs, apack);
+
+                    for (std::size_t jr = 0; jr < nc; jr += NR)
+                        for (std::size_t ir = 0; ir < mc; ir += MR)
+                            gemm_micro(kc, apack + ir * kc, bpack + jr * kc,
+                                       c + (ic + ir) * ldc + jc + jr, ldc,
+                                       std::min(MR, mc - ir), std::min(NR, nc - jr), pc > 0);
+                }
+            }
+        }
+
+        aligned_free(apack);
+    }
+
+    aligned_free(bpack);
+}
+
+inline void matrix_check(bool compatible, const char * name)
+{
+    if (!compatible)
+        throw std::runtime_error(std::string("Incompatible matrix sizes in ") + name + "!");
+}
+
+// y = A x
+template <class T, StorageOrder Order>
+void gemv(const DynamicMatrix<T, Order>& a, const CSVector<T>& x, CSVector<T>& y)
+{
+    matrix_check(a.cols() == x.size() && a.rows() == y.size(), "gemv");
+
+    FASTVECTOR_INSTRUMENT(("gemv, " + type_name<T>()), a.size(), (a.size() + a.rows() + a.cols()) * sizeof(T));
+
+    const T * A = a.data();
+    const std::size_t lda = a.leading_dimension();
+    const T * X = x.data();
+    T * Y = y.data();
+
+    if constexpr (Order == StorageOrder::RowMajor)
+        matrix_for<T>(a.rows(), a.size(), [&](std::size_t begin, std::size_t end)
+                      { gemv_dot(a.cols(), A, lda, X, Y, begin, end); });
+    else
+        matrix_for<T>(a.rows(), a.size(), [&](std::size_t begin, std::size_t end)
+                      { gemv_axpy(a.cols(), A, lda, X, Y, begin, end); });
+}
+
+// y = A^T x
+template <class T, StorageOrder Order>
+void gemv_transpose(const DynamicMatrix<T, Order>& a, const CSVector<T>& x, CSVector<T>& y)
+{
+    matrix_check(a.rows() == x.size() && a.cols() == y.size(), "gemv");
+
+    FASTVECTOR_INSTRUMENT(("gemv, " + type_name<T>()), a.size(), (a.size() + a.rows() + a.cols()) * sizeof(T));
+
+    const T * A = a.data();
+    const std::size_t lda = a.leading_dimension();
+    const T * X = x.data();
+    T * Y = y.data();
+
+    if constexpr (Order == StorageOrder::RowMajor)
+        matrix_for<T>(a.cols(), a.size(), [&](std::size_t begin, std::size_t end)
+                      { gemv_axpy(a.rows(), A, lda, X, Y, begin, end); });
+    else
+        matrix_for<T>(a.cols(), a.size(), [&](std::size_t begin, std::size_t end)
+                      { gemv_dot(a.rows(), A, lda, X, Y, begin, end); });
+}
+
+// the strides of the rows and columns of a
+template <class T, StorageOrder Order>
+inline std::pair<std::size_t, std::size_t> strides(const DynamicMatrix<T, Order>& a)
+{
+    if constexpr (Order == StorageOrder::RowMajor)
+        return {a.leading_dimension(), 1};
+    else
+        return {1, a.leading_dimension()};
+}
+
+} // end namespace
+
+template <class T, StorageOrder Order>
+CSVector<T> operator*(const DynamicMatrix<T, Order>& a, const CSVector<T>& x)
+{
+    CSVector<T> y(a.rows());
+    impl::gemv(a, x, y);
+    return y;
+}
+
+// x^T A
+template <class T, StorageOrder Order>
+CSVector<T> operator*(const CSVector<T>& x, const DynamicMatrix<T, Order>& a)
+{
+    CSVector<T> y(a.cols());
+    impl::gemv_transpose(a, x, y);
+    return y;
+}
+
+template <class T, StorageOrder Order, class E,
+          typename = Disable_if<Same<E, CSVector<T> >()> >
+CSVector<T> operator*(const DynamicMatrix<T, Order>& a, const VectorExpression<E>& x)
+{
+    return a * CSVector<T>(static_cast<const E&>(x));
+}
+
+template <class T, StorageOrder Order, class E,
+          typename = Disable_if<Same<E, CSVector<T> >()> >
+CSVector<T> operator*(const VectorExpression<E>& x, const DynamicMatrix<T, Order>& a)
+{
+    return CSVector<T>(static_cast<const E&>(x)) * a;
+}
+
+// The product has the storage order of the left factor
+template <class T, StorageOrder Order1, StorageOrder Order2>
+DynamicMatrix<T, Order1> operator*(const DynamicMatrix<T, Order1>& a, const DynamicMatrix<T, Order2>& b)
+{
+    impl::matrix_check(a.cols() == b.rows(), "gemm");
+
+    DynamicMatrix<T, Order1> c(a.rows(), b.cols());
+
+    FASTVECTOR_INSTRUMENT(("gemm, " + type_name<T>()), a.rows() * b.cols() * a.cols(),
+                          (a.size() + b.size() + c.size()) * sizeof(T));
+
+    const auto as = impl::strides(a);
+    const auto bs = impl::strides(b);
+
+    // a column major C is computed as the row major C^T = B^T A^T
+    if constexpr (Order1 == StorageOrder::RowMajor)
+        impl::gemm(a.rows(), b.cols(), a.cols(), a.data(), as.first, as.second,
+                   b.data(), bs.first, bs.second, c.data(), c.leading_dimension());
+    else
+        impl::gemm(b.cols(), a.rows(), a.cols(), b.data(), bs.second, bs.first,
+                   a.data(), as.second, as.first, c.data(), c.leading_dimension());
+
+    return c;
+}
+
+#endif
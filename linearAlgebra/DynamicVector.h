@@ -18,6 +18,7 @@
 #include <algorithm>
 #include <initializer_list>
 #include <limits>
+#include <vector>
 
 #include "AlignedMemory.h"
 #include "AlignedVector.h"
@@ -27,6 +28,7 @@
 #include "VectorTraits.h"
 #include "VectorOperations.h"
 #include "VectorExpression.h"
+#include "Instrumentation.h"
 #include "VectorOperations.h"
 
 #define PREFETCH_LENGTH 2
@@ -36,11 +38,73 @@ using namespace Expression;
 
 using std::max;
 
-// TODO: write a bool version of this!
+template <class To, class From>
+void convert(CSVector<To>& dst, const CSVector<From>& src);
+
+namespace impl {
+
+// The start of chunk c when n elements are split into Chunks chunks, e.g. one
+// per thread. The chunks start on packet boundaries, so that each stays
+// aligned, and the last one takes the left overs.
+template <class T>
+inline size_t chunk_start(size_t c, size_t Chunks, size_t n)
+{
+    constexpr size_t VECTOR_SIZE = __alignment / sizeof(T);
+    return (c == Chunks) ? n : c * (n / VECTOR_SIZE) / Chunks * VECTOR_SIZE;
+}
+
+// Calls kernel(begin, end) on one chunk per thread covering [0, n). Below
+// threshold units of work, e.g. elements or multiply-adds, the kernel is
+// called once on [0, n) on the calling thread.
+template <class T, class Kernel>
+void chunked_for(size_t n, size_t work, size_t threshold, Kernel kernel)
+{
+    const size_t Threads = Tuning::profile().threads;
+    if (work < threshold || Threads < 2)
+    {
+        kernel(size_t(0), n);
+        return;
+    }
+
+    #pragma omp parallel for num_threads(Threads)
+    for (size_t c = 0; c < Threads; ++c)
+        kernel(chunk_start<T>(c, Threads, n), chunk_start<T>(c + 1, Threads, n));
+}
+
+// Converts n elements of src to dst. Both pointers must be aligned to a packet
+// of VECTOR_SIZE elements. This is specialized for the storage types in
+// HalfPrecision.h.
+template <class To, class From>
+struct converter
+{
+    // size the packets such that neither side exceeds the alignment
+    static constexpr size_t VECTOR_SIZE = __alignment / (sizeof(To) > sizeof(From) ? sizeof(To) : sizeof(From));
+
+    static inline void apply(To * __restrict__ dst, const From * __restrict__ src, size_t n)
+    {
+        typedef From fvec __attribute__((vector_size (sizeof(From) * VECTOR_SIZE)));
+        typedef To   tvec __attribute__((vector_size (sizeof(To) * VECTOR_SIZE)));
+
+        const fvec * Sv = (const fvec *) src;
+        tvec * Dv = (tvec *) dst;
+
+        const size_t NO_LOOPS = n / VECTOR_SIZE;
+        for (size_t i = 0; i < NO_LOOPS; ++i)
+            Dv[i] = __builtin_convertvector(Sv[i], tvec);
+
+        // deal with left overs
+        for (size_t i = NO_LOOPS * VECTOR_SIZE; i < n; i++)
+            dst[i] = To(src[i]);
+    }
+};
+
+} // end namespace
+
+// CSVector<bool> is a bit-packed specialization, see DynamicBoolVector.h
 template <class T>
 class CSVector : public VectorExpression<CSVector<T>>
 {
-    static_assert(Arithmetic<T>(), "CSVector must have an arithmetic type as base!");
+    static_assert(Arithmetic<Compute_type<T> >() || Complex<T>(), "CSVector must have an arithmetic or complex type as base!");
 
 public:
     // ValueType is aligned
@@ -51,7 +115,7 @@ public:
     using size_type = std::size_t;
 
     static constexpr size_type VectorSize = __alignment / sizeof(T);
-    typedef T ScalarPacket __attribute__((vector_size (sizeof(T) * VectorSize)));
+    typedef Real_type<Compute_type<T> > ScalarPacket __attribute__((vector_size (sizeof(Compute_type<T>) * VectorSize)));
 
     // Creates an empty vector: Does not initialize values!
     CSVector(const size_t size = 0)
@@ -92,9 +156,14 @@ public:
     {
         mpStart = (ValueType *)Memory::aligned_alloc(__alignment, mAllocationSize*sizeof(ValueType));
 
-        // fill in stuff
+        // fill in stuff, large copies bypass the cache
         if (mpStart)
-            memcpy(mpStart, other.mpStart, mAllocationSize * sizeof(ValueType));
+        {
+            if (impl::use_streaming_stores<T>(mDataSize))
+                impl::stream_copy<T>(mpStart, other.mpStart, mDataSize);
+            else
+                memcpy(mpStart, other.mpStart, mAllocationSize * sizeof(ValueType));
+        }
 
         mpEnd = mpStart + mDataSize;
     }
@@ -111,6 +180,14 @@ public:
         other.mDataSize         = 0;
     }
 
+    // Converting copy e.g. CSVector<double> from CSVector<float>
+    template <class U, typename = Enable_if<Different<U, T>()> >
+    CSVector(const CSVector<U>& other)
+        : CSVector(other.size())
+    {
+        convert(*this, other);
+    }
+
     // Assignment operator for the use with template expressions - TODO create a
     // trait for this assignment operator it currently gets selected too often!
     template <class Other, typename = Disable_if<Same<Other, CSVector<T> >() || Integral<Other>() > >
@@ -166,6 +243,14 @@ public:
         return VectorAssignment<CSVector<T>, Other>()(static_cast<CSVector<T>&>(*this), that);
     }
 
+    // Converting assignment, done in one vectorized pass (see convert below)
+    template <class U, typename = Enable_if<Different<U, T>()> >
+    CSVector& operator=(const CSVector<U>& that)
+    {
+        convert(*this, that);
+        return *this;
+    }
+
     ~CSVector()
     {
         aligned_free( mpStart );
@@ -256,64 +341,6 @@ size(const CSVector<T>& vector)
     return vector.size();
 }
 
-//template <>
-//class CSVector<bool>
-//{
-//public:
-//    static constexpr int N = 1;
-//
-//
-//    uint8_t * data() { return mData; }
-//    std::size_t count() const;
-//
-//    // Operations
-//    explicit operator bool() const { return all(); }
-//    bool all() const;
-//    bool any() const { return !none(); };
-//    bool none() const;
-//
-//    CSVector operator~() const
-//    {
-//        CSVector ret;
-//        for (std::size_t i = 0; i != mDataSize; ++i)
-//            ret.mData[i] = ~mData[i];
-//        return ret;
-//    }
-//
-//    CSVector operator&=(const CSVector& other)
-//    {
-//        for (std::size_t i = 0; i != mDataSize; ++i)
-//            mData[i] &= other.mData[i];
-//        return *this;
-//    }
-//
-//    CSVector operator|=(const CSVector& other)
-//    {
-//        for (std::size_t i = 0; i != mDataSize; ++i)
-//            mData[i] |= other.mData[i];
-//        return *this;
-//    }
-//
-//    CSVector operator^=(const CSVector& other)
-//    {
-//        for (std::size_t i = 0; i != mDataSize; ++i)
-//            mData[i] ^= other.mData[i];
-//        return *this;
-//    }
-//
-//private:
-//    //enum : std::size_t
-//    //{
-//    //    FullSegmentMask = 0xFF,
-//    //    LastSegmentMask = (1 << N % 8) - 1
-//    //};
-//
-//    uint8_t * mData;
-//
-//    size_t mAllocationSize;
-//    size_t mDataSize;
-//};
-
 template <class T>
 inline bool CSVector<T>::requires_reallocation(size_t elements)
 {
@@ -324,7 +351,10 @@ template <class T>
 inline void
 CSVector<T>::setZero()
 {
-    memset(mpStart, 0, mDataSize * sizeof(T));
+    if (impl::use_streaming_stores<T>(mDataSize))
+        impl::stream_fill<T>(mpStart, T(0), mDataSize);
+    else
+        memset(mpStart, 0, mDataSize * sizeof(T));
 }
 
 
@@ -368,8 +398,12 @@ CSVector<T>::resizeAndFill( size_t newSize, T value, size_t allocationChunk )
     // If the vector was enlarged set new values to that value!
     if (newSize > mDataSize)
     {
-        for (size_t i = mDataSize; i < newSize; i++)
-            mpStart[i] = value;
+        if (impl::use_streaming_stores<T>(newSize - mDataSize))
+            impl::stream_fill<T>(mpStart + mDataSize, value, newSize - mDataSize);
+        else
+            // through T *, the over-aligned ValueType * would let gcc assume
+            // that mpStart + mDataSize is aligned
+            std::fill((T *)mpStart + mDataSize, (T *)mpStart + newSize, value);
     }
 
     mDataSize = newSize;
@@ -416,7 +450,7 @@ inline void swap(CSVector<T>& lhs, CSVector<T>& rhs)
 }
 
 template <class T>
-T triple(const CSVector<T> &a, const CSVector<T>& b, const CSVector<T>& c)
+Accumulate_type<T> triple(const CSVector<T> &a, const CSVector<T>& b, const CSVector<T>& c)
 {
     size_t N = a.size();
     if (N != b.size() || N != c.size())
@@ -424,7 +458,7 @@ T triple(const CSVector<T> &a, const CSVector<T>& b, const CSVector<T>& c)
                                  + " " + std::to_string(b.size()) +
                                  " " + std::to_string(c.size()) + "!");
 
-    T triple = {0};
+    Accumulate_type<T> triple = {0};
     for (size_t i = 0; i < N; i++)
         triple += a(i) * b(i) * c(i);
     return triple;
@@ -456,53 +490,53 @@ T triple(const CSVector<T> &a, const CSVector<T>& b, const CSVector<T>& c)
 // The other important piece for the code below is gcc's vector instructions.
 // See section 6.51 in the manual.
 //
-template <class T>
-T dot(const CSVector<T>& lhs, const CSVector<T>& rhs)
+namespace impl {
+
+// The packets are sized by the accumulator type Result. In mixed precision
+// (float data, double accumulator) each packet of VECTOR_SIZE floats is
+// widened with __builtin_convertvector (cvtps2pd) before the multiply-add, so
+// the memory traffic is that of the float data.
+template <class Result, class T, class U>
+Result packet_dot(const T * __restrict__ a, const U * __restrict__ b, size_t N)
 {
-    size_t N = lhs.size();
-    if (N != rhs.size())
-        throw std::runtime_error("Incompatible vector lengths " + std::to_string(N)
-                                 + " " + std::to_string(rhs.size()) + "(dot) !");
-
     // Optimize the computation of the dot product. This is ~66% faster than the
     // naive implementation
-    constexpr size_t VECTOR_SIZE = __alignment / sizeof(T);
+    constexpr size_t VECTOR_SIZE = __alignment / sizeof(Result);
 
     size_t REMAINDER_LOOP_START = 0;
     constexpr size_t CHUNK_SIZE = PREFETCH_LENGTH * VECTOR_SIZE;
 
     // init
-    T dot = {0};
+    Result dot = {0};
 
     if (likely(N >= CHUNK_SIZE))
     {
-        using ValueType = typename CSVector<T>::ValueType;
-        typedef ValueType vec __attribute__((vector_size (sizeof(ValueType) * VECTOR_SIZE)));
+        typedef T lvec __attribute__((vector_size (sizeof(T) * VECTOR_SIZE)));
+        typedef U rvec __attribute__((vector_size (sizeof(U) * VECTOR_SIZE)));
+        typedef Result vec __attribute__((vector_size (sizeof(Result) * VECTOR_SIZE)));
 
         vec temp1 = {0}, temp2 = {0};
 
-        const ValueType * __restrict__ a = lhs.data();
-        const ValueType * __restrict__ b = rhs.data();
-
-        vec * Av = (vec *) a;
-        vec * Bv = (vec *) b;
+        lvec * Av = (lvec *) a;
+        rvec * Bv = (rvec *) b;
 
         size_t NO_LOOPS = N / CHUNK_SIZE;
+        const size_t prefetch = Tuning::profile().prefetchDistance;
         for (size_t i = 0; i < NO_LOOPS; ++i)
         {
-            __builtin_prefetch(Av + 2, 0, 0);
-            temp1 += *Av * *Bv;
+            __builtin_prefetch(Av + prefetch, 0, 0);
+            temp1 += __builtin_convertvector(*Av, vec) * __builtin_convertvector(*Bv, vec);
             Av++;
             Bv++;
 
-            temp2 += *Av * *Bv;
+            temp2 += __builtin_convertvector(*Av, vec) * __builtin_convertvector(*Bv, vec);
             Av++;
             Bv++;
         }
 
         union {
             vec tempv;
-            T tempd[VECTOR_SIZE];
+            Result tempd[VECTOR_SIZE];
         };
 
         tempv = temp1;
@@ -520,20 +554,123 @@ T dot(const CSVector<T>& lhs, const CSVector<T>& rhs)
 
     // deal with left overs
     for (size_t i = REMAINDER_LOOP_START; i < N; i++)
-        dot = std::fma(lhs(i), rhs(i), dot);
+        dot = std::fma(Result(a[i]), Result(b[i]), dot);
 
     return dot;
 }
 
+// Storage types can't be loaded into packets directly. Instead blocks are
+// widened into buffers on the stack, which stay in L1, and the dot product is
+// computed on the buffers.
+template <class Result, class T, class U>
+Result blocked_dot(const T * __restrict__ a, const U * __restrict__ b, size_t N)
+{
+    using TC = Compute_type<T>;
+    using UC = Compute_type<U>;
+
+    constexpr size_t BLOCK_SIZE = 512;
+    alignas(__alignment) TC abuf[BLOCK_SIZE];
+    alignas(__alignment) UC bbuf[BLOCK_SIZE];
+
+    Result dot = {0};
+    for (size_t start = 0; start < N; start += BLOCK_SIZE)
+    {
+        size_t n = std::min(BLOCK_SIZE, N - start);
+        converter<TC, T>::apply(abuf, a + start, n);
+        converter<UC, U>::apply(bbuf, b + start, n);
+        dot += packet_dot<Result>(abuf, bbuf, n);
+    }
+
+    return dot;
+}
+
+template <class Result, class T, class U>
+Result dot_product(const CSVector<T>& lhs, const CSVector<U>& rhs)
+{
+    size_t N = lhs.size();
+    if (N != rhs.size())
+        throw std::runtime_error("Incompatible vector lengths " + std::to_string(N)
+                                 + " " + std::to_string(rhs.size()) + "(dot) !");
+
+    FASTVECTOR_INSTRUMENT(("dot, " + type_name<T, U>()), N, N * (sizeof(T) + sizeof(U)));
+
+    if constexpr (Different<T, Compute_type<T> >() || Different<U, Compute_type<U> >())
+        return blocked_dot<Result>(lhs.data(), rhs.data(), N);
+    else
+        return packet_dot<Result>(lhs.data(), rhs.data(), N);
+}
+
+} // end namespace
+
+//
+// The accumulator defaults to Accumulate_type<T> i.e. float vectors are
+// accumulated in double. Use dot<float, float>(x, y) to accumulate in float.
+//
+template <class T, class Result = Accumulate_type<T> >
+Result dot(const CSVector<T>& lhs, const CSVector<T>& rhs)
+{
+    return impl::dot_product<Result>(lhs, rhs);
+}
+
+// mixed precision dot product e.g. of a float and a double vector
+template <class T, class U, typename = Enable_if<Different<T, U>()> >
+auto dot(const CSVector<T>& lhs, const CSVector<U>& rhs)
+{
+    return impl::dot_product<Accumulate_type<Common_type<T, U> > >(lhs, rhs);
+}
+
 template <class T>
-T norm(const CSVector<T>& lhs)
+auto norm(const CSVector<T>& lhs)
 {
     // TODO check if this violates the later use of __restrict__ But it
     // shouldn't as i only ever read from these values
-    T norm2 = dot(lhs, lhs);
+    auto norm2 = dot(lhs, lhs);
     return sqrt(norm2);
 }
 
+//
+// Converts the elements of src into dst. Both vectors are read and written
+// exactly once; the packets are converted using __builtin_convertvector which
+// gcc lowers to cvtps2pd / cvtpd2ps for float <-> double.
+//
+template <class To, class From>
+void convert(CSVector<To>& dst, const CSVector<From>& src)
+{
+    size_t N = dst.size();
+    if (N != src.size())
+        throw std::runtime_error("Incompatible vector lengths " + std::to_string(N)
+                                 + " " + std::to_string(src.size()) + "(convert) !");
+
+    FASTVECTOR_INSTRUMENT(("convert, " + type_name<To, From>()), N, N * (sizeof(To) + sizeof(From)));
+
+    // the chunks are a multiple of any packet size so each chunk stays aligned
+    constexpr size_t CHUNK_SIZE = 1024;
+    const size_t Threads = Tuning::profile().threads;
+
+    const size_t NO_CHUNKS = (N + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+    #pragma omp parallel for num_threads(Threads)
+    for (size_t i = 0; i < NO_CHUNKS; ++i)
+    {
+        size_t start = i * CHUNK_SIZE;
+        impl::converter<To, From>::apply(dst.data() + start, src.data() + start,
+                                         std::min(CHUNK_SIZE, N - start));
+    }
+}
+
+// Assigns e to v with streaming stores whatever the size of v, e.g. for a
+// result which won't be read again soon. See StreamingStore.h.
+template <class T, class E>
+void streamAssign(CSVector<T>& v, const VectorExpression<E>& e)
+{
+    const E& src = static_cast<const E&>(e);
+    if (v.size() != size(src))
+        throw std::runtime_error("Incompatible vector lengths " + std::to_string(v.size())
+                                 + " " + std::to_string(size(src)) + "(streamAssign) !");
+
+    StreamingExecutionPolicy<CSVector<T>, E, assign<T, typename E::value_type>, true>().assign(v, src);
+}
+
 template <class T>
 T max(const CSVector<T>& lhs)
 {
@@ -541,8 +678,10 @@ T max(const CSVector<T>& lhs)
     if (N == 0)
         throw std::runtime_error("Zero length vector!");
 
+    FASTVECTOR_INSTRUMENT(("max, " + type_name<T>()), N, N * sizeof(T));
+
     // result
-    double res;
+    T res;
 
     // get vector size from alignment
     constexpr size_t VECTOR_SIZE = __alignment / sizeof(T);
@@ -568,9 +707,10 @@ T max(const CSVector<T>& lhs)
         vec * Av = (vec *) a;
 
         size_t NO_LOOPS = N / CHUNK_SIZE;
+        const size_t prefetch = Tuning::profile().prefetchDistance;
         for (size_t i = 0; i < NO_LOOPS; ++i)
         {
-            __builtin_prefetch(Av + 2, 0, 0);
+            __builtin_prefetch(Av + prefetch, 0, 0);
             temp1 = (*Av > temp1) ? *Av : temp1;
             Av++;
 
@@ -615,8 +755,10 @@ T min(const CSVector<T>& lhs)
     if (N == 0)
         throw std::runtime_error("Zero length vector!");
 
+    FASTVECTOR_INSTRUMENT(("min, " + type_name<T>()), N, N * sizeof(T));
+
     // result
-    double res;
+    T res;
 
     // get vector size from alignment
     constexpr size_t VECTOR_SIZE = __alignment / sizeof(T);
@@ -642,9 +784,10 @@ T min(const CSVector<T>& lhs)
         vec * Av = (vec *) a;
 
         size_t NO_LOOPS = N / CHUNK_SIZE;
+        const size_t prefetch = Tuning::profile().prefetchDistance;
         for (size_t i = 0; i < NO_LOOPS; ++i)
         {
-            __builtin_prefetch(Av + 2, 0, 0);
+            __builtin_prefetch(Av + prefetch, 0, 0);
             temp1 = (*Av < temp1) ? *Av : temp1;
             Av++;
 
@@ -689,8 +832,10 @@ T supNorm(const CSVector<T>& lhs)
     if (N == 0)
         throw std::runtime_error("Zero length vector!");
 
+    FASTVECTOR_INSTRUMENT(("supNorm, " + type_name<T>()), N, N * sizeof(T));
+
     // result
-    double res;
+    T res;
 
     // get vector size from alignment
     constexpr size_t VECTOR_SIZE = __alignment / sizeof(T);
@@ -709,10 +854,11 @@ T supNorm(const CSVector<T>& lhs)
         vec * Av = (vec *) a;
 
         size_t NO_LOOPS = N / CHUNK_SIZE;
+        const size_t prefetch = Tuning::profile().prefetchDistance;
         vec tabs;
         for (size_t i = 0; i < NO_LOOPS; ++i)
         {
-            __builtin_prefetch(Av + 2, 0, 0);
+            __builtin_prefetch(Av + prefetch, 0, 0);
             tabs = (*Av > 0) ? *Av : (- (*Av));
             temp1 = (tabs > temp1) ? tabs : temp1;
             Av++;
@@ -752,6 +898,173 @@ T supNorm(const CSVector<T>& lhs)
     return res;
 }
 
+//
+// Index tracking reductions. Next to the packet of the best values so far each
+// lane carries the packet of their indices, which is updated with the same
+// mask, i.e.
+//
+//      mask = key(*Av) > best;
+//      best = mask ? key(*Av) : best;
+//      bidx = mask ? idx : bidx;
+//
+// Large vectors are split into a fixed number of chunks, one per thread. Ties
+// are always broken towards the smaller index, so that the result is the first
+// extremal element as with std::max_element. As there, the result is
+// unspecified if the vector contains nan.
+//
+namespace impl {
+
+struct argmax_select
+{
+    template <class V> static inline V key(const V& x) { return x; }
+    template <class V> static inline auto better(const V& x, const V& y) { return x > y; }
+};
+
+struct argmin_select
+{
+    template <class V> static inline V key(const V& x) { return x; }
+    template <class V> static inline auto better(const V& x, const V& y) { return x < y; }
+};
+
+// the absolute value, written as a select so that it also works on packets
+struct iamax_select
+{
+    template <class V> static inline V key(const V& x) { return (x < 0) ? -x : x; }
+    template <class V> static inline auto better(const V& x, const V& y) { return x > y; }
+};
+
+// The best (key, index) pair among the elements [begin, end) for which
+// the packets [begin, end) / VECTOR_SIZE are aligned.
+template <class Select, class T>
+std::pair<T, size_t> packet_arg_extremum(const T * __restrict__ a, size_t begin, size_t end)
+{
+    constexpr size_t VECTOR_SIZE = __alignment / sizeof(T);
+
+    // the lane indices are relative to begin and have the width of T, so that
+    // a comparison mask selects them directly
+    using Index = std::conditional_t<sizeof(T) == 8, int64_t, int32_t>;
+    typedef T vec __attribute__((vector_size (sizeof(T) * VECTOR_SIZE)));
+    typedef Index ivec __attribute__((vector_size (sizeof(Index) * VECTOR_SIZE)));
+
+    // the indices must fit into Index
+    constexpr size_t MAX_BLOCK = size_t(std::numeric_limits<Index>::max() / 2) / VECTOR_SIZE * VECTOR_SIZE;
+
+    T res = Select::key(a[begin]);
+    size_t index = begin;
+
+    size_t start = begin;
+    for (; start + VECTOR_SIZE <= end; start += MAX_BLOCK)
+    {
+        const size_t NO_PACKETS = std::min(MAX_BLOCK, end - start) / VECTOR_SIZE;
+        const vec * Av = (const vec *) (a + start);
+
+        ivec idx, step;
+        for (size_t i = 0; i < VECTOR_SIZE; ++i)
+        {
+            idx[i]  = Index(i);
+            step[i] = Index(VECTOR_SIZE);
+        }
+
+        vec best  = Select::key(*Av++);
+        ivec bidx = idx;
+
+        for (size_t i = 1; i < NO_PACKETS; ++i)
+        {
+            idx += step;
+            vec x = Select::key(*Av++);
+            auto mask = Select::better(x, best);
+            best = mask ? x : best;
+            bidx = mask ? idx : bidx;
+        }
+
+        // combine the lanes, on a tie the smaller index wins
+        for (size_t i = 0; i < VECTOR_SIZE; ++i)
+        {
+            size_t j = start + size_t(bidx[i]);
+            if (Select::better(best[i], res) || (best[i] == res && j < index))
+            {
+                res   = best[i];
+                index = j;
+            }
+        }
+
+        if (NO_PACKETS * VECTOR_SIZE < MAX_BLOCK)
+        {
+            start += NO_PACKETS * VECTOR_SIZE;
+            break;
+        }
+    }
+
+    // deal with left overs
+    for (size_t i = start; i < end; i++)
+    {
+        T x = Select::key(a[i]);
+        if (Select::better(x, res))
+        {
+            res   = x;
+            index = i;
+        }
+    }
+
+    return {res, index};
+}
+
+template <class Select, class T>
+size_t arg_extremum(const CSVector<T>& lhs)
+{
+    static_assert(Arithmetic<T>(), "The index reductions require a real vector!");
+
+    const size_t N = lhs.size();
+    if (N == 0)
+        throw std::runtime_error("Zero length vector!");
+
+    FASTVECTOR_INSTRUMENT((type_name<Select, T>()), N, N * sizeof(T));
+
+    const T * a = lhs.data();
+    if (N < ReductionParallelThreshold)
+        return packet_arg_extremum<Select>(a, 0, N).second;
+
+    const size_t Threads = Tuning::chunks();
+    std::vector<std::pair<T, size_t> > partial(Threads);
+
+    #pragma omp parallel for num_threads(Threads)
+    for (size_t c = 0; c < Threads; ++c)
+        partial[c] = packet_arg_extremum<Select>(a, chunk_start<T>(c, Threads, N),
+                                                 chunk_start<T>(c + 1, Threads, N));
+
+    // the chunks are in order, so keeping the first strictly best one breaks
+    // ties towards the smaller index
+    auto result = partial[0];
+    for (size_t c = 1; c < Threads; ++c)
+        if (Select::better(partial[c].first, result.first))
+            result = partial[c];
+
+    return result.second;
+}
+
+} // end namespace
+
+// index of the first largest element
+template <class T>
+size_t argmax(const CSVector<T>& lhs)
+{
+    return impl::arg_extremum<impl::argmax_select>(lhs);
+}
+
+// index of the first smallest element
+template <class T>
+size_t argmin(const CSVector<T>& lhs)
+{
+    return impl::arg_extremum<impl::argmin_select>(lhs);
+}
+
+// index of the first element of largest absolute value, as BLAS i?amax
+template <class T>
+size_t iamax(const CSVector<T>& lhs)
+{
+    return impl::arg_extremum<impl::iamax_select>(lhs);
+}
+
 template <class T>
 std::ostream& operator<<(std::ostream& os, const CSVector<T>& vector)
 {
@@ -767,4 +1080,6 @@ std::ostream& operator<<(std::ostream& os, const CSVector<T>& vector)
     return os;
 }
 
+#include "DynamicBoolVector.h"
+
 #endif // CS_VECTOR
@@ -0,0 +1,205 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  File Name:  DynamicVectorPredicates.h                                     //
+//                                                                            //
+//     Author:  Andreas Buttenschoen <andreas@buttenschoen.ca>                //
+//    Created:  2026-10-18 18:20:44                                           //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CS_VECTOR_PREDICATES_H
+#define CS_VECTOR_PREDICATES_H
+
+#include <atomic>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+#include "DynamicVector.h"
+
+//
+// Parallel predicate scans with early exit, e.g. checking a solution for nan
+// or inf after every step
+//
+//      if (!allFinite(u)) ...
+//
+// The vector is split into blocks which the threads take in increasing order.
+// Each block is first tested with a SIMD or-reduction of the predicate, only
+// a block containing a match is searched element by element. The smallest
+// matching index found so far is shared between the threads, and serves as the
+// cancellation flag: blocks past it are skipped. Hence a vector without match
+// costs one streaming pass, while a match near the start returns almost at
+// once.
+//
+// anyNaN and allFinite classify the elements by their bits, so that they also
+// work under -ffinite-math-only, where the compiler folds std::isnan, x != x
+// and x - x == 0 on the assumption that there are no nans and infs.
+//
+namespace impl {
+
+// The unsigned integer of the same width as the IEEE 754 type T
+template <typename T>
+struct ieee_bits
+{
+    using type = std::conditional_t<sizeof(T) == 8, uint64_t, uint32_t>;
+
+    static_assert(std::numeric_limits<T>::is_iec559 && (sizeof(T) == 4 || sizeof(T) == 8),
+                  "Only float and double are classified by their bits!");
+
+    // the exponent bits are all set for +-inf and nan, nan has a non-zero mantissa
+    static constexpr int Mantissa   = std::numeric_limits<T>::digits - 1;
+    static constexpr type Magnitude = ~type(0) >> 1;
+    static constexpr type Exponent  = Magnitude & ~((type(1) << Mantissa) - 1);
+
+    static inline type magnitude(const T x)
+    {
+        type u;
+        std::memcpy(&u, &x, sizeof(u));
+        return u & Magnitude;
+    }
+};
+
+template <typename T>
+inline bool is_nan(const T x)
+{
+    if constexpr (Different<T, Compute_type<T> >())
+        return is_nan(Compute_type<T>(x));
+    else if constexpr (std::is_floating_point<T>::value)
+        return ieee_bits<T>::magnitude(x) > ieee_bits<T>::Exponent;
+    else
+        return false;
+}
+
+template <typename T>
+inline bool is_nan(const std::complex<T>& x)
+{
+    return is_nan(x.real()) || is_nan(x.imag());
+}
+
+template <typename T>
+inline bool is_finite(const T x)
+{
+    if constexpr (Different<T, Compute_type<T> >())
+        return is_finite(Compute_type<T>(x));
+    else if constexpr (std::is_floating_point<T>::value)
+        return ieee_bits<T>::magnitude(x) < ieee_bits<T>::Exponent;
+    else
+        return true;
+}
+
+template <typename T>
+inline bool is_finite(const std::complex<T>& x)
+{
+    return is_finite(x.real()) && is_finite(x.imag());
+}
+
+// returns the smallest index i in [0, N) such that pred(e(i)) or N
+template <typename E, typename Predicate>
+size_t parallel_find(const E& e, Predicate pred, size_t N)
+{
+    constexpr size_t BLOCK_SIZE = 2048;
+    const size_t Threads        = Tuning::profile().threads;
+
+    const size_t NO_BLOCKS = (N + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    std::atomic<size_t> found(N);
+
+    #pragma omp parallel for schedule(static, 1) num_threads(Threads)
+    for (size_t block = 0; block < NO_BLOCKS; ++block)
+    {
+        const size_t start = block * BLOCK_SIZE;
+
+        // a match was found before this block
+        if (start >= found.load(std::memory_order_relaxed))
+            continue;
+
+        const size_t end = std::min(start + BLOCK_SIZE, N);
+
+        // an int reduction, gcc doesn't vectorize a bool one
+        int hit = 0;
+        #pragma omp simd reduction(|:hit)
+        for (size_t i = start; i < end; ++i)
+            hit |= int(pred(e(i)));
+
+        if (likely(!hit))
+            continue;
+
+        size_t index = start;
+        while (!pred(e(index)))
+            ++index;
+
+        // keep the smallest index
+        size_t current = found.load(std::memory_order_relaxed);
+        while (index < current && !found.compare_exchange_weak(current, index, std::memory_order_relaxed))
+        {}
+    }
+
+    return found.load();
+}
+
+} // end namespace
+
+// Returns the index of the first element for which pred is true or size(e)
+template <typename E, typename Predicate>
+size_t findFirst(const VectorExpression<E>& e, Predicate pred)
+{
+    const E& v = static_cast<const E&>(e);
+    return impl::parallel_find(v, pred, size(v));
+}
+
+template <typename E>
+bool anyNaN(const VectorExpression<E>& e)
+{
+    using T = typename E::value_type;
+    const E& v = static_cast<const E&>(e);
+
+    auto isnan = [](const T x) { return impl::is_nan(x); };
+    return impl::parallel_find(v, isnan, size(v)) != size(v);
+}
+
+template <typename E>
+bool allFinite(const VectorExpression<E>& e)
+{
+    using T = typename E::value_type;
+    const E& v = static_cast<const E&>(e);
+
+    auto notfinite = [](const T x) { return !impl::is_finite(x); };
+    return impl::parallel_find(v, notfinite, size(v)) == size(v);
+}
+
+//
+// Returns true if |a_i - b_i| <= atol + rtol |b_i| for all i. Elements which
+// are nan are never approximately equal.
+//
+template <typename E1, typename E2>
+bool approxEqual(const VectorExpression<E1>& e1, const VectorExpression<E2>& e2,
+                 const double atol, const double rtol = 0.)
+{
+    const E1& a = static_cast<const E1&>(e1);
+    const E2& b = static_cast<const E2&>(e2);
+
+    size_t N = size(a);
+    if (N != size(b))
+        throw std::runtime_error("Incompatible vector lengths " + std::to_string(N)
+                                 + " " + std::to_string(size(b)) + "(approxEqual) !");
+
+    // scan the indices, so that the predicate can see both vectors
+    struct Indices
+    {
+        using value_type = Common_type<typename E1::value_type, typename E2::value_type>;
+        size_t operator()(size_t i) const { return i; }
+    };
+
+    auto differ = [&a, &b, atol, rtol](const size_t i)
+    {
+        using std::abs;
+        return !(abs(a(i) - b(i)) <= atol + rtol * abs(b(i))) || impl::is_nan(a(i)) || impl::is_nan(b(i));
+    };
+
+    return impl::parallel_find(Indices(), differ, N) == N;
+}
+
+#endif
@@ -0,0 +1,264 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  File Name:  DynamicVectorScan.h                                           //
+//                                                                            //
+//     Author:  Andreas Buttenschoen <andreas@buttenschoen.ca>                //
+//    Created:  2026-10-18 19:42:10                                           //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CS_VECTOR_SCAN_H
+#define CS_VECTOR_SCAN_H
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+#include "DynamicVector.h"
+
+//
+// Parallel prefix sums, e.g. to build the row pointers of a CSR matrix
+//
+//      exclusiveScan(nnz, rowptr);
+//
+// The vector is split into one chunk per thread, and the scan takes two passes:
+//
+//  1. each thread reduces its chunk;
+//  2. the chunk totals are scanned serially, and each thread scans its chunk
+//     starting from the total of the chunks before it.
+//
+// For sums each packet is scanned in registers with log2(VECTOR_SIZE) shifted
+// additions, and the running total is carried from packet to packet in a
+// broadcast packet. Other operators must be associative and are applied
+// element by element. The output may be the input vector.
+//
+// Note that for floating point the sums are associated differently than in
+// std::partial_sum, so the results agree only up to rounding.
+//
+namespace impl {
+
+// the number of chunks, such that each holds at least one packet, as
+// reduce_chunk can't take an empty one
+template <class T>
+inline size_t scan_chunks(size_t N)
+{
+    constexpr size_t VECTOR_SIZE = __alignment / sizeof(T);
+    return std::min(Tuning::chunks(), N / VECTOR_SIZE);
+}
+
+// Element by element scan of [begin, end) starting from carry, in and out
+// may alias
+template <bool Exclusive, class T, class Op>
+T scan_serial(const T * in, T * out, size_t begin, size_t end, T carry, Op op)
+{
+    for (size_t i = begin; i < end; ++i)
+    {
+        const T x = in[i];
+        if (Exclusive)
+        {
+            out[i] = carry;
+            carry  = op(carry, x);
+        }
+        else
+        {
+            carry  = op(carry, x);
+            out[i] = carry;
+        }
+    }
+
+    return carry;
+}
+
+// Packet scan of the sum over [begin, end) starting from carry, where begin
+// is on a packet boundary. in and out may alias.
+template <bool Exclusive, class T>
+T scan_packet_sum(const T * in, T * out, size_t begin, size_t end, T carry)
+{
+    constexpr size_t VECTOR_SIZE = __alignment / sizeof(T);
+
+    using Index = std::conditional_t<sizeof(T) == 8, int64_t, int32_t>;
+    typedef T vec __attribute__((vector_size (sizeof(T) * VECTOR_SIZE)));
+    typedef Index ivec __attribute__((vector_size (sizeof(T) * VECTOR_SIZE)));
+
+    // shift[k] moves lane i to lane i + 2^k, indices >= VECTOR_SIZE select
+    // from the zero packet
+    ivec shift[8];
+    ivec last;
+    size_t no_shifts = 0;
+    for (size_t s = 1; s < VECTOR_SIZE; s *= 2, ++no_shifts)
+        for (size_t i = 0; i < VECTOR_SIZE; ++i)
+            shift[no_shifts][i] = Index(i >= s ? i - s : VECTOR_SIZE);
+
+    for (size_t i = 0; i < VECTOR_SIZE; ++i)
+        last[i] = Index(VECTOR_SIZE - 1);
+
+    const vec zero = {0};
+    vec vcarry = zero + carry;
+
+    const size_t NO_PACKETS = (end - begin) / VECTOR_SIZE;
+    const vec * Av = (const vec *) (in + begin);
+    vec * Bv = (vec *) (out + begin);
+
+    for (size_t p = 0; p < NO_PACKETS; ++p)
+    {
+        vec x = Av[p];
+
+        // in register inclusive prefix sum
+        vec local = x;
+        for (size_t k = 0; k < no_shifts; ++k)
+            local += __builtin_shuffle(local, zero, shift[k]);
+
+        if (Exclusive)
+            Bv[p] = vcarry + __builtin_shuffle(local, zero, shift[0]);
+        else
+            Bv[p] = vcarry + local;
+
+        vcarry += __builtin_shuffle(local, last);
+    }
+
+    return scan_serial<Exclusive>(in, out, begin + NO_PACKETS * VECTOR_SIZE, end, vcarry[0], std::plus<T>());
+}
+
+template <class T, class Op>
+constexpr bool is_packet_sum()
+{
+    return std::is_same<Op, std::plus<T> >::value && Arithmetic<T>()
+        && (sizeof(T) == 4 || sizeof(T) == 8);
+}
+
+template <bool Exclusive, class T, class Op>
+T scan_chunk(const T * in, T * out, size_t begin, size_t end, T carry, Op op)
+{
+    if constexpr (is_packet_sum<T, Op>())
+        return scan_packet_sum<Exclusive>(in, out, begin, end, carry);
+    else
+        return scan_serial<Exclusive>(in, out, begin, end, carry, op);
+}
+
+// the total of [begin, end), which must not be empty
+template <class T, class Op>
+T reduce_chunk(const T * __restrict__ in, size_t begin, size_t end, Op op)
+{
+    if constexpr (is_packet_sum<T, Op>())
+    {
+        T total = T(0);
+        #pragma omp simd reduction(+:total)
+        for (size_t i = begin; i < end; ++i)
+            total += in[i];
+        return total;
+    }
+    else
+    {
+        T total = in[begin];
+        for (size_t i = begin + 1; i < end; ++i)
+            total = op(total, in[i]);
+        return total;
+    }
+}
+
+// Exclusive: out[i] = init op in[0] op ... op in[i-1]
+// Inclusive: out[i] = in[0] op ... op in[i], init is not used
+template <bool Exclusive, class T, class Op>
+void parallel_scan(const CSVector<T>& in, CSVector<T>& out, T init, Op op)
+{
+    const size_t N = in.size();
+    if (out.size() != N)
+        out.resize(N);
+
+    if (N == 0)
+        return;
+
+    const T * a = in.data();
+    T * b = out.data();
+
+    // inclusive sums start from zero, other inclusive scans from the first
+    // element
+    size_t first = 0;
+    if constexpr (!Exclusive)
+    {
+        if constexpr (is_packet_sum<T, Op>())
+            init = T(0);
+        else
+        {
+            init  = a[0];
+            b[0]  = a[0];
+            first = 1;
+        }
+    }
+
+    if (N < ReductionParallelThreshold)
+    {
+        if (first == 0)
+            scan_chunk<Exclusive>(a, b, 0, N, init, op);
+        else
+            scan_serial<Exclusive>(a, b, 1, N, init, op);
+        return;
+    }
+
+    const size_t Threads = scan_chunks<T>(N);
+    std::vector<T> carry(Threads);
+
+    #pragma omp parallel for num_threads(Threads)
+    for (size_t c = 1; c < Threads; ++c)
+        carry[c] = reduce_chunk(a, chunk_start<T>(c, Threads, N),
+                                chunk_start<T>(c + 1, Threads, N), op);
+
+    carry[0] = init;
+    const size_t end0 = chunk_start<T>(1, Threads, N);
+    if (first < end0)
+        carry[0] = op(init, reduce_chunk(a, first, end0, op));
+
+    // carry[c] is the total of everything before chunk c
+    T total = carry[0];
+    for (size_t c = 1; c < Threads; ++c)
+    {
+        T tmp    = carry[c];
+        carry[c] = total;
+        total    = op(total, tmp);
+    }
+    carry[0] = init;
+
+    #pragma omp parallel for num_threads(Threads)
+    for (size_t c = 0; c < Threads; ++c)
+    {
+        const size_t start = chunk_start<T>(c, Threads, N);
+        const size_t end   = chunk_start<T>(c + 1, Threads, N);
+
+        if (c == 0 && first == 1)
+            scan_serial<Exclusive>(a, b, 1, end, carry[0], op);
+        else
+            scan_chunk<Exclusive>(a, b, start, end, carry[c], op);
+    }
+}
+
+} // end namespace
+
+// out[i] = in[0] op in[1] op ... op in[i] for an associative op
+template <class T, class Op>
+void inclusiveScan(const CSVector<T>& in, CSVector<T>& out, Op op)
+{
+    impl::parallel_scan<false>(in, out, T(0), op);
+}
+
+template <class T>
+void inclusiveScan(const CSVector<T>& in, CSVector<T>& out)
+{
+    impl::parallel_scan<false>(in, out, T(0), std::plus<T>());
+}
+
+// out[i] = init op in[0] op ... op in[i-1] for an associative op
+template <class T, class Op>
+void exclusiveScan(const CSVector<T>& in, CSVector<T>& out, const T init, Op op)
+{
+    impl::parallel_scan<true>(in, out, init, op);
+}
+
+template <class T>
+void exclusiveScan(const CSVector<T>& in, CSVector<T>& out, const T init = T(0))
+{
+    impl::parallel_scan<true>(in, out, init, std::plus<T>());
+}
+
+#endif
@@ -0,0 +1,336 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  File Name:  DynamicVectorSort.h                                           //
+//                                                                            //
+//     Author:  Andreas Buttenschoen <andreas@buttenschoen.ca>                //
+//    Created:  2026-10-18 20:31:02                                           //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CS_VECTOR_SORT_H
+#define CS_VECTOR_SORT_H
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+#include "DynamicVector.h"
+
+//
+// Parallel sorting and selection on the storage of a CSVector.
+//
+// sort: each thread sorts one chunk with std::sort, and the sorted chunks are
+//       merged pairwise. Every merge is itself split between the threads along
+//       its merge path, i.e. the output is cut into equal pieces and binary
+//       search finds how many elements of each piece come from either input.
+//       The merges ping-pong between the vector and one scratch vector.
+//
+// select: the k-th smallest element. A sorted sample brackets the k-th element
+//       between two values; one parallel pass counts the elements below and
+//       inside the bracket, a second copies the bracket out, and only that
+//       short buffer is searched with std::nth_element.
+//
+// The key-value variants sort a permutation, so that payload vectors can be
+// reordered along with the keys.
+//
+namespace impl {
+
+// the number of elements of a among the first d elements of merge(a, b)
+template <class T, class Compare>
+size_t merge_path(const T * a, size_t na, const T * b, size_t nb, size_t d, Compare comp)
+{
+    size_t lo = (d > nb) ? d - nb : 0;
+    size_t hi = std::min(d, na);
+
+    while (lo < hi)
+    {
+        size_t i = (lo + hi) / 2;
+
+        // std::merge takes a[i] before b[d - i - 1] unless b[d - i - 1] < a[i]
+        if (!comp(b[d - i - 1], a[i]))
+            lo = i + 1;
+        else
+            hi = i;
+    }
+
+    return lo;
+}
+
+template <class T, class Compare>
+void parallel_merge(const T * a, size_t na, const T * b, size_t nb, T * out, Compare comp)
+{
+    const size_t Threads = Tuning::chunks();
+    const size_t N = na + nb;
+
+    if (N < ReductionParallelThreshold)
+    {
+        std::merge(a, a + na, b, b + nb, out, comp);
+        return;
+    }
+
+    #pragma omp parallel for num_threads(Threads)
+    for (size_t t = 0; t < Threads; ++t)
+    {
+        const size_t d0 = t * N / Threads;
+        const size_t d1 = (t + 1) * N / Threads;
+        const size_t i0 = merge_path(a, na, b, nb, d0, comp);
+        const size_t i1 = merge_path(a, na, b, nb, d1, comp);
+
+        std::merge(a + i0, a + i1, b + (d0 - i0), b + (d1 - i1), out + d0, comp);
+    }
+}
+
+template <class T>
+void parallel_copy(const T * __restrict__ src, T * __restrict__ dst, size_t N)
+{
+    const size_t Threads = Tuning::chunks();
+
+    #pragma omp parallel for num_threads(Threads)
+    for (size_t t = 0; t < Threads; ++t)
+        std::copy(src + t * N / Threads, src + (t + 1) * N / Threads, dst + t * N / Threads);
+}
+
+template <class T, class Compare>
+void parallel_sort(T * data, size_t N, Compare comp)
+{
+    const size_t Threads = Tuning::chunks();
+
+    if (N < ReductionParallelThreshold)
+    {
+        std::sort(data, data + N, comp);
+        return;
+    }
+
+    auto start = [N, Threads](size_t c) { return (c < Threads ? c : Threads) * N / Threads; };
+
+    #pragma omp parallel for num_threads(Threads)
+    for (size_t c = 0; c < Threads; ++c)
+        std::sort(data + start(c), data + start(c + 1), comp);
+
+    CSVector<T> buffer(N);
+    T * src = data;
+    T * dst = buffer.data();
+
+    for (size_t width = 1; width < Threads; width *= 2)
+    {
+        for (size_t c = 0; c < Threads; c += 2 * width)
+        {
+            const size_t s = start(c);
+            const size_t m = start(c + width);
+            const size_t e = start(c + 2 * width);
+            parallel_merge(src + s, m - s, src + m, e - m, dst + s, comp);
+        }
+
+        std::swap(src, dst);
+    }
+
+    if (src != data)
+        parallel_copy(src, data, N);
+}
+
+// per chunk counts of the elements below lo, and in [lo, hi]
+template <class T>
+void count_bracket(const T * a, size_t N, const T lo, const T hi,
+                   size_t * below, size_t * inside, size_t Threads)
+{
+    #pragma omp parallel for num_threads(Threads)
+    for (size_t c = 0; c < Threads; ++c)
+    {
+        size_t nb = 0, ni = 0;
+
+        #pragma omp simd reduction(+:nb, ni)
+        for (size_t i = c * N / Threads; i < (c + 1) * N / Threads; ++i)
+        {
+            nb += size_t(a[i] < lo);
+            ni += size_t(!(a[i] < lo) && !(hi < a[i]));
+        }
+
+        below[c]  = nb;
+        inside[c] = ni;
+    }
+}
+
+template <class T>
+T parallel_select(const T * a, size_t N, size_t k)
+{
+    const size_t Threads         = Tuning::chunks();
+    constexpr size_t SAMPLE_SIZE = 4096;
+
+    // the sample ranks around k which bracket the k-th element; with high
+    // probability the bracket holds a few thousandths of the data
+    constexpr size_t SAMPLE_MARGIN = 64;
+
+    if (N >= ReductionParallelThreshold)
+    {
+        T sample[SAMPLE_SIZE];
+        for (size_t i = 0; i < SAMPLE_SIZE; ++i)
+            sample[i] = a[(i * N) / SAMPLE_SIZE + (N / SAMPLE_SIZE) / 2];
+
+        std::sort(sample, sample + SAMPLE_SIZE);
+
+        const size_t r = k * SAMPLE_SIZE / N;
+        const T lo = sample[(r > SAMPLE_MARGIN) ? r - SAMPLE_MARGIN : 0];
+        const T hi = sample[std::min(r + SAMPLE_MARGIN, SAMPLE_SIZE - 1)];
+
+        std::vector<size_t> below(Threads), inside(Threads), offset(Threads);
+        count_bracket(a, N, lo, hi, below.data(), inside.data(), Threads);
+
+        size_t nbelow = 0, ninside = 0;
+        for (size_t c = 0; c < Threads; ++c)
+        {
+            offset[c] = ninside;
+            nbelow   += below[c];
+            ninside  += inside[c];
+        }
+
+        // otherwise the bracket missed k, or is too wide to be worth copying
+        if (nbelow <= k && k < nbelow + ninside && ninside < N / 8)
+        {
+            CSVector<T> buffer(ninside);
+            T * b = buffer.data();
+
+            #pragma omp parallel for num_threads(Threads)
+            for (size_t c = 0; c < Threads; ++c)
+            {
+                size_t j = offset[c];
+                for (size_t i = c * N / Threads; i < (c + 1) * N / Threads; ++i)
+                    if (!(a[i] < lo) && !(hi < a[i]))
+                        b[j++] = a[i];
+            }
+
+            std::nth_element(b, b + (k - nbelow), b + ninside);
+            return b[k - nbelow];
+        }
+    }
+
+    CSVector<T> buffer(N);
+    parallel_copy(a, buffer.data(), N);
+    std::nth_element(buffer.data(), buffer.data() + k, buffer.data() + N);
+    return buffer[k];
+}
+
+} // end namespace
+
+// Sorts v in place
+template <class T, class Compare = std::less<T> >
+void sort(CSVector<T>& v, Compare comp = Compare())
+{
+    impl::parallel_sort(v.data(), v.size(), comp);
+}
+
+// The permutation which sorts keys, i.e. keys[p[0]] <= keys[p[1]] <= ...
+// Equal keys keep their order.
+template <class T>
+CSVector<size_t> argsort(const CSVector<T>& keys)
+{
+    const size_t Threads = Tuning::profile().threads;
+    const size_t N = keys.size();
+
+    CSVector<size_t> p(N);
+
+    #pragma omp parallel for num_threads(Threads)
+    for (size_t i = 0; i < N; ++i)
+        p[i] = i;
+
+    const T * k = keys.data();
+    impl::parallel_sort(p.data(), N, [k](const size_t i, const size_t j)
+                        { return k[i] < k[j] || (!(k[j] < k[i]) && i < j); });
+
+    return p;
+}
+
+// Sorts keys in place and applies the same permutation to values
+template <class K, class V>
+void sortByKey(CSVector<K>& keys, CSVector<V>& values)
+{
+    const size_t Threads = Tuning::profile().threads;
+    const size_t N = keys.size();
+
+    if (N != values.size())
+        throw std::runtime_error("Incompatible vector lengths " + std::to_string(N)
+                                 + " " + std::to_string(values.size()) + "(sortByKey) !");
+
+    const CSVector<size_t> p = argsort(keys);
+    CSVector<K> sortedKeys(N);
+    CSVector<V> sortedValues(N);
+
+    #pragma omp parallel for num_threads(Threads)
+    for (size_t i = 0; i < N; ++i)
+    {
+        sortedKeys[i]   = keys[p[i]];
+        sortedValues[i] = values[p[i]];
+    }
+
+    keys.swap(sortedKeys);
+    values.swap(sortedValues);
+}
+
+// The k-th smallest element of v, i.e. v[k] after sorting. v is not modified.
+template <class T>
+T select(const CSVector<T>& v, size_t k)
+{
+    static_assert(Arithmetic<T>(), "select requires a real vector!");
+
+    if (k >= v.size())
+        throw std::runtime_error("Index " + std::to_string(k) + " out of range "
+                                 + std::to_string(v.size()) + "(select) !");
+
+    return impl::parallel_select(v.data(), v.size(), k);
+}
+
+//
+// As std::nth_element: rearranges v so that v[k] is the element which would
+// be there after sorting, no element before it is larger, and no element
+// after it is smaller. The elements are partitioned into those smaller, equal
+// and larger than v[k] in one parallel pass through a scratch vector.
+//
+template <class T>
+void nthElement(CSVector<T>& v, size_t k)
+{
+    const size_t Threads = Tuning::chunks();
+
+    const T pivot  = select(v, k);
+    const size_t N = v.size();
+    T * a = v.data();
+
+    std::vector<size_t> less(Threads), equal(Threads);
+    impl::count_bracket(a, N, pivot, pivot, less.data(), equal.data(), Threads);
+
+    size_t nless = 0, nequal = 0;
+    for (size_t c = 0; c < Threads; ++c)
+    {
+        nless  += less[c];
+        nequal += equal[c];
+    }
+
+    // the output offsets of each chunk in the three parts
+    std::vector<size_t> offset[3] = {std::vector<size_t>(Threads), std::vector<size_t>(Threads),
+                                     std::vector<size_t>(Threads)};
+    size_t o[3] = {0, nless, nless + nequal};
+    for (size_t c = 0; c < Threads; ++c)
+    {
+        const size_t size = (c + 1) * N / Threads - c * N / Threads;
+        offset[0][c] = o[0]; o[0] += less[c];
+        offset[1][c] = o[1]; o[1] += equal[c];
+        offset[2][c] = o[2]; o[2] += size - less[c] - equal[c];
+    }
+
+    CSVector<T> buffer(N);
+    T * b = buffer.data();
+
+    #pragma omp parallel for num_threads(Threads)
+    for (size_t c = 0; c < Threads; ++c)
+    {
+        size_t j[3] = {offset[0][c], offset[1][c], offset[2][c]};
+        for (size_t i = c * N / Threads; i < (c + 1) * N / Threads; ++i)
+        {
+            const size_t part = (a[i] < pivot) ? 0 : ((pivot < a[i]) ? 2 : 1);
+            b[j[part]++] = a[i];
+        }
+    }
+
+    v.swap(buffer);
+}
+
+#endif
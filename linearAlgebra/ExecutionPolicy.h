@@ -11,36 +11,81 @@
 #define CS_EXECUTION_POLICY_H
 
 #include <cstddef>
+#include <type_traits>
 #include "VectorTraits.h"
 #include "VectorOperations.h"
 
 #include "LoopUnroll.h"
+#include "StreamingStore.h"
+#include "TuningProfile.h"
+#include "Instrumentation.h"
+#include "Trace.h"
 #include "type_info.h"
 
 using namespace Expression;
 
+//
+// Writes the result with non-temporal stores, see StreamingStore.h. This is
+// only valid for plain assignments to a contiguous vector.
+//
+template <typename E1, typename E2, typename Functor, bool Vector = true>
+class StreamingExecutionPolicy
+{
+private:
+    using size_type  = typename E1::size_type;
+    using value_type = typename E1::value_type;
+
+    static_assert(impl::is_streamable<E1, Functor>::value, "Streaming stores require a plain assignment to a CSVector!");
+
+public:
+    void assign(E1& first, const E2& second)
+    {
+        size_type s = size(first);
+        if (s == 0)
+            return;
+
+        FASTVECTOR_INSTRUMENT(("stream, " + type_name<Functor>()), s, s * sizeof(value_type));
+
+        if constexpr (Vector)
+            impl::stream_generate(&first(0), s, [&second](size_type i) { return value_type(second(i)); });
+        else
+            impl::stream_fill(&first(0), value_type(second), s);
+    }
+};
+
+//
+// The number of threads and, for double and float, the unroll are taken from
+// the tuning profile (see TuningProfile.h). The unroll can be any of the block
+// sizes compiled in below, other values fall back to UnrollBlockSize.
+//
 template <typename E1, typename E2, typename Functor, bool Vector = true>
 class ParallelExecutionPolicy
 {
 private:
     // TODO!
-    using size_type = typename E1::size_type;
+    using size_type  = typename E1::size_type;
+    using value_type = typename E1::value_type;
 
     // get the block size based on the type of the assignee E1
-    static constexpr std::size_t BlockSize = UnrollBlockSize<typename E1::value_type>::value;
-    static constexpr std::size_t Threads   = UnrollThreads<typename E1::value_type>::value;
+    static constexpr std::size_t BlockSize = UnrollBlockSize<value_type>::value;
 
-public:
-    void assign(E1& first, const E2& second)
+    static constexpr bool Tunable = std::is_same<value_type, double>::value
+                                 || std::is_same<value_type, float>::value;
+
+    template <std::size_t Block>
+    void assign_blocked(E1& first, const E2& second, size_type s, std::size_t threads)
     {
-        size_type s = size(first), sb = s / BlockSize * BlockSize;
+        size_type sb = s / Block * Block;
 
-        #pragma omp parallel num_threads(Threads)
+        // nowait, so that each thread's trace event ends with its chunk
+        #pragma omp parallel num_threads(threads)
         {
-            #pragma omp for
-            for (size_type i = 0; i < sb; i+=BlockSize)
+            FASTVECTOR_TRACE((type_name<E2>()), s);
+
+            #pragma omp for nowait
+            for (size_type i = 0; i < sb; i+=Block)
             {
-                impl::unroll<0, BlockSize-1, Functor, Vector>::apply(first, second, i);
+                impl::unroll<0, Block-1, Functor, Vector>::apply(first, second, i);
             }
         }
 
@@ -51,6 +96,45 @@ public:
             }
         }
     }
+
+public:
+    void assign(E1& first, const E2& second)
+    {
+        size_type s = size(first);
+
+        // large destinations bypass the cache
+        if constexpr (impl::is_streamable<E1, Functor>::value)
+            if (impl::use_streaming_stores<value_type>(s))
+            {
+                StreamingExecutionPolicy<E1, E2, Functor, Vector>().assign(first, second);
+                return;
+            }
+
+        // compound assignments read the destination as well
+        FASTVECTOR_INSTRUMENT((type_name<Functor>()), s, (impl::is_assign<Functor>::value ? 1 : 2) * s * sizeof(value_type));
+
+        const std::size_t threads = Tuning::profile().threads;
+
+        if constexpr (Tunable)
+        {
+            switch (Tuning::blockSize<value_type>())
+            {
+                case 2:
+                    assign_blocked<2>(first, second, s, threads);
+                    return;
+                case 4:
+                    assign_blocked<4>(first, second, s, threads);
+                    return;
+                case 8:
+                    assign_blocked<8>(first, second, s, threads);
+                    return;
+                default:
+                    break;
+            }
+        }
+
+        assign_blocked<BlockSize>(first, second, s, threads);
+    }
 };
 
 template <typename E1, typename E2, typename Functor, bool Vector = true>
@@ -98,8 +182,30 @@ public:
     }
 };
 
-/// define the default policy
+//
+// For vectors with a length known at compile time (see StaticSize), such as
+// ConstantVector. The assignment is unrolled over all elements, so there is
+// no loop and no parallel region, and the elements can stay in registers.
+//
+template <typename E1, typename E2, typename Functor, bool Vector = true>
+class FixedExecutionPolicy
+{
+private:
+    static constexpr std::size_t N = StaticSize<E1>::value;
+
+    static_assert(N > 0, "The fixed execution policy requires a length known at compile time!");
+
+public:
+    inline void assign(E1& first, const E2& second)
+    {
+        impl::unroll<0, N-1, Functor, Vector>::apply(first, second, std::size_t(0));
+    }
+};
+
+/// define the default policy, vectors of a fixed length are never threaded
 template <typename E1, typename E2, typename Functor, bool Vector>
-using DefaultExecutionPolicy = ParallelExecutionPolicy<E1, E2, Functor, Vector>;
+using DefaultExecutionPolicy = typename std::conditional<(StaticSize<E1>::value > 0),
+                                                         FixedExecutionPolicy<E1, E2, Functor, Vector>,
+                                                         ParallelExecutionPolicy<E1, E2, Functor, Vector> >::type;
 
 #endif
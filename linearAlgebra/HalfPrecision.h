@@ -0,0 +1,446 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  File Name:  HalfPrecision.h                                               //
+//                                                                            //
+//     Author:  Andreas Buttenschoen <andreas@buttenschoen.ca>                //
+//    Created:  2026-10-18 10:12:31                                           //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef HALF_PRECISION_H
+#define HALF_PRECISION_H
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <type_traits>
+
+#if defined(__GNUC__)
+#include <x86intrin.h>
+#endif
+
+#include "DynamicVector.h"
+
+//
+// 16-bit storage types for CSVector. Neither type has any arithmetic of its
+// own; the elements are widened to float on load and narrowed on store. In
+// expressions this happens element-wise through the implicit conversions, the
+// bulk conversions (convert, the converting constructor and assignment, dot)
+// use F16C or AVX-512-BF16 where present and a scalar fallback otherwise.
+//
+// half: IEEE 754 binary16, 5 exponent bits, 10 mantissa bits.
+// bf16: bfloat16, the top 16 bits of a float i.e. 8 exponent bits, 7 mantissa
+//       bits. Same range as float at reduced precision.
+//
+namespace impl {
+
+inline uint32_t float_bits(float f)
+{
+    uint32_t u;
+    std::memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+inline float bits_float(uint32_t u)
+{
+    float f;
+    std::memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+// float -> binary16 with round to nearest even.
+inline uint16_t float_to_half_soft(float f)
+{
+    uint32_t x    = float_bits(f);
+    uint16_t sign = uint16_t((x >> 16) & 0x8000u);
+    uint32_t absx = x & 0x7fffffffu;
+
+    // inf or nan, keep nans quiet
+    if (absx >= 0x7f800000u)
+        return uint16_t(sign | 0x7c00u | (absx > 0x7f800000u ? 0x0200u | ((absx >> 13) & 0x3ffu) : 0u));
+
+    // overflows to inf
+    if (absx >= 0x477ff000u)
+        return uint16_t(sign | 0x7c00u);
+
+    // subnormal result, or underflow to zero
+    if (absx < 0x38800000u)
+    {
+        if (absx < 0x33000000u)
+            return sign;
+
+        uint32_t exponent = absx >> 23;
+        uint32_t mantissa = (absx & 0x7fffffu) | 0x800000u;
+        uint32_t shift    = 126 - exponent;
+
+        uint32_t result    = mantissa >> shift;
+        uint32_t remainder = mantissa & ((1u << shift) - 1);
+        uint32_t halfway   = 1u << (shift - 1);
+
+        if (remainder > halfway || (remainder == halfway && (result & 1u)))
+            ++result;
+
+        return uint16_t(sign | result);
+    }
+
+    // normal result, rebias the exponent and round the mantissa
+    uint32_t result = absx - 0x38000000u;
+    result += 0xfffu + ((result >> 13) & 1u);
+    return uint16_t(sign | (result >> 13));
+}
+
+// binary16 -> float, this is exact.
+inline float half_to_float_soft(uint16_t h)
+{
+    uint32_t sign     = uint32_t(h & 0x8000u) << 16;
+    uint32_t exponent = (h >> 10) & 0x1fu;
+    uint32_t mantissa = h & 0x3ffu;
+
+    if (exponent == 0x1fu)
+        return bits_float(sign | 0x7f800000u | (mantissa << 13));
+
+    if (exponent == 0)
+    {
+        if (mantissa == 0)
+            return bits_float(sign);
+
+        // subnormal, normalize it
+        exponent = 113;
+        while (!(mantissa & 0x400u))
+        {
+            mantissa <<= 1;
+            --exponent;
+        }
+
+        return bits_float(sign | (exponent << 23) | ((mantissa & 0x3ffu) << 13));
+    }
+
+    return bits_float(sign | ((exponent + 112) << 23) | (mantissa << 13));
+}
+
+inline uint16_t float_to_half(float f)
+{
+#if defined(__F16C__)
+    return uint16_t(_cvtss_sh(f, _MM_FROUND_TO_NEAREST_INT));
+#else
+    return float_to_half_soft(f);
+#endif
+}
+
+inline float half_to_float(uint16_t h)
+{
+#if defined(__F16C__)
+    return _cvtsh_ss(h);
+#else
+    return half_to_float_soft(h);
+#endif
+}
+
+// float -> bfloat16 with round to nearest even.
+inline uint16_t float_to_bf16(float f)
+{
+    uint32_t x = float_bits(f);
+
+    // truncating could turn a nan into an inf
+    if ((x & 0x7fffffffu) > 0x7f800000u)
+        return uint16_t((x >> 16) | 0x40u);
+
+    x += 0x7fffu + ((x >> 16) & 1u);
+    return uint16_t(x >> 16);
+}
+
+inline float bf16_to_float(uint16_t b)
+{
+    return bits_float(uint32_t(b) << 16);
+}
+
+} // end namespace
+
+struct half
+{
+    uint16_t bits;
+
+    half() = default;
+    half(float f) : bits(impl::float_to_half(f)) {}
+
+    static half from_bits(uint16_t b) { half h; h.bits = b; return h; }
+
+    operator float() const { return impl::half_to_float(bits); }
+
+    half& operator+=(float v) { return *this = float(*this) + v; }
+    half& operator-=(float v) { return *this = float(*this) - v; }
+    half& operator*=(float v) { return *this = float(*this) * v; }
+    half& operator/=(float v) { return *this = float(*this) / v; }
+};
+
+struct bf16
+{
+    uint16_t bits;
+
+    bf16() = default;
+    bf16(float f) : bits(impl::float_to_bf16(f)) {}
+
+    static bf16 from_bits(uint16_t b) { bf16 h; h.bits = b; return h; }
+
+    operator float() const { return impl::bf16_to_float(bits); }
+
+    bf16& operator+=(float v) { return *this = float(*this) + v; }
+    bf16& operator-=(float v) { return *this = float(*this) - v; }
+    bf16& operator*=(float v) { return *this = float(*this) * v; }
+    bf16& operator/=(float v) { return *this = float(*this) / v; }
+};
+
+static_assert(sizeof(half) == 2 && std::is_trivial<half>::value, "half must be a trivial 16-bit type!");
+static_assert(sizeof(bf16) == 2 && std::is_trivial<bf16>::value, "bf16 must be a trivial 16-bit type!");
+
+inline std::ostream& operator<<(std::ostream& os, const half& h)
+{
+    return os << float(h);
+}
+
+inline std::ostream& operator<<(std::ostream& os, const bf16& h)
+{
+    return os << float(h);
+}
+
+namespace Expression {
+
+template <>
+    struct Compute<half>
+    {
+        using type = float;
+    };
+
+template <>
+    struct Compute<bf16>
+    {
+        using type = float;
+    };
+
+template <>
+    struct Accumulate<half>
+    {
+        using type = float;
+    };
+
+template <>
+    struct Accumulate<bf16>
+    {
+        using type = float;
+    };
+
+} // end namespace
+
+//
+// Expressions involving the storage types are evaluated in float (or the wider
+// of float and the other type).
+//
+namespace std {
+
+template <>
+    struct common_type<half, half> { using type = float; };
+
+template <>
+    struct common_type<bf16, bf16> { using type = float; };
+
+template <>
+    struct common_type<half, bf16> { using type = float; };
+
+template <>
+    struct common_type<bf16, half> { using type = float; };
+
+template <typename T>
+    struct common_type<half, T> : common_type<float, T> {};
+
+template <typename T>
+    struct common_type<T, half> : common_type<T, float> {};
+
+template <typename T>
+    struct common_type<bf16, T> : common_type<float, T> {};
+
+template <typename T>
+    struct common_type<T, bf16> : common_type<T, float> {};
+
+} // end namespace std
+
+namespace impl {
+
+// Bulk widening and narrowing. These convert n elements, where the pointers
+// are aligned as in a CSVector.
+inline void widen(float * __restrict__ dst, const half * __restrict__ src, size_t n)
+{
+    size_t i = 0;
+#if defined(__F16C__)
+    for (; i + 8 <= n; i += 8)
+    {
+        __m128i h = _mm_load_si128((const __m128i *)(src + i));
+        _mm256_store_ps(dst + i, _mm256_cvtph_ps(h));
+    }
+#endif
+
+    // deal with left overs
+    for (; i < n; i++)
+        dst[i] = float(src[i]);
+}
+
+inline void narrow(half * __restrict__ dst, const float * __restrict__ src, size_t n)
+{
+    size_t i = 0;
+#if defined(__F16C__)
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256 f = _mm256_load_ps(src + i);
+        _mm_store_si128((__m128i *)(dst + i), _mm256_cvtps_ph(f, _MM_FROUND_TO_NEAREST_INT));
+    }
+#endif
+
+    // deal with left overs
+    for (; i < n; i++)
+        dst[i] = half(src[i]);
+}
+
+inline void widen(float * __restrict__ dst, const bf16 * __restrict__ src, size_t n)
+{
+    // widening is a shift, which gcc vectorizes on its own
+    const uint16_t * __restrict__ s = (const uint16_t *) src;
+    uint32_t * __restrict__ d = (uint32_t *) dst;
+
+    #pragma omp simd
+    for (size_t i = 0; i < n; i++)
+        d[i] = uint32_t(s[i]) << 16;
+}
+
+inline void narrow(bf16 * __restrict__ dst, const float * __restrict__ src, size_t n)
+{
+    size_t i = 0;
+#if defined(__AVX512BF16__) && defined(__AVX512F__)
+    for (; i + 16 <= n; i += 16)
+    {
+        __m512 f = _mm512_loadu_ps(src + i);
+        __m256bh b = _mm512_cvtneps_pbh(f);
+        _mm256_storeu_si256((__m256i *)(dst + i), (__m256i) b);
+    }
+#endif
+
+    // deal with left overs
+    for (; i < n; i++)
+        dst[i] = bf16(src[i]);
+}
+
+// Conversions between a storage type and an arithmetic type go through float
+// in blocks which stay in L1.
+template <class Storage, class To>
+struct widening_converter
+{
+    static inline void apply(To * __restrict__ dst, const Storage * __restrict__ src, size_t n)
+    {
+        if constexpr (Same<To, float>())
+            widen(dst, src, n);
+        else
+        {
+            constexpr size_t BLOCK_SIZE = 512;
+            alignas(__alignment) float buffer[BLOCK_SIZE];
+
+            for (size_t start = 0; start < n; start += BLOCK_SIZE)
+            {
+                size_t m = std::min(BLOCK_SIZE, n - start);
+                widen(buffer, src + start, m);
+                converter<To, float>::apply(dst + start, buffer, m);
+            }
+        }
+    }
+};
+
+template <class Storage, class From>
+struct narrowing_converter
+{
+    static inline void apply(Storage * __restrict__ dst, const From * __restrict__ src, size_t n)
+    {
+        if constexpr (Same<From, float>())
+            narrow(dst, src, n);
+        else
+        {
+            constexpr size_t BLOCK_SIZE = 512;
+            alignas(__alignment) float buffer[BLOCK_SIZE];
+
+            for (size_t start = 0; start < n; start += BLOCK_SIZE)
+            {
+                size_t m = std::min(BLOCK_SIZE, n - start);
+                converter<float, From>::apply(buffer, src + start, m);
+                narrow(dst + start, buffer, m);
+            }
+        }
+    }
+};
+
+template <class To> struct converter<To, half> : widening_converter<half, To> {};
+template <class To> struct converter<To, bf16> : widening_converter<bf16, To> {};
+
+template <class From> struct converter<half, From> : narrowing_converter<half, From> {};
+template <class From> struct converter<bf16, From> : narrowing_converter<bf16, From> {};
+
+// between the two storage types
+template <>
+struct converter<half, bf16>
+{
+    static inline void apply(half * __restrict__ dst, const bf16 * __restrict__ src, size_t n)
+    {
+        narrowing_converter<half, bf16>::apply(dst, src, n);
+    }
+};
+
+template <>
+struct converter<bf16, half>
+{
+    static inline void apply(bf16 * __restrict__ dst, const half * __restrict__ src, size_t n)
+    {
+        narrowing_converter<bf16, half>::apply(dst, src, n);
+    }
+};
+
+} // end namespace
+
+//
+// max, min and supNorm widen blocks into a buffer on the stack, as dot does,
+// and reduce the buffers with the packet kernels of argmax, argmin and iamax.
+// The result is one of the elements (or its absolute value), so narrowing it
+// back is exact.
+//
+namespace impl {
+
+template <class Select, class T>
+T blocked_extremum(const CSVector<T>& lhs, const char * name)
+{
+    const size_t N = lhs.size();
+    if (N == 0)
+        throw std::runtime_error("Zero length vector!");
+
+    FASTVECTOR_INSTRUMENT((std::string(name) + ", " + type_name<T>()), N, N * sizeof(T));
+
+    constexpr size_t BLOCK_SIZE = 512;
+    alignas(__alignment) float buffer[BLOCK_SIZE];
+
+    float res = 0.f;
+    for (size_t start = 0; start < N; start += BLOCK_SIZE)
+    {
+        size_t n = std::min(BLOCK_SIZE, N - start);
+        converter<float, T>::apply(buffer, lhs.data() + start, n);
+
+        const float x = packet_arg_extremum<Select>(buffer, 0, n).first;
+        if (start == 0 || Select::better(x, res))
+            res = x;
+    }
+
+    return T(res);
+}
+
+} // end namespace
+
+inline half max(const CSVector<half>& lhs)    { return impl::blocked_extremum<impl::argmax_select>(lhs, "max"); }
+inline bf16 max(const CSVector<bf16>& lhs)    { return impl::blocked_extremum<impl::argmax_select>(lhs, "max"); }
+inline half min(const CSVector<half>& lhs)    { return impl::blocked_extremum<impl::argmin_select>(lhs, "min"); }
+inline bf16 min(const CSVector<bf16>& lhs)    { return impl::blocked_extremum<impl::argmin_select>(lhs, "min"); }
+inline half supNorm(const CSVector<half>& lhs) { return impl::blocked_extremum<impl::iamax_select>(lhs, "supNorm"); }
+inline bf16 supNorm(const CSVector<bf16>& lhs) { return impl::blocked_extremum<impl::iamax_select>(lhs, "supNorm"); }
+
+#endif
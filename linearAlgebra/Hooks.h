@@ -0,0 +1,72 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  File Name:  Hooks.h                                                       //
+//                                                                            //
+//     Author:  Andreas Buttenschoen <andreas@buttenschoen.ca>                //
+//    Created:  2026-10-19 10:12:37                                           //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CS_HOOKS_H
+#define CS_HOOKS_H
+
+//
+// The pieces shared by the kernel hooks of Instrumentation.h and Trace.h: the
+// registry of their labels, the escaping of the labels in the JSON output, and
+// the macro naming the variables of a hook after its line.
+//
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Hooks {
+
+// Each distinct label gets the next id, the ids are never reused
+class LabelRegistry
+{
+public:
+    // the id of label, registering it on first use
+    std::size_t id(const std::string& label)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        for (std::size_t i = 0; i < labels.size(); ++i)
+            if (labels[i] == label)
+                return i;
+
+        labels.push_back(label);
+        return labels.size() - 1;
+    }
+
+    std::string label(const std::size_t id) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return labels[id];
+    }
+
+private:
+    mutable std::mutex       mutex;
+    std::vector<std::string> labels;
+};
+
+inline std::string json_escape(const std::string& s)
+{
+    std::string escaped;
+    for (const char c : s)
+    {
+        if (c == '"' || c == '\\')
+            escaped += '\\';
+        escaped += c;
+    }
+
+    return escaped;
+}
+
+} // end namespace
+
+#define FASTVECTOR_CONCAT_(a, b) a##b
+#define FASTVECTOR_CONCAT(a, b) FASTVECTOR_CONCAT_(a, b)
+
+#endif
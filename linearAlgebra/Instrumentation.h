@@ -0,0 +1,356 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  File Name:  Instrumentation.h                                             //
+//                                                                            //
+//     Author:  Andreas Buttenschoen <andreas@buttenschoen.ca>                //
+//    Created:  2026-10-19 01:04:51                                           //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CS_INSTRUMENTATION_H
+#define CS_INSTRUMENTATION_H
+
+//
+// Per kernel counters: calls, elements, bytes and elapsed cycles (TSC).
+//
+// Compile with FASTVECTOR_INSTRUMENTATION defined to enable them. Otherwise
+// FASTVECTOR_INSTRUMENT expands to nothing and its arguments are never
+// evaluated.
+//
+// A hook is placed at the top of a kernel:
+//
+//      FASTVECTOR_INSTRUMENT((type_name<Functor, T>()), n, n * sizeof(T));
+//
+// The label is parenthesised, as it may contain commas. It is computed once
+// per instantiation. The counters are summed in a table of the calling
+// thread, so recording takes no lock; the kernels are timed as a whole on
+// the calling thread, including their parallel region. The bytes are those
+// of the destination and of the operands the kernel knows about, i.e. not
+// the leaves of an expression.
+//
+// The totals are read with Instrumentation::snapshot(), printed with
+// report(), and written as JSON by dump(). If FASTVECTOR_INSTRUMENTATION_FILE
+// is set, the JSON is written to that file at exit.
+//
+
+#ifdef FASTVECTOR_INSTRUMENTATION
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+#include "Hooks.h"
+#include "type_info.h"
+
+namespace Instrumentation {
+
+// the number of distinct labels which can be recorded
+static constexpr std::size_t MaxKernels = 1024;
+
+inline std::uint64_t ticks()
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+struct Record
+{
+    std::string   label;
+    std::uint64_t calls    = 0;
+    std::uint64_t elements = 0;
+    std::uint64_t bytes    = 0;
+    std::uint64_t cycles   = 0;
+};
+
+// Only the owning thread writes its counters, others may read them
+struct Counters
+{
+    std::atomic<std::uint64_t> calls{0}, elements{0}, bytes{0}, cycles{0};
+
+    static inline void add(std::atomic<std::uint64_t>& counter, std::uint64_t value)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+};
+
+class ThreadTable;
+
+class Registry
+{
+public:
+    // the id of label, registering it on first use
+    std::size_t id(const std::string& label)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        const std::size_t i = labels.id(label);
+        if (i == retired.size())
+            retired.emplace_back();
+        return i;
+    }
+
+    void attach(ThreadTable * table)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tables.push_back(table);
+    }
+
+    inline void detach(ThreadTable * table);
+
+    inline std::vector<Record> snapshot();
+
+    inline void reset();
+
+private:
+    std::mutex                 mutex;
+    Hooks::LabelRegistry       labels;
+    std::vector<ThreadTable *> tables;
+
+    // the totals of the threads which have exited
+    std::vector<Record>        retired;
+};
+
+// never destroyed, so that threads exiting late can still detach
+inline Registry& registry()
+{
+    static Registry * instance = new Registry;
+    return *instance;
+}
+
+class ThreadTable
+{
+public:
+    ThreadTable()
+        : counters(new Counters[MaxKernels])
+    {
+        registry().attach(this);
+    }
+
+    ~ThreadTable()
+    {
+        registry().detach(this);
+    }
+
+    inline void add(std::size_t id, std::uint64_t elements, std::uint64_t bytes, std::uint64_t cycles)
+    {
+        if (id >= MaxKernels)
+            return;
+
+        Counters& c = counters[id];
+        Counters::add(c.calls, 1);
+        Counters::add(c.elements, elements);
+        Counters::add(c.bytes, bytes);
+        Counters::add(c.cycles, cycles);
+    }
+
+    // adds this thread's counters to records
+    void collect(std::vector<Record>& records) const
+    {
+        for (std::size_t i = 0; i < records.size() && i < MaxKernels; ++i)
+        {
+            records[i].calls    += counters[i].calls.load(std::memory_order_relaxed);
+            records[i].elements += counters[i].elements.load(std::memory_order_relaxed);
+            records[i].bytes    += counters[i].bytes.load(std::memory_order_relaxed);
+            records[i].cycles   += counters[i].cycles.load(std::memory_order_relaxed);
+        }
+    }
+
+    void clear()
+    {
+        for (std::size_t i = 0; i < MaxKernels; ++i)
+        {
+            counters[i].calls.store(0, std::memory_order_relaxed);
+            counters[i].elements.store(0, std::memory_order_relaxed);
+            counters[i].bytes.store(0, std::memory_order_relaxed);
+            counters[i].cycles.store(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    std::unique_ptr<Counters[]> counters;
+};
+
+inline void Registry::detach(ThreadTable * table)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    table->collect(retired);
+    for (std::size_t i = 0; i < tables.size(); ++i)
+        if (tables[i] == table)
+        {
+            tables.erase(tables.begin() + i);
+            break;
+        }
+}
+
+inline std::vector<Record> Registry::snapshot()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::vector<Record> records = retired;
+    for (std::size_t i = 0; i < records.size(); ++i)
+        records[i].label = labels.label(i);
+
+    for (const ThreadTable * table : tables)
+        table->collect(records);
+
+    return records;
+}
+
+// Counters recorded concurrently with a reset may survive it
+inline void Registry::reset()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    for (ThreadTable * table : tables)
+        table->clear();
+
+    for (Record& record : retired)
+        record = Record();
+}
+
+inline ThreadTable& thread_table()
+{
+    thread_local ThreadTable table;
+    return table;
+}
+
+// Times its own lifetime, and adds it to the counters of id
+class Scope
+{
+public:
+    Scope(std::size_t id, std::uint64_t elements, std::uint64_t bytes)
+        : id(id), elements(elements), bytes(bytes), start(ticks())
+    {}
+
+    ~Scope()
+    {
+        const std::uint64_t stop = ticks();
+        thread_table().add(id, elements, bytes, stop - start);
+    }
+
+private:
+    std::size_t   id;
+    std::uint64_t elements;
+    std::uint64_t bytes;
+    std::uint64_t start;
+};
+
+// The totals over all threads of the kernels called at least once
+inline std::vector<Record> snapshot()
+{
+    std::vector<Record> records = registry().snapshot();
+
+    std::vector<Record> called;
+    for (Record& record : records)
+        if (record.calls)
+            called.push_back(std::move(record));
+
+    return called;
+}
+
+inline void reset()
+{
+    registry().reset();
+}
+
+inline void report(std::ostream& os)
+{
+    os << std::left << std::setw(60) << "kernel" << std::right
+       << std::setw(12) << "calls" << std::setw(16) << "elements"
+       << std::setw(16) << "bytes" << std::setw(18) << "cycles"
+       << std::setw(14) << "cycles/elem" << std::endl;
+
+    for (const Record& r : snapshot())
+        os << std::left << std::setw(60) << r.label << std::right
+           << std::setw(12) << r.calls << std::setw(16) << r.elements
+           << std::setw(16) << r.bytes << std::setw(18) << r.cycles
+           << std::setw(14) << std::setprecision(3)
+           << (r.elements ? double(r.cycles) / double(r.elements) : 0.) << std::endl;
+}
+
+inline void dump(std::ostream& os)
+{
+    const std::vector<Record> records = snapshot();
+
+    os << "{\"kernels\": [";
+    for (std::size_t i = 0; i < records.size(); ++i)
+    {
+        const Record& r = records[i];
+        os << (i ? ",\n  " : "\n  ")
+           << "{\"label\": \"" << Hooks::json_escape(r.label) << "\""
+           << ", \"calls\": " << r.calls
+           << ", \"elements\": " << r.elements
+           << ", \"bytes\": " << r.bytes
+           << ", \"cycles\": " << r.cycles << "}";
+    }
+    os << "\n]}" << std::endl;
+}
+
+inline bool dump(const std::string& filename)
+{
+    std::ofstream out(filename);
+    if (!out)
+        return false;
+
+    dump(out);
+    return bool(out);
+}
+
+// writes the JSON to FASTVECTOR_INSTRUMENTATION_FILE at exit
+struct ExitDump
+{
+    ~ExitDump()
+    {
+        if (const char * filename = std::getenv("FASTVECTOR_INSTRUMENTATION_FILE"))
+            if (!dump(filename))
+                std::cerr << "Could not write " << filename << "!" << std::endl;
+    }
+};
+
+inline ExitDump& exit_dump()
+{
+    static ExitDump instance;
+    return instance;
+}
+
+// the id of a label, which is registered once per call site
+inline std::size_t label_id(const std::string& label)
+{
+    exit_dump();
+    return registry().id(label);
+}
+
+} // end namespace
+
+#define FASTVECTOR_INSTRUMENT(label, elements, bytes)                                       \
+    static const std::size_t FASTVECTOR_CONCAT(instrument_id_, __LINE__)                    \
+        = ::Instrumentation::label_id(label);                                               \
+    ::Instrumentation::Scope FASTVECTOR_CONCAT(instrument_scope_, __LINE__)                 \
+        (FASTVECTOR_CONCAT(instrument_id_, __LINE__), (elements), (bytes))
+
+#else
+
+#define FASTVECTOR_INSTRUMENT(label, elements, bytes)
+
+#endif
+
+#endif
@@ -21,10 +21,12 @@
 #include <utility>
 #include <initializer_list>
 #include <stdexcept>
+#include <type_traits>
 
 #include "../concepts/concepts.h"
 #include "../utils/macros.h"
 #include "vector_detail.h"
+#include "vector_packet.h"
 
 using namespace std::placeholders;
 
@@ -166,14 +168,14 @@ public:
     MatrixBase& operator*=(const T& scalar)
     {
         std::transform(begin(), end(), begin(),
-                       std::bind1st(std::multiplies<T>(), scalar));
+                       [scalar](const T value) { return scalar * value; });
         return *this;
     }
 
     MatrixBase& operator/=(const T& scalar)
     {
         std::transform(begin(), end(), begin(),
-                       std::bind2nd(std::divides<T>(), scalar));
+                       [scalar](const T value) { return value / scalar; });
         return *this;
     }
 
@@ -345,67 +347,65 @@ void swap(MatrixBase<Derived, T, N, M>& lhs, MatrixBase<Derived, T, N, M>& rhs)
     lhs.swap(rhs);
 }
 
+// The fixed size matrices, stored row major. They are meant for the small
+// matrices of the per element kernels: the loops of the products and
+// factorizations below have compile time bounds, and are unrolled by the
+// compiler.
 template <typename T, std::size_t N, std::size_t M>
 class Matrix : public MatrixBase<Matrix<T, N, M>, T, N, M>
 {
 public:
+    static_assert(N <= 8 && M <= 8, "Matrix is limited to 8 rows and columns!");
+
     using MatrixBase<Matrix, T, N, M>::MatrixBase;
-    using MatrixBase<Matrix<T, 3, 3>, T, 3, 3>::ORDER;
+    using MatrixBase<Matrix, T, N, M>::ORDER;
 
     // constructors
     Matrix()
-        : MatrixBase<Matrix<T, 3, 3>, T, 3, 3>()
-    {}
-
-    Matrix(T (&data)[2])
-        : MatrixBase<Matrix<T, 3, 3>, T, 3, 3>(data)
+        : MatrixBase<Matrix, T, N, M>()
     {}
 
-    Matrix(const Matrix& vector)
-        : MatrixBase<Matrix<T, 3, 3>, T, 3, 3>(vector)
+    Matrix(const Matrix& matrix)
+        : MatrixBase<Matrix, T, N, M>(matrix)
     {}
 
-    Matrix(Matrix&& vector)
-        : MatrixBase<Matrix<T, 3, 3>, T, 3, 3>(vector)
+    Matrix(Matrix&& matrix)
+        : MatrixBase<Matrix, T, N, M>(matrix)
     {}
 
     explicit Matrix(const T value)
-        : MatrixBase<Matrix<T, 3, 3>, T, 3, 3>(value)
+        : MatrixBase<Matrix, T, N, M>(value)
     {}
 
     Matrix(Matrix_initializer<T, ORDER> values)
-        : MatrixBase<Matrix<T, 3, 3>, T, 3, 3>(values)
+        : MatrixBase<Matrix, T, N, M>(values)
     {}
 
-    Matrix& operator=(const Matrix& vector)
+    Matrix& operator=(const Matrix& matrix)
     {
-        MatrixBase<Matrix<T, 3, 3>, T, 3, 3>::operator = (vector);
+        MatrixBase<Matrix, T, N, M>::operator = (matrix);
         return *this;
     }
 
-    Matrix& operator=(Matrix&& vector)
+    Matrix& operator=(Matrix&& matrix)
     {
-        MatrixBase<Matrix<T, 3, 3>, T, 3, 3>::operator = (vector);
+        MatrixBase<Matrix, T, N, M>::operator = (matrix);
         return *this;
     }
 
     Matrix& operator=(const T value)
     {
-        MatrixBase<Matrix<T, 3, 3>, T, 3, 3>::operator = (value);
+        MatrixBase<Matrix, T, N, M>::operator = (value);
         return *this;
     }
 
-    //Matrix(T _x, T _y)
-    //    : x(_x), y(_y)
-    //{}
-
     ~Matrix() {}
 
     T data[N * M];
 
     std::size_t index(const std::size_t i, const std::size_t j) const
     {
-        return (i * N + j);
+        return (i * M + j);
     }
 
     T* begin() { return std::begin(data); }
@@ -608,25 +608,59 @@ Matrix<T, 3, 3> Matrix<T, 3, 3>::scale(T fx, T fy, T fz)
             {0.0, 0.0,  fz}};
 }
 
+// The symmetric matrices keep the upper triangle, row by row
 template <typename T, std::size_t N>
 class SymmetricMatrix : public MatrixBase<SymmetricMatrix<T, N>, T, N, N>
 {
 public:
+    static constexpr std::size_t PACKED_SIZE = N * (N + 1) / 2;
+
     using MatrixBase<SymmetricMatrix, T, N, N>::MatrixBase;
 
     SymmetricMatrix()
         : MatrixBase<SymmetricMatrix, T, N, N>()
     {}
 
+    // from the full rows, of which the upper triangle is kept
+    SymmetricMatrix(Matrix_initializer<T, 2> rows)
+        : SymmetricMatrix()
+    {
+        ASSERT(rows.size() <= N, "Initializer list with size " +
+               std::to_string(rows.size()) + " is larger than the container" +
+               " size " + std::to_string(N) + ".");
+
+        std::size_t i = 0;
+        for (const auto& row : rows)
+        {
+            std::size_t j = 0;
+            for (const T value : row)
+            {
+                if (i <= j && j < N)
+                    this->get(i, j) = value;
+                ++j;
+            }
+            ++i;
+        }
+    }
+
     std::size_t index(const std::size_t i, const std::size_t j) const
     {
         return (i <= j) ? offset(i, j) : offset(j, i);
     }
 
+    T* begin() { return std::begin(data); }
+    const T* begin() const { return std::begin(data); }
+
+    T* end() { return std::end(data); }
+    const T* end() const { return std::end(data); }
+
+    constexpr std::size_t size() const { return PACKED_SIZE; }
+    std::size_t memory_size() const { return sizeof(*this); }
+
     // DATA
     union {
-        T data[6];
-        struct {T xx, xy, xz, yx, yy, zz; };
+        T data[PACKED_SIZE];
+        struct {T xx, xy, xz, yy, yz, zz; };
         // Add vectors
     };
 
@@ -648,38 +682,345 @@ T trace(const MatrixBase<Derived, T, N, N>& matrix)
 }
 
 template <typename Derived, typename T, std::size_t N, std::size_t M>
-MatrixBase<Derived, T, N, M>
-operator*(const MatrixBase<Derived, T, N, M>& m, const T factor)
+Matrix<T, M, N> transpose(const MatrixBase<Derived, T, N, M>& m)
+{
+    Matrix<T, M, N> ret;
+    for (std::size_t i = 0; i < N; ++i)
+        for (std::size_t j = 0; j < M; ++j)
+            ret(j, i) = m(i, j);
+    return ret;
+}
+
+//
+// LU decomposition with partial pivoting, P A = L U. The unit lower triangle
+// L and the upper triangle U share one matrix.
+//
+template <typename T, std::size_t N>
+class LU
+{
+public:
+    template <typename Derived>
+    explicit LU(const MatrixBase<Derived, T, N, N>& matrix);
+
+    ConstantVector<T, N> solve(const ConstantVector<T, N>& b) const;
+
+    Matrix<T, N, N> inverse() const;
+
+    T determinant() const
+    {
+        T det = T(sign);
+        for (std::size_t i = 0; i < N; ++i)
+            det *= lu(i, i);
+        return det;
+    }
+
+    bool singular() const { return is_singular; }
+
+    const Matrix<T, N, N>& matrix() const { return lu; }
+
+    // row i of P A is row permutation(i) of A
+    std::size_t permutation(const std::size_t i) const { return perm[i]; }
+
+private:
+    Matrix<T, N, N> lu;
+    std::size_t perm[N];
+    int sign {1};
+    bool is_singular {false};
+};
+
+template <typename T, std::size_t N>
+template <typename Derived>
+LU<T, N>::LU(const MatrixBase<Derived, T, N, N>& matrix)
+{
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        perm[i] = i;
+        for (std::size_t j = 0; j < N; ++j)
+            lu(i, j) = matrix(i, j);
+    }
+
+    for (std::size_t k = 0; k < N; ++k)
+    {
+        std::size_t p = k;
+        for (std::size_t i = k + 1; i < N; ++i)
+            if (std::abs(lu(i, k)) > std::abs(lu(p, k)))
+                p = i;
+
+        if (p != k)
+        {
+            for (std::size_t j = 0; j < N; ++j)
+                std::swap(lu(k, j), lu(p, j));
+            std::swap(perm[k], perm[p]);
+            sign = -sign;
+        }
+
+        if (lu(k, k) == T(0))
+        {
+            is_singular = true;
+            continue;
+        }
+
+        for (std::size_t i = k + 1; i < N; ++i)
+        {
+            const T l = lu(i, k) /= lu(k, k);
+            for (std::size_t j = k + 1; j < N; ++j)
+                lu(i, j) -= l * lu(k, j);
+        }
+    }
+}
+
+template <typename T, std::size_t N>
+ConstantVector<T, N> LU<T, N>::solve(const ConstantVector<T, N>& b) const
+{
+    if (is_singular)
+        throw std::runtime_error("Singular matrix in LU!");
+
+    ConstantVector<T, N> x;
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        T sum = b[perm[i]];
+        for (std::size_t j = 0; j < i; ++j)
+            sum -= lu(i, j) * x[j];
+        x[i] = sum;
+    }
+
+    for (std::size_t i = N; i-- > 0;)
+    {
+        T sum = x[i];
+        for (std::size_t j = i + 1; j < N; ++j)
+            sum -= lu(i, j) * x[j];
+        x[i] = sum / lu(i, i);
+    }
+
+    return x;
+}
+
+template <typename T, std::size_t N>
+Matrix<T, N, N> LU<T, N>::inverse() const
 {
-    MatrixBase<Derived, T, N, M> ret {m};
+    Matrix<T, N, N> ret;
+    for (std::size_t j = 0; j < N; ++j)
+    {
+        ConstantVector<T, N> e;
+        e[j] = T(1);
+
+        const auto column = solve(e);
+        for (std::size_t i = 0; i < N; ++i)
+            ret(i, j) = column[i];
+    }
+    return ret;
+}
+
+//
+// Cholesky decomposition A = L L^T of a symmetric positive definite matrix,
+// of which only the lower triangle is read
+//
+template <typename T, std::size_t N>
+class Cholesky
+{
+public:
+    template <typename Derived>
+    explicit Cholesky(const MatrixBase<Derived, T, N, N>& matrix);
+
+    ConstantVector<T, N> solve(const ConstantVector<T, N>& b) const;
+
+    T determinant() const
+    {
+        T det = T(1);
+        for (std::size_t i = 0; i < N; ++i)
+            det *= L(i, i) * L(i, i);
+        return det;
+    }
+
+    const Matrix<T, N, N>& matrixL() const { return L; }
+
+private:
+    Matrix<T, N, N> L;
+};
+
+template <typename T, std::size_t N>
+template <typename Derived>
+Cholesky<T, N>::Cholesky(const MatrixBase<Derived, T, N, N>& matrix)
+{
+    for (std::size_t j = 0; j < N; ++j)
+    {
+        T d = matrix(j, j);
+        for (std::size_t k = 0; k < j; ++k)
+            d -= L(j, k) * L(j, k);
+
+        if (!(d > T(0)))
+            throw std::runtime_error("Matrix not positive definite in Cholesky!");
+
+        L(j, j) = std::sqrt(d);
+        for (std::size_t i = j + 1; i < N; ++i)
+        {
+            T sum = matrix(i, j);
+            for (std::size_t k = 0; k < j; ++k)
+                sum -= L(i, k) * L(j, k);
+            L(i, j) = sum / L(j, j);
+        }
+    }
+}
+
+template <typename T, std::size_t N>
+ConstantVector<T, N> Cholesky<T, N>::solve(const ConstantVector<T, N>& b) const
+{
+    ConstantVector<T, N> x;
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        T sum = b[i];
+        for (std::size_t j = 0; j < i; ++j)
+            sum -= L(i, j) * x[j];
+        x[i] = sum / L(i, i);
+    }
+
+    for (std::size_t i = N; i-- > 0;)
+    {
+        T sum = x[i];
+        for (std::size_t j = i + 1; j < N; ++j)
+            sum -= L(j, i) * x[j];
+        x[i] = sum / L(i, i);
+    }
+
+    return x;
+}
+
+template <typename Derived, typename T, std::size_t N>
+T determinant(const MatrixBase<Derived, T, N, N>& m)
+{
+    if constexpr (N == 1)
+        return m(0, 0);
+    else if constexpr (N == 2)
+        return m(0, 0) * m(1, 1) - m(0, 1) * m(1, 0);
+    else if constexpr (N == 3)
+        return m(0, 0) * (m(1, 1) * m(2, 2) - m(1, 2) * m(2, 1))
+             - m(0, 1) * (m(1, 0) * m(2, 2) - m(1, 2) * m(2, 0))
+             + m(0, 2) * (m(1, 0) * m(2, 1) - m(1, 1) * m(2, 0));
+    else
+        return LU<T, N>(m).determinant();
+}
+
+// The small inverses from the adjugate, the others from the LU decomposition
+template <typename Derived, typename T, std::size_t N>
+Matrix<T, N, N> inverse(const MatrixBase<Derived, T, N, N>& m)
+{
+    if constexpr (N <= 3)
+    {
+        const T det = determinant(m);
+        if (det == T(0))
+            throw std::runtime_error("Singular matrix in inverse!");
+
+        const T f = T(1) / det;
+        if constexpr (N == 1)
+            return {{f}};
+        else if constexpr (N == 2)
+            return {{ f * m(1, 1), -f * m(0, 1)},
+                    {-f * m(1, 0),  f * m(0, 0)}};
+        else
+            return {{f * (m(1, 1) * m(2, 2) - m(1, 2) * m(2, 1)),
+                     f * (m(0, 2) * m(2, 1) - m(0, 1) * m(2, 2)),
+                     f * (m(0, 1) * m(1, 2) - m(0, 2) * m(1, 1))},
+                    {f * (m(1, 2) * m(2, 0) - m(1, 0) * m(2, 2)),
+                     f * (m(0, 0) * m(2, 2) - m(0, 2) * m(2, 0)),
+                     f * (m(0, 2) * m(1, 0) - m(0, 0) * m(1, 2))},
+                    {f * (m(1, 0) * m(2, 1) - m(1, 1) * m(2, 0)),
+                     f * (m(0, 1) * m(2, 0) - m(0, 0) * m(2, 1)),
+                     f * (m(0, 0) * m(1, 1) - m(0, 1) * m(1, 0))}};
+    }
+    else
+        return LU<T, N>(m).inverse();
+}
+
+template <typename Derived, typename T, std::size_t N, std::size_t M>
+Derived operator+(const MatrixBase<Derived, T, N, M>& lhs, const MatrixBase<Derived, T, N, M>& rhs)
+{
+    Derived ret {static_cast<const Derived&>(lhs)};
+    ret += rhs;
+    return ret;
+}
+
+template <typename Derived, typename T, std::size_t N, std::size_t M>
+Derived operator-(const MatrixBase<Derived, T, N, M>& lhs, const MatrixBase<Derived, T, N, M>& rhs)
+{
+    Derived ret {static_cast<const Derived&>(lhs)};
+    ret -= rhs;
+    return ret;
+}
+
+template <typename Derived, typename T, std::size_t N, std::size_t M>
+Derived operator*(const MatrixBase<Derived, T, N, M>& m, const T factor)
+{
+    Derived ret {static_cast<const Derived&>(m)};
     ret *= factor;
     return ret;
 }
 
 template <typename Derived, typename T, std::size_t N, std::size_t M>
-MatrixBase<Derived, T, N, M>
-operator*(const T factor, const MatrixBase<Derived, T, N, M>& m)
+Derived operator*(const T factor, const MatrixBase<Derived, T, N, M>& m)
 {
-    MatrixBase<Derived, T, N, M> ret {m};
+    Derived ret {static_cast<const Derived&>(m)};
     ret *= factor;
     return ret;
 }
 
 template <typename Derived, typename T, std::size_t N, std::size_t M>
-MatrixBase<Derived, T, N, M>
-operator/(const MatrixBase<Derived, T, N, M>& m, const T factor)
+Derived operator/(const MatrixBase<Derived, T, N, M>& m, const T factor)
 {
-    MatrixBase<Derived, T, N, M> ret {m};
+    Derived ret {static_cast<const Derived&>(m)};
     ret /= factor;
     return ret;
 }
 
 template <typename Derived, typename T, std::size_t N, std::size_t M>
-MatrixBase<Derived, T, N, M>
-operator/(const T factor, const MatrixBase<Derived, T, N, M>& m)
+Derived operator/(const T factor, const MatrixBase<Derived, T, N, M>& m)
 {
-    MatrixBase<Derived, T, N, M> ret {m};
-    ret /= factor;
+    Derived ret {static_cast<const Derived&>(m)};
+    std::transform(ret.begin(), ret.end(), ret.begin(),
+                   [factor](const T value) { return factor / value; });
+    return ret;
+}
+
+// With a dense rhs whose rows fill whole packets, the rows of the product
+// are accumulated from the packets of the rows of rhs (see vector_packet.h)
+template <typename Derived1, typename Derived2, typename T, std::size_t N, std::size_t K, std::size_t M>
+Matrix<T, N, M>
+operator*(const MatrixBase<Derived1, T, N, K>& lhs, const MatrixBase<Derived2, T, K, M>& rhs)
+{
+    Matrix<T, N, M> ret;
+
+    if constexpr (std::is_same<Derived2, Matrix<T, K, M> >::value &&
+                  impl::fixed_packet<T, 4>::value && M % 4 == 0)
+    {
+        using packet = impl::fixed_packet_t<T, 4>;
+        constexpr std::size_t P = M / 4;
+
+        const T * b = rhs.begin();
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            packet row[P] = {};
+            for (std::size_t k = 0; k < K; ++k)
+            {
+                const packet a = impl::packet_broadcast<T, 4>(lhs(i, k));
+                for (std::size_t p = 0; p < P; ++p)
+                    row[p] += a * impl::packet_load<T, 4>(b + k * M + 4 * p);
+            }
+
+            for (std::size_t p = 0; p < P; ++p)
+                impl::packet_store<T, 4>(ret.begin() + i * M + 4 * p, row[p]);
+        }
+    }
+    else
+    {
+        for (std::size_t i = 0; i < N; ++i)
+            for (std::size_t j = 0; j < M; ++j)
+            {
+                T sum = lhs(i, 0) * rhs(0, j);
+                for (std::size_t k = 1; k < K; ++k)
+                    sum += lhs(i, k) * rhs(k, j);
+                ret(i, j) = sum;
+            }
+    }
+
     return ret;
 }
 
@@ -689,22 +1030,77 @@ operator*(const MatrixBase<Derived, T, N, M>& m, const ConstantVector<T, M>& vec
 {
     ConstantVector<T, N> r;
     for (std::size_t i = 0; i < N; ++i)
-        for (std::size_t j = 0; j < M; ++j)
-            r[i] += m(i, j) * vector[j];
+    {
+        T sum = m(i, 0) * vector[0];
+        for (std::size_t j = 1; j < M; ++j)
+            sum += m(i, j) * vector[j];
+        r[i] = sum;
+    }
     return r;
 }
 
 template <typename Derived, typename T, std::size_t N, std::size_t M>
 ConstantVector<T, M>
 operator*(const ConstantVector<T, N>& vector, const MatrixBase<Derived, T, N, M>& m)
+{
+    ConstantVector<T, M> r;
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        const T v = vector[i];
+        for (std::size_t j = 0; j < M; ++j)
+            r[j] += v * m(i, j);
+    }
+    return r;
+}
+
+// The symmetric products read each element of the packed upper triangle once
+// and apply it to both of its positions
+template <typename T, std::size_t N>
+ConstantVector<T, N>
+operator*(const SymmetricMatrix<T, N>& s, const ConstantVector<T, N>& vector)
 {
     ConstantVector<T, N> r;
-    for (std::size_t i = 0; i < M; ++i)
-        for (std::size_t j = 0; j < N; ++j)
-            r[i] += m(j, i) * vector[j];
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        const T * __restrict__ row = s.begin() + i * N - (i - 1) * i / 2 - i;
+
+        T sum = row[i] * vector[i];
+        for (std::size_t j = i + 1; j < N; ++j)
+        {
+            sum  += row[j] * vector[j];
+            r[j] += row[j] * vector[i];
+        }
+        r[i] += sum;
+    }
     return r;
 }
 
+template <typename Derived, typename T, std::size_t N, std::size_t M>
+Matrix<T, N, M>
+operator*(const SymmetricMatrix<T, N>& s, const MatrixBase<Derived, T, N, M>& m)
+{
+    Matrix<T, N, M> ret;
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        const T * __restrict__ row = s.begin() + i * N - (i - 1) * i / 2 - i;
+
+        T * __restrict__ ri = ret.begin() + i * M;
+        for (std::size_t k = 0; k < M; ++k)
+            ri[k] += row[i] * m(i, k);
+
+        for (std::size_t j = i + 1; j < N; ++j)
+        {
+            T * __restrict__ rj = ret.begin() + j * M;
+            for (std::size_t k = 0; k < M; ++k)
+            {
+                ri[k] += row[j] * m(j, k);
+                rj[k] += row[j] * m(i, k);
+            }
+        }
+    }
+    return ret;
+}
+
 using Tensor = Matrix<double, 3, 3>;
 using SymTensor = SymmetricMatrix<double, 3>;
 using SymmetricTensor = SymmetricMatrix<double, 3>;
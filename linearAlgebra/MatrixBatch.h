@@ -0,0 +1,406 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  File Name:  MatrixBatch.h                                                 //
+//                                                                            //
+//     Author:  Andreas Buttenschoen <andreas@buttenschoen.ca>                //
+//    Created:  2026-10-19 07:18:42                                           //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CS_MATRIX_BATCH_H
+#define CS_MATRIX_BATCH_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "VectorSoA.h"
+
+namespace impl {
+
+// The scalar type and the number of stored components of the matrices
+template <typename Element>
+struct matrix_traits;
+
+template <typename T, std::size_t N, std::size_t M>
+struct matrix_traits<BasicDatatypes::Matrix<T, N, M> >
+{
+    using value_type = T;
+    static constexpr std::size_t components = N * M;
+};
+
+template <typename T, std::size_t N>
+struct matrix_traits<BasicDatatypes::SymmetricMatrix<T, N> >
+{
+    using value_type = T;
+    static constexpr std::size_t components = BasicDatatypes::SymmetricMatrix<T, N>::PACKED_SIZE;
+};
+
+} // end namespace
+
+//
+// Many small matrices, e.g. one Tensor or SymTensor per quadrature point,
+// stored as a structure of arrays
+//
+//      MatrixBatch<Tensor> F(tensors);         // from std::vector<Tensor>
+//      CSVector<double> J = determinant(F);
+//      auto Finv = inverse(F);
+//
+//      MatrixBatch<SymTensor> sigma(stresses);
+//      auto e = eigen(sigma);                  // e.values, e.vectors
+//
+// Component k of the storage of the matrices, i.e. data[k] of a Matrix or of
+// the packed upper triangle of a SymmetricMatrix, is kept in the aligned
+// CSVector column(k) of the ColumnStorage (see VectorSoA.h). The kernels below
+// work on one matrix per SIMD lane, and are split across the threads as in
+// VectorSoA.h. They don't pivot or throw: singular matrices give non finite
+// results in their own lanes only.
+//
+// The eigen solver needs -fno-math-errno to vectorize, see CMakeLists.txt.
+//
+template <typename Element>
+class MatrixBatch : public ColumnStorage<Element, typename impl::matrix_traits<Element>::value_type,
+                                         impl::matrix_traits<Element>::components>
+{
+    using Base = ColumnStorage<Element, typename impl::matrix_traits<Element>::value_type,
+                               impl::matrix_traits<Element>::components>;
+
+public:
+    using typename Base::size_type;
+    using typename Base::value_type;
+
+    static constexpr size_type COMPONENTS = impl::matrix_traits<Element>::components;
+
+    using Base::Base;
+    using Base::column;
+
+    // The column of the entry (i, j)
+    CSVector<value_type>& column(const size_type i, const size_type j)
+    {
+        return column(Element().index(i, j));
+    }
+
+    const CSVector<value_type>& column(const size_type i, const size_type j) const
+    {
+        return column(Element().index(i, j));
+    }
+};
+
+template <typename Element>
+inline std::size_t size(const MatrixBatch<Element>& m)
+{
+    return m.size();
+}
+
+template <typename T>
+using TensorBatch = MatrixBatch<BasicDatatypes::Matrix<T, 3, 3> >;
+
+template <typename T>
+using SymmetricTensorBatch = MatrixBatch<BasicDatatypes::SymmetricMatrix<T, 3> >;
+
+// The eigenvalues in ascending order, and the eigenvectors as the columns of
+// the matrices
+template <typename T>
+struct SymmetricEigen
+{
+    VectorSoA<T, 3> values;
+    TensorBatch<T> vectors;
+};
+
+namespace impl {
+
+inline void batch_check(std::size_t a, std::size_t b, const char * name)
+{
+    if (a != b)
+        throw std::runtime_error(std::string("Incompatible vector lengths in ") + name + "!");
+}
+
+// One Jacobi rotation annihilating apq, r is the remaining index, and the
+// columns p and q of v are rotated with it. It doesn't branch, so that it
+// vectorizes across the matrices.
+template <typename T>
+inline void jacobi_rotate(T& app, T& aqq, T& apq, T& arp, T& arq,
+                          T& v0p, T& v0q, T& v1p, T& v1q, T& v2p, T& v2q)
+{
+    const T tau = aqq - app;
+    const T den = std::abs(tau) + std::sqrt(tau * tau + T(4) * apq * apq);
+    // den vanishes only with apq, and then t = 0
+    const T t   = T(2) * apq * std::copysign(T(1), tau) / std::max(den, std::numeric_limits<T>::min());
+    const T c   = T(1) / std::sqrt(T(1) + t * t);
+    const T s   = t * c;
+
+    app -= t * apq;
+    aqq += t * apq;
+    apq  = T(0);
+
+    const T rp = arp, rq = arq;
+    arp = c * rp - s * rq;
+    arq = s * rp + c * rq;
+
+    const T p0 = v0p, p1 = v1p, p2 = v2p;
+    v0p = c * p0 - s * v0q;  v0q = s * p0 + c * v0q;
+    v1p = c * p1 - s * v1q;  v1q = s * p1 + c * v1q;
+    v2p = c * p2 - s * v2q;  v2q = s * p2 + c * v2q;
+}
+
+// Orders the eigenvalues p < q together with their eigenvectors
+template <typename T>
+inline void eigen_order(T& lp, T& lq, T& v0p, T& v0q, T& v1p, T& v1q, T& v2p, T& v2q)
+{
+    const bool swap = lq < lp;
+    const T a = lp, b = lq;
+    lp = swap ? b : a;
+    lq = swap ? a : b;
+
+    const T x0 = v0p, x1 = v1p, x2 = v2p;
+    v0p = swap ? v0q : x0;  v0q = swap ? x0 : v0q;
+    v1p = swap ? v1q : x1;  v1q = swap ? x1 : v1q;
+    v2p = swap ? v2q : x2;  v2q = swap ? x2 : v2q;
+}
+
+} // end namespace
+
+template <typename T>
+CSVector<T> determinant(const TensorBatch<T>& a)
+{
+    CSVector<T> ret(a.size());
+    const auto m = a.data();
+    T * __restrict__ r = ret.data();
+
+    impl::soa_for<T>(a.size(), [&](std::size_t begin, std::size_t end)
+    {
+        #pragma omp simd
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            r[i] = m[0][i] * (m[4][i] * m[8][i] - m[5][i] * m[7][i])
+                 - m[1][i] * (m[3][i] * m[8][i] - m[5][i] * m[6][i])
+                 + m[2][i] * (m[3][i] * m[7][i] - m[4][i] * m[6][i]);
+        }
+    });
+
+    return ret;
+}
+
+template <typename T>
+CSVector<T> determinant(const SymmetricTensorBatch<T>& a)
+{
+    CSVector<T> ret(a.size());
+    const auto m = a.data();
+    T * __restrict__ r = ret.data();
+
+    impl::soa_for<T>(a.size(), [&](std::size_t begin, std::size_t end)
+    {
+        #pragma omp simd
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            const T xx = m[0][i], xy = m[1][i], xz = m[2][i];
+            const T yy = m[3][i], yz = m[4][i], zz = m[5][i];
+
+            r[i] = xx * (yy * zz - yz * yz) - xy * (xy * zz - yz * xz) + xz * (xy * yz - yy * xz);
+        }
+    });
+
+    return ret;
+}
+
+// The inverses from the adjugates
+template <typename T>
+TensorBatch<T> inverse(const TensorBatch<T>& a)
+{
+    TensorBatch<T> ret(a.size());
+    const auto m = a.data();
+    const auto r = ret.data();
+
+    impl::soa_for<T>(a.size(), [&](std::size_t begin, std::size_t end)
+    {
+        #pragma omp simd
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            const T c00 = m[4][i] * m[8][i] - m[5][i] * m[7][i];
+            const T c01 = m[5][i] * m[6][i] - m[3][i] * m[8][i];
+            const T c02 = m[3][i] * m[7][i] - m[4][i] * m[6][i];
+
+            const T f = T(1) / (m[0][i] * c00 + m[1][i] * c01 + m[2][i] * c02);
+
+            r[0][i] = f * c00;
+            r[1][i] = f * (m[2][i] * m[7][i] - m[1][i] * m[8][i]);
+            r[2][i] = f * (m[1][i] * m[5][i] - m[2][i] * m[4][i]);
+            r[3][i] = f * c01;
+            r[4][i] = f * (m[0][i] * m[8][i] - m[2][i] * m[6][i]);
+            r[5][i] = f * (m[2][i] * m[3][i] - m[0][i] * m[5][i]);
+            r[6][i] = f * c02;
+            r[7][i] = f * (m[1][i] * m[6][i] - m[0][i] * m[7][i]);
+            r[8][i] = f * (m[0][i] * m[4][i] - m[1][i] * m[3][i]);
+        }
+    });
+
+    return ret;
+}
+
+// The inverse of a symmetric matrix is symmetric, and is kept packed
+template <typename T>
+SymmetricTensorBatch<T> inverse(const SymmetricTensorBatch<T>& a)
+{
+    SymmetricTensorBatch<T> ret(a.size());
+    const auto m = a.data();
+    const auto r = ret.data();
+
+    impl::soa_for<T>(a.size(), [&](std::size_t begin, std::size_t end)
+    {
+        #pragma omp simd
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            const T xx = m[0][i], xy = m[1][i], xz = m[2][i];
+            const T yy = m[3][i], yz = m[4][i], zz = m[5][i];
+
+            const T c00 = yy * zz - yz * yz;
+            const T c01 = yz * xz - xy * zz;
+            const T c02 = xy * yz - yy * xz;
+
+            const T f = T(1) / (xx * c00 + xy * c01 + xz * c02);
+
+            r[0][i] = f * c00;
+            r[1][i] = f * c01;
+            r[2][i] = f * c02;
+            r[3][i] = f * (xx * zz - xz * xz);
+            r[4][i] = f * (xz * xy - xx * yz);
+            r[5][i] = f * (xx * yy - xy * xy);
+        }
+    });
+
+    return ret;
+}
+
+// Solves a x = b for each matrix by Cramer's rule
+template <typename T>
+VectorSoA<T, 3> solve(const TensorBatch<T>& a, const VectorSoA<T, 3>& b)
+{
+    impl::batch_check(a.size(), b.size(), "solve");
+
+    VectorSoA<T, 3> ret(a.size());
+    const auto m = a.data();
+    const auto y = b.data();
+    const auto r = ret.data();
+
+    impl::soa_for<T>(a.size(), [&](std::size_t begin, std::size_t end)
+    {
+        #pragma omp simd
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            const T a00 = m[0][i], a01 = m[1][i], a02 = m[2][i];
+            const T a10 = m[3][i], a11 = m[4][i], a12 = m[5][i];
+            const T a20 = m[6][i], a21 = m[7][i], a22 = m[8][i];
+            const T b0 = y[0][i], b1 = y[1][i], b2 = y[2][i];
+
+            // the cofactors of the first row, and those of b in its place
+            const T c00 = a11 * a22 - a12 * a21;
+            const T c01 = a12 * a20 - a10 * a22;
+            const T c02 = a10 * a21 - a11 * a20;
+
+            const T f = T(1) / (a00 * c00 + a01 * c01 + a02 * c02);
+
+            r[0][i] = f * (b0 * c00 + a01 * (a12 * b2 - b1 * a22) + a02 * (b1 * a21 - a11 * b2));
+            r[1][i] = f * (a00 * (b1 * a22 - a12 * b2) + b0 * c01 + a02 * (a10 * b2 - b1 * a20));
+            r[2][i] = f * (a00 * (a11 * b2 - b1 * a21) + a01 * (b1 * a20 - a10 * b2) + b0 * c02);
+        }
+    });
+
+    return ret;
+}
+
+template <typename T>
+VectorSoA<T, 3> solve(const SymmetricTensorBatch<T>& a, const VectorSoA<T, 3>& b)
+{
+    impl::batch_check(a.size(), b.size(), "solve");
+
+    VectorSoA<T, 3> ret(a.size());
+    const auto m = a.data();
+    const auto y = b.data();
+    const auto r = ret.data();
+
+    impl::soa_for<T>(a.size(), [&](std::size_t begin, std::size_t end)
+    {
+        #pragma omp simd
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            const T xx = m[0][i], xy = m[1][i], xz = m[2][i];
+            const T yy = m[3][i], yz = m[4][i], zz = m[5][i];
+            const T b0 = y[0][i], b1 = y[1][i], b2 = y[2][i];
+
+            const T c00 = yy * zz - yz * yz;
+            const T c01 = yz * xz - xy * zz;
+            const T c02 = xy * yz - yy * xz;
+            const T c11 = xx * zz - xz * xz;
+            const T c12 = xz * xy - xx * yz;
+            const T c22 = xx * yy - xy * xy;
+
+            const T f = T(1) / (xx * c00 + xy * c01 + xz * c02);
+
+            r[0][i] = f * (c00 * b0 + c01 * b1 + c02 * b2);
+            r[1][i] = f * (c01 * b0 + c11 * b1 + c12 * b2);
+            r[2][i] = f * (c02 * b0 + c12 * b1 + c22 * b2);
+        }
+    });
+
+    return ret;
+}
+
+// The number of cyclic Jacobi sweeps of eigen, which converge quadratically.
+// After four the off diagonal entries of the 3x3 matrices are below the
+// rounding error of the eigenvalues in double precision. It is fixed, so
+// that the sweeps are unrolled and all lanes take the same path.
+constexpr std::size_t JacobiSweeps = 4;
+
+// The eigenvalues and eigenvectors of the symmetric matrices by cyclic Jacobi
+// rotations. Unlike the closed form through the roots of the characteristic
+// polynomial it stays accurate for (nearly) repeated eigenvalues.
+template <typename T>
+SymmetricEigen<T> eigen(const SymmetricTensorBatch<T>& a)
+{
+    SymmetricEigen<T> ret {VectorSoA<T, 3>(a.size()), TensorBatch<T>(a.size())};
+    const auto m = a.data();
+    const auto l = ret.values.data();
+    const auto v = ret.vectors.data();
+
+    impl::soa_for<T>(a.size(), [&](std::size_t begin, std::size_t end)
+    {
+        #pragma omp simd
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            T a00 = m[0][i], a01 = m[1][i], a02 = m[2][i];
+            T a11 = m[3][i], a12 = m[4][i], a22 = m[5][i];
+
+            T v00 = 1, v01 = 0, v02 = 0;
+            T v10 = 0, v11 = 1, v12 = 0;
+            T v20 = 0, v21 = 0, v22 = 1;
+
+            #pragma GCC unroll 8
+            for (std::size_t sweep = 0; sweep < JacobiSweeps; ++sweep)
+            {
+                impl::jacobi_rotate(a00, a11, a01, a02, a12, v00, v01, v10, v11, v20, v21);
+                impl::jacobi_rotate(a00, a22, a02, a01, a12, v00, v02, v10, v12, v20, v22);
+                impl::jacobi_rotate(a11, a22, a12, a01, a02, v01, v02, v11, v12, v21, v22);
+            }
+
+            impl::eigen_order(a00, a11, v00, v01, v10, v11, v20, v21);
+            impl::eigen_order(a11, a22, v01, v02, v11, v12, v21, v22);
+            impl::eigen_order(a00, a11, v00, v01, v10, v11, v20, v21);
+
+            l[0][i] = a00;  l[1][i] = a11;  l[2][i] = a22;
+
+            v[0][i] = v00;  v[1][i] = v01;  v[2][i] = v02;
+            v[3][i] = v10;  v[4][i] = v11;  v[5][i] = v12;
+            v[6][i] = v20;  v[7][i] = v21;  v[8][i] = v22;
+        }
+    });
+
+    return ret;
+}
+
+#endif
@@ -0,0 +1,260 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  File Name:  Quaternion.h                                                  //
+//                                                                            //
+//     Author:  Andreas Buttenschoen <andreas@buttenschoen.ca>                //
+//    Created:  2026-10-19 06:02:14                                           //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CS_QUATERNION_H
+#define CS_QUATERNION_H
+
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <type_traits>
+
+#include "vector_detail.h"
+#include "vector_packet.h"
+#include "Matrix.h"
+#include "Transform.h"
+
+namespace BasicDatatypes {
+
+//
+// Rotations as unit quaternions
+//
+//      auto q = Quaternion<double>::rotate(axis, angle);
+//      Vector3d v = q(u);                          // the same as Rotate(u, axis, angle)
+//      auto r = q * Quaternion<double>::rotate_z(phi); // rotate about z first
+//
+// The coefficients are kept as a ConstantVector<T, 4> in the order x, y, z, w,
+// so that the products of double and float quaternions are evaluated as
+// single packets (see vector_packet.h). Composing two rotations costs 16
+// multiplications instead of the 27 of the matrix product, and a rotation is
+// assembled from one sin and cos.
+//
+template <class T>
+class Quaternion
+{
+public:
+    static_assert(std::is_floating_point<T>::value, "Quaternion must be floating point!");
+
+    // the identity
+    Quaternion()
+        : q(T(0), T(0), T(0), T(1))
+    {}
+
+    Quaternion(const T w, const T x, const T y, const T z)
+        : q(x, y, z, w)
+    {}
+
+    // from the coefficients x, y, z, w
+    explicit Quaternion(const ConstantVector<T, 4>& coefficients)
+        : q(coefficients)
+    {}
+
+    T w() const { return q.w; }
+    T x() const { return q.x; }
+    T y() const { return q.y; }
+    T z() const { return q.z; }
+
+    const ConstantVector<T, 4>& coeffs() const { return q; }
+    ConstantVector<T, 3> vec() const { return ConstantVector<T, 3>(q.x, q.y, q.z); }
+
+    Quaternion conjugate() const
+    {
+        return Quaternion(q.w, -q.x, -q.y, -q.z);
+    }
+
+    // The inverse of a rotation is its conjugate
+    Quaternion inverse() const
+    {
+        return Quaternion(ConstantVector<T, 4>(conjugate().q / Norm2Squared(q)));
+    }
+
+    // The composition, (a * b)(v) = a(b(v))
+    Quaternion operator*(const Quaternion& other) const;
+
+    Quaternion& operator*=(const Quaternion& other)
+    {
+        return *this = *this * other;
+    }
+
+    // Rotates the vector, the quaternion must be normalized
+    ConstantVector<T, 3> rotate(const ConstantVector<T, 3>& vector) const;
+    ConstantVector<T, 3> operator()(const ConstantVector<T, 3>& vector) const
+    {
+        return rotate(vector);
+    }
+
+    Matrix<T, 3, 3> matrix() const;
+    Transform<T> transform() const
+    {
+        return Transform<T>(matrix(), Transform<T>::Structure::Orthogonal);
+    }
+
+    // COMMONLY USED ROTATIONS
+    static Quaternion identity() { return Quaternion(); }
+
+    static Quaternion rotate_x(T angle);
+    static Quaternion rotate_y(T angle);
+    static Quaternion rotate_z(T angle);
+    // the axis must be of unit length
+    static Quaternion rotate(ConstantVector<T, 3> axis, T angle);
+
+private:
+    ConstantVector<T, 4> q;
+};
+
+template <class T>
+Quaternion<T> Quaternion<T>::operator*(const Quaternion& other) const
+{
+    const auto& a = q;
+    const auto& b = other.q;
+
+    if constexpr (impl::fixed_packet<T, 4>::value)
+    {
+        using mask = typename impl::fixed_packet<T, 4>::mask;
+        using packet = impl::fixed_packet_t<T, 4>;
+
+        // a.w * b + a.x * (w, -z, y, -x) + a.y * (z, w, -x, -y) + a.z * (-y, x, w, -z)
+        const mask wzyx = {3, 2, 1, 0};
+        const mask zwxy = {2, 3, 0, 1};
+        const mask yxwz = {1, 0, 3, 2};
+
+        const packet sx = {T(1), T(-1), T(1), T(-1)};
+        const packet sy = {T(1), T(1), T(-1), T(-1)};
+        const packet sz = {T(-1), T(1), T(1), T(-1)};
+
+        const auto p = impl::packet_load<T, 4>(b.data());
+        const auto r = impl::packet_broadcast<T, 4>(a.w) * p
+                     + impl::packet_broadcast<T, 4>(a.x) * (__builtin_shuffle(p, wzyx) * sx)
+                     + impl::packet_broadcast<T, 4>(a.y) * (__builtin_shuffle(p, zwxy) * sy)
+                     + impl::packet_broadcast<T, 4>(a.z) * (__builtin_shuffle(p, yxwz) * sz);
+
+        Quaternion ret;
+        impl::packet_store<T, 4>(ret.q.data(), r);
+        return ret;
+    }
+    else
+        return Quaternion(a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z,
+                          a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+                          a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+                          a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w);
+}
+
+// v + w t + u x t with t = 2 u x v
+template <class T>
+ConstantVector<T, 3> Quaternion<T>::rotate(const ConstantVector<T, 3>& vector) const
+{
+    const T t0 = T(2) * (q.y * vector.z - q.z * vector.y);
+    const T t1 = T(2) * (q.z * vector.x - q.x * vector.z);
+    const T t2 = T(2) * (q.x * vector.y - q.y * vector.x);
+
+    return ConstantVector<T, 3>(vector.x + q.w * t0 + (q.y * t2 - q.z * t1),
+                                vector.y + q.w * t1 + (q.z * t0 - q.x * t2),
+                                vector.z + q.w * t2 + (q.x * t1 - q.y * t0));
+}
+
+template <class T>
+Matrix<T, 3, 3> Quaternion<T>::matrix() const
+{
+    const T xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+    const T xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+    const T wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+    return {{1 - 2 * (yy + zz), 2 * (xy - wz), 2 * (xz + wy)},
+            {2 * (xy + wz), 1 - 2 * (xx + zz), 2 * (yz - wx)},
+            {2 * (xz - wy), 2 * (yz + wx), 1 - 2 * (xx + yy)}};
+}
+
+template <class T>
+Quaternion<T> Quaternion<T>::rotate_x(T angle)
+{
+    return Quaternion(std::cos(angle / 2), std::sin(angle / 2), T(0), T(0));
+}
+
+template <class T>
+Quaternion<T> Quaternion<T>::rotate_y(T angle)
+{
+    return Quaternion(std::cos(angle / 2), T(0), std::sin(angle / 2), T(0));
+}
+
+template <class T>
+Quaternion<T> Quaternion<T>::rotate_z(T angle)
+{
+    return Quaternion(std::cos(angle / 2), T(0), T(0), std::sin(angle / 2));
+}
+
+// The axis must be normalized as for Matrix::rotate
+template <class T>
+Quaternion<T> Quaternion<T>::rotate(ConstantVector<T, 3> axis, T angle)
+{
+    const T s = std::sin(angle / 2);
+    return Quaternion(std::cos(angle / 2), s * axis.x, s * axis.y, s * axis.z);
+}
+
+template <class T>
+T Dot(const Quaternion<T>& a, const Quaternion<T>& b)
+{
+    return Dot(a.coeffs(), b.coeffs());
+}
+
+template <class T>
+T Norm(const Quaternion<T>& a)
+{
+    return std::sqrt(Norm2Squared(a.coeffs()));
+}
+
+template <class T>
+Quaternion<T> Normalize(const Quaternion<T>& a)
+{
+    return Quaternion<T>(Normalize(a.coeffs()));
+}
+
+// The spherical linear interpolation between the rotations a (t = 0) and b
+// (t = 1) along the shorter arc. Nearly parallel quaternions are interpolated
+// linearly, where the sine of the angle loses its precision.
+template <class T>
+Quaternion<T> Slerp(const Quaternion<T>& a, const Quaternion<T>& b, const T t)
+{
+    T cosTheta = Dot(a, b);
+
+    // q and -q are the same rotation
+    const T sign = (cosTheta < 0) ? T(-1) : T(1);
+    cosTheta *= sign;
+
+    T wa, wb;
+    if (cosTheta > T(0.9995))
+    {
+        wa = T(1) - t;
+        wb = t;
+    }
+    else
+    {
+        const T theta    = std::acos(cosTheta);
+        const T sinTheta = std::sin(theta);
+
+        wa = std::sin((T(1) - t) * theta) / sinTheta;
+        wb = std::sin(t * theta) / sinTheta;
+    }
+
+    const ConstantVector<T, 4> r = wa * a.coeffs() + (sign * wb) * b.coeffs();
+    return Normalize(Quaternion<T>(r));
+}
+
+template <class T>
+std::ostream& operator<<(std::ostream& os, const Quaternion<T>& q)
+{
+    os << "(" << q.w() << ", " << q.x() << ", " << q.y() << ", " << q.z() << ")";
+    return os;
+}
+
+} // end namespace
+
+using Quaterniond = BasicDatatypes::Quaternion<double>;
+using Quaternionf = BasicDatatypes::Quaternion<float>;
+
+#endif
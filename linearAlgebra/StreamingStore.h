@@ -0,0 +1,171 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  File Name:  StreamingStore.h                                              //
+//                                                                            //
+//     Author:  Andreas Buttenschoen <andreas@buttenschoen.ca>                //
+//    Created:  2026-10-18 21:48:15                                           //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CS_STREAMING_STORE_H
+#define CS_STREAMING_STORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#endif
+
+#include "VectorTraits.h"
+#include "VectorFunctors.h"
+#include "TuningProfile.h"
+#include "Trace.h"
+#include "type_info.h"
+
+//
+// Non-temporal (streaming) stores. A normal store to a line which isn't in
+// cache first reads the line (read for ownership), and the written line then
+// evicts data that is still useful. For destinations much larger than the
+// last level cache neither pays off, and the stores below write whole lines
+// straight to memory, saving about a third of the memory traffic.
+//
+// Streaming stores are weakly ordered, hence every thread issues a store fence
+// after its part, before the data can be read by another thread.
+//
+// The assignment of vector expressions switches to streaming stores once the
+// destination exceeds the streaming threshold of the tuning profile, which
+// should be about the size of the last level cache. It defaults to
+// STREAMING_STORE_THRESHOLD bytes.
+//
+
+namespace impl {
+
+#if defined(__AVX__)
+static constexpr std::size_t StreamPacketBytes = 32;
+#elif defined(__SSE2__)
+static constexpr std::size_t StreamPacketBytes = 16;
+#else
+static constexpr std::size_t StreamPacketBytes = 0;
+#endif
+
+// the elements of T which make up one streamed packet
+template <typename T>
+constexpr std::size_t stream_packet_size()
+{
+    return (StreamPacketBytes && StreamPacketBytes % sizeof(T) == 0) ? StreamPacketBytes / sizeof(T) : 0;
+}
+
+template <typename T>
+inline bool use_streaming_stores(std::size_t n)
+{
+    return stream_packet_size<T>() && std::is_trivially_copyable<T>::value
+        && n * sizeof(T) >= Tuning::profile().streamingThreshold;
+}
+
+// writes StreamPacketBytes from the aligned src to the aligned dst
+inline void stream_packet(void * dst, const void * src)
+{
+#if defined(__AVX__)
+    _mm256_stream_si256((__m256i *) dst, _mm256_load_si256((const __m256i *) src));
+#elif defined(__SSE2__)
+    _mm_stream_si128((__m128i *) dst, _mm_load_si128((const __m128i *) src));
+#else
+    std::memcpy(dst, src, StreamPacketBytes);
+#endif
+}
+
+inline void stream_fence()
+{
+#if defined(__SSE2__)
+    _mm_sfence();
+#endif
+}
+
+// the number of elements of dst before the first packet boundary
+template <typename T>
+inline std::size_t stream_head(const T * dst, std::size_t n)
+{
+    constexpr std::size_t PACKET_BYTES = StreamPacketBytes ? StreamPacketBytes : 1;
+    const std::size_t misalignment = reinterpret_cast<std::uintptr_t>(dst) % PACKET_BYTES;
+    const std::size_t head = misalignment ? (PACKET_BYTES - misalignment) / sizeof(T) : 0;
+    return head < n ? head : n;
+}
+
+//
+// The routines are called with n large, so they always run in parallel. The
+// head and tail around the packets use normal stores.
+//
+template <typename T, typename Source>
+void stream_generate(T * dst, std::size_t n, const Source& src)
+{
+    constexpr std::size_t PACKET = stream_packet_size<T>();
+    const std::size_t Threads    = Tuning::profile().threads;
+
+    const std::size_t head       = stream_head(dst, n);
+    const std::size_t NO_PACKETS = (n - head) / PACKET;
+    const std::size_t tail       = head + NO_PACKETS * PACKET;
+
+    for (std::size_t i = 0; i < head; ++i)
+        dst[i] = src(i);
+
+    #pragma omp parallel num_threads(Threads)
+    {
+        FASTVECTOR_TRACE(("stream, " + type_name<T>()), n);
+
+        #pragma omp for nowait
+        for (std::size_t p = 0; p < NO_PACKETS; ++p)
+        {
+            const std::size_t i = head + p * PACKET;
+
+            alignas(StreamPacketBytes) T tmp[PACKET];
+            for (std::size_t k = 0; k < PACKET; ++k)
+                tmp[k] = src(i + k);
+
+            stream_packet(dst + i, tmp);
+        }
+
+        // each thread orders its own streaming stores
+        stream_fence();
+    }
+
+    for (std::size_t i = tail; i < n; ++i)
+        dst[i] = src(i);
+}
+
+template <typename T>
+void stream_fill(T * dst, const T value, std::size_t n)
+{
+    stream_generate(dst, n, [value](std::size_t) { return value; });
+}
+
+template <typename T>
+void stream_copy(T * __restrict__ dst, const T * __restrict__ src, std::size_t n)
+{
+    stream_generate(dst, n, [src](std::size_t i) { return src[i]; });
+}
+
+template <typename Functor>
+struct is_assign : std::false_type {};
+
+template <typename Value1, typename Value2>
+struct is_assign<assign<Value1, Value2> > : std::true_type {};
+
+// Plain assignments to a CSVector may stream, compound assignments read the
+// destination anyway
+template <typename E1, typename Functor>
+struct is_streamable : std::false_type {};
+
+template <typename T, typename Functor>
+struct is_streamable<CSVector<T>, Functor>
+    : std::integral_constant<bool, is_assign<Functor>::value && stream_packet_size<T>() != 0> {};
+
+// the bit-packed CSVector<bool> has its own assignment
+template <typename Functor>
+struct is_streamable<CSVector<bool>, Functor> : std::false_type {};
+
+} // end namespace
+
+#endif
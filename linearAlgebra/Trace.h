@@ -0,0 +1,268 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  File Name:  Trace.h                                                       //
+//                                                                            //
+//     Author:  Andreas Buttenschoen <andreas@buttenschoen.ca>                //
+//    Created:  2026-10-19 01:47:22                                           //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CS_TRACE_H
+#define CS_TRACE_H
+
+//
+// A timeline of the work of every thread in the parallel regions, which
+// shows load imbalance between the threads. Each thread's chunk of an
+// assignment or a reduction is recorded as one event, with the expression
+// type and the vector size, and the events are written in the Chrome trace
+// format, which chrome://tracing and Perfetto read.
+//
+// Compile with FASTVECTOR_TRACING defined to enable the hooks, otherwise
+// FASTVECTOR_TRACE expands to nothing. Recording starts with Trace::start()
+// and ends with Trace::stop(); while stopped a hook costs one relaxed load.
+// If FASTVECTOR_TRACE_FILE is set, recording starts with the first traced
+// kernel and the trace is written to that file at exit.
+//
+// Every thread writes its events into its own ring buffer, without locks.
+// Once a buffer is full the oldest events are overwritten. Dump after stop(),
+// as events written during a dump may be torn.
+//
+
+#ifdef FASTVECTOR_TRACING
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Hooks.h"
+#include "type_info.h"
+
+namespace Trace {
+
+// the events kept per thread
+static constexpr std::size_t RingCapacity = 1 << 16;
+
+inline std::uint64_t now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct Event
+{
+    std::uint64_t begin;
+    std::uint64_t end;
+    std::uint64_t size;
+    std::uint32_t label;
+};
+
+// written by its thread only
+class Ring
+{
+public:
+    Ring(std::size_t thread)
+        : thread(thread), events(new Event[RingCapacity])
+    {}
+
+    inline void push(const Event& event)
+    {
+        const std::uint64_t h = head.load(std::memory_order_relaxed);
+        events[h % RingCapacity] = event;
+        head.store(h + 1, std::memory_order_release);
+    }
+
+    // the events still in the buffer, oldest first
+    std::vector<Event> recorded() const
+    {
+        const std::uint64_t h     = head.load(std::memory_order_acquire);
+        const std::uint64_t first = (h > RingCapacity) ? h - RingCapacity : 0;
+
+        std::vector<Event> copy;
+        copy.reserve(h - first);
+        for (std::uint64_t i = first; i < h; ++i)
+            copy.push_back(events[i % RingCapacity]);
+
+        return copy;
+    }
+
+    void clear()
+    {
+        head.store(0, std::memory_order_release);
+    }
+
+    const std::size_t thread;
+
+private:
+    std::atomic<std::uint64_t> head{0};
+    std::unique_ptr<Event[]>   events;
+};
+
+class Registry
+{
+public:
+    std::uint32_t id(const std::string& label)
+    {
+        return std::uint32_t(labels.id(label));
+    }
+
+    // The rings are kept after their thread exits, so that its events can
+    // still be written out
+    Ring * ring()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        rings.emplace_back(new Ring(rings.size()));
+        return rings.back().get();
+    }
+
+    template <typename Function>
+    void for_each(Function f)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& ring : rings)
+            f(*ring, labels);
+    }
+
+    std::atomic<bool> enabled{false};
+
+private:
+    std::mutex                          mutex;
+    Hooks::LabelRegistry                labels;
+    std::vector<std::unique_ptr<Ring> > rings;
+};
+
+inline Registry& registry()
+{
+    static Registry * instance = new Registry;
+    return *instance;
+}
+
+inline Ring& thread_ring()
+{
+    thread_local Ring * ring = registry().ring();
+    return *ring;
+}
+
+inline bool enabled()
+{
+    return registry().enabled.load(std::memory_order_relaxed);
+}
+
+inline void start()
+{
+    registry().enabled.store(true, std::memory_order_relaxed);
+}
+
+inline void stop()
+{
+    registry().enabled.store(false, std::memory_order_relaxed);
+}
+
+// drops the recorded events, call while stopped
+inline void clear()
+{
+    registry().for_each([](Ring& ring, const Hooks::LabelRegistry&) { ring.clear(); });
+}
+
+// the events in the Chrome trace event format, the times are in microseconds
+inline void dump(std::ostream& os)
+{
+    bool first = true;
+
+    os << "{\"traceEvents\": [";
+    registry().for_each([&](const Ring& ring, const Hooks::LabelRegistry& labels)
+    {
+        for (const Event& e : ring.recorded())
+        {
+            os << (first ? "\n  " : ",\n  ")
+               << "{\"name\": \"" << Hooks::json_escape(labels.label(e.label)) << "\""
+               << ", \"cat\": \"FastVector\", \"ph\": \"X\""
+               << ", \"ts\": " << double(e.begin) * 1e-3
+               << ", \"dur\": " << double(e.end - e.begin) * 1e-3
+               << ", \"pid\": 0, \"tid\": " << ring.thread
+               << ", \"args\": {\"size\": " << e.size << "}}";
+            first = false;
+        }
+    });
+    os << "\n], \"displayTimeUnit\": \"ns\"}" << std::endl;
+}
+
+inline bool dump(const std::string& filename)
+{
+    std::ofstream out(filename);
+    if (!out)
+        return false;
+
+    out.precision(15);
+    dump(out);
+    return bool(out);
+}
+
+// starts recording if FASTVECTOR_TRACE_FILE is set, and writes it at exit
+struct FileTrace
+{
+    FileTrace()
+        : filename(std::getenv("FASTVECTOR_TRACE_FILE"))
+    {
+        if (filename)
+            start();
+    }
+
+    ~FileTrace()
+    {
+        if (filename && !dump(std::string(filename)))
+            std::cerr << "Could not write " << filename << "!" << std::endl;
+    }
+
+    const char * filename;
+};
+
+inline std::uint32_t label_id(const std::string& label)
+{
+    static FileTrace file;
+    return registry().id(label);
+}
+
+// Records its own lifetime on the calling thread, if tracing is on
+class Scope
+{
+public:
+    Scope(std::uint32_t label, std::uint64_t size)
+        : label(label), size(size), begin(enabled() ? now() : 0)
+    {}
+
+    ~Scope()
+    {
+        if (begin)
+            thread_ring().push(Event{begin, now(), size, label});
+    }
+
+private:
+    std::uint32_t label;
+    std::uint64_t size;
+    std::uint64_t begin;
+};
+
+} // end namespace
+
+// the label is parenthesised, as it may contain commas
+#define FASTVECTOR_TRACE(label, size)                                                   \
+    static const std::uint32_t FASTVECTOR_CONCAT(trace_id_, __LINE__)                   \
+        = ::Trace::label_id(label);                                                     \
+    ::Trace::Scope FASTVECTOR_CONCAT(trace_scope_, __LINE__)                            \
+        (FASTVECTOR_CONCAT(trace_id_, __LINE__), (size))
+
+#else
+
+#define FASTVECTOR_TRACE(label, size)
+
+#endif
+
+#endif
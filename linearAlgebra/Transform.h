@@ -32,36 +32,43 @@ namespace BasicDatatypes {
 
 using BasicDatatypes::Matrix;
 
+//
+// Linear transforms of three dimensional vectors
+//
+// The inverse is only assembled when it is asked for. The structure of the
+// matrix decides how: the inverse of a rotation is its transpose, that of a
+// scaling its reciprocal, and anything else is inverted from the adjugate.
+//
 template <class T>
 class Transform
 {
 public:
     static constexpr std::size_t N = 3;
 
-    Transform(const Matrix<T, N, N>& _mat)
-        : mat(_mat)
-    {}
+    enum class Structure { General, Orthogonal, Diagonal };
 
-    Transform(Matrix<T, N, N>&& _mat)
-        : mat(_mat)
+    Transform(const Matrix<T, N, N>& _mat, const Structure _structure = Structure::General)
+        : mat(_mat), structure(_structure)
     {}
 
     Transform(const Matrix<T, N, N>& _mat, const Matrix<T, N, N>& _inv)
-        : mat(_mat), inv(_inv)
-    {}
-
-    Transform(Matrix<T, N, N>&& _mat, Matrix<T, N, N>&& _inv)
-        : mat(_mat), inv(_inv)
+        : mat(_mat), inv(_inv), known_inverse(true)
     {}
 
     ConstantVector<T, 3> transform(const ConstantVector<T, 3>& other) const;
     ConstantVector<T, 3> operator()(const ConstantVector<T, 3>& other) const;
 
-    Transform inverse() const
+    // Transforms a batch of points, e.g. a VectorSoA (see VectorSoA.h)
+    template <class Points>
+    Points apply(const Points& points) const
     {
-        return inv;
+        return Apply(*this, points);
     }
 
+    const Matrix<T, N, N>& matrix() const { return mat; }
+
+    Transform inverse() const;
+
     // COMMONLY USED TRANSFORMS
     static Transform identity();
 
@@ -75,6 +82,8 @@ public:
 
 private:
     Matrix<T, N, N> mat, inv;
+    Structure structure {Structure::General};
+    bool known_inverse {false};
 };
 
 template <class T>
@@ -89,6 +98,23 @@ ConstantVector<T, 3> Transform<T>::operator()(const ConstantVector<T, 3>& other)
     return transform(other);
 }
 
+template <class T>
+Transform<T> Transform<T>::inverse() const
+{
+    if (known_inverse)
+        return Transform<T>(inv, mat);
+
+    switch (structure)
+    {
+        case Structure::Orthogonal:
+            return Transform<T>(transpose(mat), mat);
+        case Structure::Diagonal:
+            return Transform<T>(Matrix<T, 3, 3>::scale(T(1) / mat.xx, T(1) / mat.yy, T(1) / mat.zz), mat);
+        default:
+            return Transform<T>(BasicDatatypes::inverse(mat), mat);
+    }
+}
+
 template <class T>
 Transform<T> Transform<T>::identity()
 {
@@ -99,43 +125,37 @@ Transform<T> Transform<T>::identity()
 template <class T>
 Transform<T> Transform<T>::rotate_x(T angle)
 {
-    return Transform<T>(Matrix<T, 3, 3>::rotate_x(angle),
-                        Matrix<T, 3, 3>::rotate_x(-angle));
+    return Transform<T>(Matrix<T, 3, 3>::rotate_x(angle), Structure::Orthogonal);
 }
 
 template <class T>
 Transform<T> Transform<T>::rotate_y(T angle)
 {
-    return Transform<T>(Matrix<T, 3, 3>::rotate_y(angle),
-                        Matrix<T, 3, 3>::rotate_y(-angle));
+    return Transform<T>(Matrix<T, 3, 3>::rotate_y(angle), Structure::Orthogonal);
 }
 
 template <class T>
 Transform<T> Transform<T>::rotate_z(T angle)
 {
-    return Transform<T>(Matrix<T, 3, 3>::rotate_z(angle),
-                        Matrix<T, 3, 3>::rotate_z(-angle));
+    return Transform<T>(Matrix<T, 3, 3>::rotate_z(angle), Structure::Orthogonal);
 }
 
 template <class T>
 Transform<T> Transform<T>::rotate(ConstantVector<T, 3> axis, T angle)
 {
-    return Transform<T>(Matrix<T, 3, 3>::rotate(axis, angle),
-                        Matrix<T, 3, 3>::rotate(axis, -angle));
+    return Transform<T>(Matrix<T, 3, 3>::rotate(axis, angle), Structure::Orthogonal);
 }
 
 template <class T>
 Transform<T> Transform<T>::scale(T f)
 {
-    return Transform<T>(Matrix<T, 3, 3>::scale(f),
-                        Matrix<T, 3, 3>::scale(1. / f));
+    return Transform<T>(Matrix<T, 3, 3>::scale(f), Structure::Diagonal);
 }
 
 template <class T>
 Transform<T> Transform<T>::scale(T fx, T fy, T fz)
 {
-    return Transform<T>(Matrix<T, 3, 3>::rotate(fx, fy, fz),
-                        Matrix<T, 3, 3>::rotate(1. / fx, 1. / fy, 1. / fz));
+    return Transform<T>(Matrix<T, 3, 3>::scale(fx, fy, fz), Structure::Diagonal);
 }
 
 } //end namespace
@@ -0,0 +1,167 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  File Name:  TuningProfile.h                                               //
+//                                                                            //
+//     Author:  Andreas Buttenschoen <andreas@buttenschoen.ca>                //
+//    Created:  2026-10-18 22:26:40                                           //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CS_TUNING_PROFILE_H
+#define CS_TUNING_PROFILE_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "VectorTraits.h"
+
+//
+// Per host tuning parameters. The compile time constants (UnrollBlockSize,
+// UnrollThreads, the prefetch distance of the packet kernels and the streaming
+// store threshold) are the defaults. If the environment variable
+//
+//      FASTVECTOR_TUNING_PROFILE
+//
+// names a profile file, it is read on first use and its values replace the
+// defaults. The file has one "key = value" per line, and '#' starts a comment:
+//
+//      threads             = 8
+//      chunks              = 4
+//      block_size_double   = 4
+//      block_size_float    = 8
+//      prefetch_distance   = 4
+//      streaming_threshold = 33554432
+//
+// benchmarks/Autotune.cpp writes such a file for the current host.
+//
+// The assignment unroll can only be one of the block sizes compiled in, see
+// ParallelExecutionPolicy. The reductions, dot products, scans, sorts and the
+// other chunked kernels split large vectors into "chunks" pieces, one per
+// thread. Their results depend on the number of chunks but not on "threads".
+//
+#ifndef STREAMING_STORE_THRESHOLD
+#define STREAMING_STORE_THRESHOLD (32ul * 1024 * 1024)
+#endif
+
+namespace Tuning {
+
+struct Profile
+{
+    // threads used by the assignment of expressions
+    std::size_t threads             = Expression::UnrollThreads<double>::value;
+
+    // the pieces, and threads, of the chunked kernels
+    std::size_t chunks              = Expression::UnrollThreads<double>::value;
+
+    // the unroll of the assignment loop
+    std::size_t blockSizeDouble     = Expression::UnrollBlockSize<double>::value;
+    std::size_t blockSizeFloat      = Expression::UnrollBlockSize<float>::value;
+
+    // how many packets ahead the packet kernels prefetch
+    std::size_t prefetchDistance    = 2;
+
+    // destinations larger than this many bytes are written with streaming stores
+    std::size_t streamingThreshold  = STREAMING_STORE_THRESHOLD;
+
+    // Reads the values found in filename, returns false if it can't be read
+    bool load(const std::string& filename)
+    {
+        std::ifstream in(filename);
+        if (!in)
+            return false;
+
+        std::string line;
+        while (std::getline(in, line))
+        {
+            line = line.substr(0, line.find('#'));
+
+            std::size_t eq = line.find('=');
+            if (eq == std::string::npos)
+                continue;
+
+            std::string key;
+            std::size_t value;
+            std::istringstream(line.substr(0, eq)) >> key;
+            if (!(std::istringstream(line.substr(eq + 1)) >> value) || value == 0)
+            {
+                std::cerr << "Ignoring invalid tuning entry \"" << line << "\"!" << std::endl;
+                continue;
+            }
+
+            if (key == "threads")
+                threads = value;
+            else if (key == "chunks")
+                chunks = value;
+            else if (key == "block_size_double")
+                blockSizeDouble = value;
+            else if (key == "block_size_float")
+                blockSizeFloat = value;
+            else if (key == "prefetch_distance")
+                prefetchDistance = value;
+            else if (key == "streaming_threshold")
+                streamingThreshold = value;
+            else
+                std::cerr << "Unknown tuning key \"" << key << "\"!" << std::endl;
+        }
+
+        return true;
+    }
+
+    bool save(const std::string& filename) const
+    {
+        std::ofstream out(filename);
+        if (!out)
+            return false;
+
+        out << "# FastVector tuning profile\n";
+        out << "threads             = " << threads << "\n";
+        out << "chunks              = " << chunks << "\n";
+        out << "block_size_double   = " << blockSizeDouble << "\n";
+        out << "block_size_float    = " << blockSizeFloat << "\n";
+        out << "prefetch_distance   = " << prefetchDistance << "\n";
+        out << "streaming_threshold = " << streamingThreshold << "\n";
+
+        return bool(out);
+    }
+};
+
+// The profile in use, loaded on first use
+inline Profile& profile()
+{
+    static Profile instance = []()
+    {
+        Profile p;
+        if (const char * filename = std::getenv("FASTVECTOR_TUNING_PROFILE"))
+            if (!p.load(filename))
+                std::cerr << "Could not read the tuning profile " << filename << "!" << std::endl;
+        return p;
+    }();
+
+    return instance;
+}
+
+// the assignment unroll for elements of type T
+template <typename T>
+inline std::size_t blockSize()
+{
+    if constexpr (std::is_same<T, double>::value)
+        return profile().blockSizeDouble;
+    else if constexpr (std::is_same<T, float>::value)
+        return profile().blockSizeFloat;
+    else
+        return Expression::UnrollBlockSize<T>::value;
+}
+
+// the number of chunks of the chunked kernels
+inline std::size_t chunks()
+{
+    return profile().chunks;
+}
+
+} // end namespace
+
+#endif
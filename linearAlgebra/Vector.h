@@ -16,6 +16,7 @@
 #include "vector_detail.h"
 #include "Matrix.h"
 #include "Transform.h"
+#include "Quaternion.h"
 
 // Aligned Data types required for the solvers
 #include "AlignedVector.h"
@@ -33,8 +34,10 @@
 template <typename T, typename = Enable_if<Floating_Point<T>()> >
 auto Rotate(const ConstantVector<T, 3>& vector, ConstantVector<T, 3> axis, const T angle)
 {
-    // TODO in this case we dont have to assemble the inverse
-    auto rotate = BasicDatatypes::Transform<T>::rotate(axis, angle);
+    // the quaternion takes one sin and cos of the half angle, and fewer
+    // operations than assembling the matrix. It is only a rotation for a unit
+    // axis, so the axis is normalized first.
+    auto rotate = BasicDatatypes::Quaternion<T>::rotate(Normalize(axis), angle);
     return Apply(rotate, vector);
 }
 
@@ -52,8 +52,7 @@ template <typename E1, typename Functor, unsigned long Unroll = 1>
     using self = VectorReductionOperation<E1, Functor, Unroll>;
 
     using value_type  = typename E1::value_type;
-    //using result_type = typename Functor::result_type;
-    using result_type = typename E1::value_type;
+    using result_type = typename Functor::template result_type<typename E1::value_type>;
     using size_type   = typename E1::size_type;
 
     using first_argument_type   = E1;
@@ -65,12 +64,12 @@ template <typename E1, typename Functor, unsigned long Unroll = 1>
     // allow this expression to act like a normal scalar type
     operator result_type() const
     {
-        return reduction<Unroll, Functor, value_type>::apply(first);
+        return reduction<Unroll, Functor, result_type>::apply(first);
     }
 
     result_type get() const
     {
-       return reduction<Unroll, Functor, value_type>::apply(first);
+       return reduction<Unroll, Functor, result_type>::apply(first);
     }
 
     template <typename EE1, typename FFunctor>
@@ -103,7 +102,8 @@ template <typename E1, typename E2, typename Functor>
     using base = VectorExpression< VectorVectorBinaryExpression<E1, E2, Functor> >;
     using self = VectorVectorBinaryExpression<E1, E2, Functor>;
 
-    using value_type  = std::common_type_t<typename E1::value_type, typename E2::value_type>;
+    // the functor may change the type e.g. in comparisons
+    using value_type  = std::decay_t<typename Functor::result_type>;
     using result_type = typename Functor::result_type;
     using size_type   = Common_type<typename E1::size_type, typename E2::size_type>;
 
@@ -124,6 +124,10 @@ template <typename E1, typename E2, typename Functor>
         return (*this)(i);
     }
 
+    // the operands, for assignments which hand them to a kernel
+    first_argument_type  const& first_argument() const  { return first; }
+    second_argument_type const& second_argument() const { return second; }
+
     template <typename EE1, typename EE2, typename FFunctor>
     friend std::size_t size(const VectorVectorBinaryExpression<EE1, EE2, FFunctor>&);
 
@@ -151,7 +155,8 @@ struct VectorUnaryExpression : VectorExpression<VectorUnaryExpression<E1, Functo
     using base = VectorExpression< VectorUnaryExpression<E1, Functor> >;
     using self = VectorUnaryExpression<E1, Functor>;
 
-    using value_type  = std::common_type_t<typename E1::value_type>;
+    // the functor may change the type e.g. in cast<double>(x)
+    using value_type  = std::decay_t<typename Functor::result_type>;
     using result_type = typename Functor::result_type;
     using size_type   = Common_type<typename E1::size_type>;
 
@@ -171,6 +176,9 @@ struct VectorUnaryExpression : VectorExpression<VectorUnaryExpression<E1, Functo
         return (*this)(i);
     }
 
+    // the operand, for assignments which hand it to a kernel
+    first_argument_type const& first_argument() const { return first; }
+
     template <typename EE1, typename FFunctor>
     friend std::size_t size(const VectorUnaryExpression<EE1, FFunctor>&);
 
@@ -195,7 +203,7 @@ struct VectorScalarBinaryExpression : VectorExpression<VectorScalarBinaryExpress
     using base = VectorExpression< VectorScalarBinaryExpression <E1, E2, Functor> >;
     using self = VectorScalarBinaryExpression <E1, E2, Functor>;
 
-    using value_type  = std::common_type_t<typename E1::value_type, E2>;
+    using value_type  = std::decay_t<typename Functor::result_type>;
     using result_type = typename Functor::result_type;
     using size_type   = typename E1::size_type;
 
@@ -230,6 +238,85 @@ inline std::size_t size(const VectorScalarBinaryExpression<EE1, EE2, FFunctor>&
     return size(v.first);
 }
 
+//
+// VectorSelectExpression represents select(M, E1, E2) i.e. M(i) ? E1(i) : E2(i)
+// where M is a boolean vector expression, e.g. a CSVector<bool> or x > 0, and
+// E1, E2 are either of vector or of scalar type.
+//
+// Both operands are evaluated, so that the compiler can replace the branch by
+// a blend.
+//
+template <typename E, bool = Scalar<E>()>
+    struct SelectOperand
+    {
+        using value_type = typename E::value_type;
+        using storage    = E const&;
+
+        static inline value_type get(const E& e, std::size_t i) { return e(i); }
+    };
+
+template <typename E>
+    struct SelectOperand<E, true>
+    {
+        using value_type = E;
+        using storage    = const E;
+
+        static inline value_type get(const E& e, std::size_t) { return e; }
+    };
+
+template <typename M, typename E1, typename E2>
+struct VectorSelectExpression : VectorExpression<VectorSelectExpression<M, E1, E2> >
+{
+    using base = VectorExpression< VectorSelectExpression<M, E1, E2> >;
+    using self = VectorSelectExpression<M, E1, E2>;
+
+    using first_operand  = SelectOperand<E1>;
+    using second_operand = SelectOperand<E2>;
+
+    using value_type  = std::common_type_t<typename first_operand::value_type,
+                                           typename second_operand::value_type>;
+    using result_type = value_type;
+    using size_type   = typename M::size_type;
+
+    VectorSelectExpression(M const& m, E1 const& v1, E2 const& v2)
+        : mask(m), first(v1), second(v2)
+    {}
+
+    result_type operator()(size_type i) const
+    {
+        value_type v1 = first_operand::get(first, i);
+        value_type v2 = second_operand::get(second, i);
+        return mask(i) ? v1 : v2;
+    }
+
+    result_type operator[](size_type i) const
+    {
+        return (*this)(i);
+    }
+
+    template <typename MM, typename EE1, typename EE2>
+    friend std::size_t size(const VectorSelectExpression<MM, EE1, EE2>&);
+
+private:
+    M const&                            mask;
+    typename first_operand::storage     first;
+    typename second_operand::storage    second;
+};
+
+template <typename MM, typename EE1, typename EE2>
+inline std::size_t size(const VectorSelectExpression<MM, EE1, EE2>& v)
+{
+    if constexpr (!Scalar<EE1>())
+        if (size(v.mask) != size(v.first))
+            throw std::runtime_error("Incompatible vector lengths in vector select expression!");
+
+    if constexpr (!Scalar<EE2>())
+        if (size(v.mask) != size(v.second))
+            throw std::runtime_error("Incompatible vector lengths in vector select expression!");
+
+    return size(v.mask);
+}
+
 //
 // VectorVectorAssignmentOpExpression replaces
 //
@@ -13,6 +13,7 @@
 #include <functional>
 #include <iostream>
 #include <cmath>
+#include <complex>
 
 
 template<class T> struct Assign
@@ -171,6 +172,28 @@ struct product
     }
 };
 
+// The std::complex operator* checks the result for nan and inf and calls
+// __muldc3 to recover, which prevents gcc from vectorizing the loop. We don't
+// need C99 Annex G semantics so use the textbook formula.
+template <typename T>
+struct product<std::complex<T>, std::complex<T> >
+{
+    using first_argument_type   = const std::complex<T>&;
+    using second_argument_type  = const std::complex<T>&;
+    using result_type           = std::complex<T>;
+
+    static inline result_type apply(first_argument_type v1, second_argument_type v2)
+    {
+        return result_type(v1.real() * v2.real() - v1.imag() * v2.imag(),
+                           v1.real() * v2.imag() + v1.imag() * v2.real());
+    }
+
+    result_type operator()(first_argument_type v1, second_argument_type v2) const
+    {
+        return apply(v1, v2);
+    }
+};
+
 template <typename Value1, typename Value2>
 struct divide
 {
@@ -207,6 +230,115 @@ struct inverse_divide
     }
 };
 
+// Comparisons, these produce the elements of a CSVector<bool>
+template <typename Value1, typename Value2>
+struct compare_less
+{
+    using first_argument_type   = const Value1&;
+    using second_argument_type  = const Value2&;
+    using result_type           = bool;
+
+    static inline result_type apply(first_argument_type v1, second_argument_type v2)
+    {
+        return v1 < v2;
+    }
+
+    result_type operator()(first_argument_type v1, second_argument_type v2) const
+    {
+        return v1 < v2;
+    }
+};
+
+template <typename Value1, typename Value2>
+struct compare_less_equal
+{
+    using first_argument_type   = const Value1&;
+    using second_argument_type  = const Value2&;
+    using result_type           = bool;
+
+    static inline result_type apply(first_argument_type v1, second_argument_type v2)
+    {
+        return v1 <= v2;
+    }
+
+    result_type operator()(first_argument_type v1, second_argument_type v2) const
+    {
+        return v1 <= v2;
+    }
+};
+
+template <typename Value1, typename Value2>
+struct compare_greater
+{
+    using first_argument_type   = const Value1&;
+    using second_argument_type  = const Value2&;
+    using result_type           = bool;
+
+    static inline result_type apply(first_argument_type v1, second_argument_type v2)
+    {
+        return v1 > v2;
+    }
+
+    result_type operator()(first_argument_type v1, second_argument_type v2) const
+    {
+        return v1 > v2;
+    }
+};
+
+template <typename Value1, typename Value2>
+struct compare_greater_equal
+{
+    using first_argument_type   = const Value1&;
+    using second_argument_type  = const Value2&;
+    using result_type           = bool;
+
+    static inline result_type apply(first_argument_type v1, second_argument_type v2)
+    {
+        return v1 >= v2;
+    }
+
+    result_type operator()(first_argument_type v1, second_argument_type v2) const
+    {
+        return v1 >= v2;
+    }
+};
+
+template <typename Value1, typename Value2>
+struct compare_equal
+{
+    using first_argument_type   = const Value1&;
+    using second_argument_type  = const Value2&;
+    using result_type           = bool;
+
+    static inline result_type apply(first_argument_type v1, second_argument_type v2)
+    {
+        return v1 == v2;
+    }
+
+    result_type operator()(first_argument_type v1, second_argument_type v2) const
+    {
+        return v1 == v2;
+    }
+};
+
+template <typename Value1, typename Value2>
+struct compare_not_equal
+{
+    using first_argument_type   = const Value1&;
+    using second_argument_type  = const Value2&;
+    using result_type           = bool;
+
+    static inline result_type apply(first_argument_type v1, second_argument_type v2)
+    {
+        return v1 != v2;
+    }
+
+    result_type operator()(first_argument_type v1, second_argument_type v2) const
+    {
+        return v1 != v2;
+    }
+};
+
 template <typename Value1, typename Value2>
 struct assign
 {
@@ -315,6 +447,23 @@ struct identity
     }
 };
 
+template <typename Value1, typename Value2>
+struct conversion
+{
+    using argument_type = const Value1&;
+    using result_type   = Value2;
+
+    static inline result_type apply(argument_type v)
+    {
+        return static_cast<Value2>(v);
+    }
+
+    result_type operator() (argument_type v) const
+    {
+        return static_cast<Value2>(v);
+    }
+};
+
 template <typename Value>
 struct Abs
 {
@@ -332,6 +481,27 @@ struct Abs
     }
 };
 
+template <typename Value>
+struct Conj
+{
+    using argument_type = const Value&;
+    using result_type   = Value;
+
+    static inline result_type apply(argument_type v)
+    {
+        // std::conj of a real number returns a complex number
+        if constexpr (std::is_arithmetic<Value>::value)
+            return v;
+        else
+            return std::conj(v);
+    }
+
+    result_type operator() (argument_type v)
+    {
+        return apply(v);
+    }
+};
+
 template <typename Value>
 struct Exp
 {
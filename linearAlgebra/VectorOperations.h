@@ -19,30 +19,185 @@
 
 using namespace Expression;
 
+//
+// The norms of vectors with a length known at compile time (see FixedLength)
+// are evaluated right away and returned in the real type of their elements,
+// as for the ConstantVector overloads in vector_detail.h. Only run time
+// lengths are accumulated in Accumulate_type.
+//
 template <typename E1, unsigned long Unroll = 4>
-inline VectorReductionOperation<E1, two_norm_functor>
-Norm(const VectorExpression<E1>& e1)
+inline auto Norm(const VectorExpression<E1>& e1)
 {
-    using rtype = VectorReductionOperation<E1, two_norm_functor>;
-    return rtype(static_cast<const E1&>(e1));
+    if constexpr (FixedLength<E1>::value)
+    {
+        using result_type = two_norm_functor::result_type<typename E1::value_type>;
+        return Real_type<typename E1::value_type>(reduction<Unroll, two_norm_functor, result_type>::apply(static_cast<const E1&>(e1)));
+    }
+    else
+        return VectorReductionOperation<E1, two_norm_functor>(static_cast<const E1&>(e1));
 }
 
 template <typename E1, unsigned long Unroll = 4>
 inline auto Norm2(const VectorExpression<E1>& e1)
 {
-    using value_type = typename E1::value_type;
-    return reduction<Unroll, two_norm_functor, value_type>::apply(static_cast<const E1&>(e1));
+    using result_type = two_norm_functor::result_type<typename E1::value_type>;
+    const auto res = reduction<Unroll, two_norm_functor, result_type>::apply(static_cast<const E1&>(e1));
+
+    if constexpr (FixedLength<E1>::value)
+        return Real_type<typename E1::value_type>(res);
+    else
+        return res;
 }
 
 template <typename E1, unsigned long Unroll = 4>
 inline auto Norm2Squared(const VectorExpression<E1>& e1)
 {
-    using value_type = typename E1::value_type;
-    return reduction<Unroll, unary_dot, value_type>::apply(static_cast<const E1&>(e1));
+    using result_type = unary_dot::result_type<typename E1::value_type>;
+    const auto res = reduction<Unroll, unary_dot, result_type>::apply(static_cast<const E1&>(e1));
+
+    if constexpr (FixedLength<E1>::value)
+        return Real_type<typename E1::value_type>(res);
+    else
+        return res;
+}
+
+//
+// Reductions of arbitrary expressions. These evaluate the expression while
+// reducing, so that e.g.
+//
+//      auto err = supNorm(x - y);
+//
+// makes one pass over x and y without a temporary. Overloads for concrete
+// vectors, such as max(const CSVector<T>&), are preferred where they exist.
+//
+template <typename E1, unsigned long Unroll = 4>
+inline auto sum(const VectorExpression<E1>& e1)
+{
+    using result_type = sum_functor::result_type<typename E1::value_type>;
+    return reduction<Unroll, sum_functor, result_type>::apply(static_cast<const E1&>(e1));
+}
+
+template <typename E1, unsigned long Unroll = 4>
+inline auto mean(const VectorExpression<E1>& e1)
+{
+    const E1& e = static_cast<const E1&>(e1);
+    if (size(e) == 0)
+        throw std::runtime_error("Zero length vector!");
+
+    using result_type = sum_functor::result_type<typename E1::value_type>;
+    return reduction<Unroll, sum_functor, result_type>::apply(e) / Real_type<result_type>(size(e));
+}
+
+template <typename E1, unsigned long Unroll = 4>
+inline auto max(const VectorExpression<E1>& e1)
+{
+    static_assert(!Complex<typename E1::value_type>(), "max of a complex vector is not defined!");
+
+    const E1& e = static_cast<const E1&>(e1);
+    if (size(e) == 0)
+        throw std::runtime_error("Zero length vector!");
+
+    using result_type = max_functor::result_type<typename E1::value_type>;
+    return reduction<Unroll, max_functor, result_type>::apply(e);
+}
+
+template <typename E1, unsigned long Unroll = 4>
+inline auto min(const VectorExpression<E1>& e1)
+{
+    static_assert(!Complex<typename E1::value_type>(), "min of a complex vector is not defined!");
+
+    const E1& e = static_cast<const E1&>(e1);
+    if (size(e) == 0)
+        throw std::runtime_error("Zero length vector!");
+
+    using result_type = min_functor::result_type<typename E1::value_type>;
+    return reduction<Unroll, min_functor, result_type>::apply(e);
+}
+
+// returns the pair (min, max)
+template <typename E1, unsigned long Unroll = 4>
+inline auto minmax(const VectorExpression<E1>& e1)
+{
+    static_assert(!Complex<typename E1::value_type>(), "minmax of a complex vector is not defined!");
+
+    const E1& e = static_cast<const E1&>(e1);
+    if (size(e) == 0)
+        throw std::runtime_error("Zero length vector!");
+
+    using result_type = minmax_functor::result_type<typename E1::value_type>;
+    return reduction<Unroll, minmax_functor, result_type>::apply(e);
+}
+
+template <typename E1, unsigned long Unroll = 4>
+inline auto supNorm(const VectorExpression<E1>& e1)
+{
+    const E1& e = static_cast<const E1&>(e1);
+    if (size(e) == 0)
+        throw std::runtime_error("Zero length vector!");
+
+    using result_type = infinity_norm_functor::result_type<typename E1::value_type>;
+    return reduction<Unroll, infinity_norm_functor, result_type>::apply(e);
+}
+
+template <typename E1, unsigned long Unroll = 4>
+inline auto oneNorm(const VectorExpression<E1>& e1)
+{
+    using result_type = one_norm_functor::result_type<typename E1::value_type>;
+    return reduction<Unroll, one_norm_functor, result_type>::apply(static_cast<const E1&>(e1));
+}
+
+// Count, mean, variance and extrema in a single pass
+template <typename E1, unsigned long Unroll = 4>
+inline auto statistics(const VectorExpression<E1>& e1)
+{
+    static_assert(!Complex<typename E1::value_type>(), "statistics of a complex vector are not defined!");
+
+    using result_type = statistics_functor::result_type<typename E1::value_type>;
+    return reduction<Unroll, statistics_functor, result_type>::apply(static_cast<const E1&>(e1));
+}
+
+// As statistics, but also computes the third and fourth central moments
+template <typename E1, unsigned long Unroll = 4>
+inline auto moments(const VectorExpression<E1>& e1)
+{
+    static_assert(!Complex<typename E1::value_type>(), "moments of a complex vector are not defined!");
+
+    using result_type = moments_functor::result_type<typename E1::value_type>;
+    return reduction<Unroll, moments_functor, result_type>::apply(static_cast<const E1&>(e1));
+}
+
+// The Hermitian dot product sum conj(e1_k) e2_k of two expressions
+template <typename E1, typename E2>
+inline auto dot(const VectorExpression<E1>& e1, const VectorExpression<E2>& e2)
+{
+    return dot<4>(static_cast<const E1&>(e1), static_cast<const E2&>(e2));
+}
+
+// Converts the elements of e1 to To without creating a temporary, i.e.
+//
+//      y = a * cast<double>(xf);
+//
+// reads the float vector xf once and widens each element on the fly.
+template <typename To, typename E1>
+inline VectorUnaryExpression<E1, conversion<typename E1::value_type, To> >
+cast(const VectorExpression<E1>& e1)
+{
+    using rtype = VectorUnaryExpression<E1, conversion<typename E1::value_type, To> >;
+    return rtype(static_cast<const E1&>(e1));
+}
+
+// The scalars of the arithmetic operators are real or complex numbers, e.g.
+//
+//      z = std::complex<double>(0., 1.) * x + y;
+//
+template <typename T>
+constexpr bool ScalarOperand()
+{
+    return Scalar<T>() || Complex<T>();
 }
 
 template <typename E1, typename E2,
-          typename = Enable_if<Scalar<E2>()> >
+          typename = Enable_if<ScalarOperand<E2>()> >
 inline VectorScalarAssignmentOpExpression<E1, E2, plus_assign<typename E1::value_type, E2> >
 operator+= (VectorExpression<E1>& e1, const E2& e2)
 {
@@ -51,7 +206,7 @@ operator+= (VectorExpression<E1>& e1, const E2& e2)
 }
 
 template <typename E1, typename E2,
-          typename = Enable_if<Scalar<E2>()> >
+          typename = Enable_if<ScalarOperand<E2>()> >
 inline VectorScalarAssignmentOpExpression<E1, E2, minus_assign<typename E1::value_type, E2> >
 operator-= (VectorExpression<E1>& e1, const E2& e2)
 {
@@ -60,7 +215,7 @@ operator-= (VectorExpression<E1>& e1, const E2& e2)
 }
 
 template <typename E1, typename E2,
-          typename = Enable_if<Scalar<E2>()> >
+          typename = Enable_if<ScalarOperand<E2>()> >
 inline VectorScalarAssignmentOpExpression<E1, E2, product_assign<typename E1::value_type, E2> >
 operator*= (VectorExpression<E1>& e1, const E2& e2)
 {
@@ -69,7 +224,7 @@ operator*= (VectorExpression<E1>& e1, const E2& e2)
 }
 
 template <typename E1, typename E2,
-          typename = Enable_if<All(Scalar<E2>(), NotConst<E1>())> >
+          typename = Enable_if<All(ScalarOperand<E2>(), NotConst<E1>())> >
 inline VectorScalarAssignmentOpExpression<E1, E2, divide_assign<typename E1::value_type, E2> >
 operator/= (VectorExpression<E1>& e1, const E2& e2)
 {
@@ -78,7 +233,7 @@ operator/= (VectorExpression<E1>& e1, const E2& e2)
 }
 
 template <typename E1, typename E2,
-          typename = Enable_if<Scalar<E2>()> >
+          typename = Enable_if<ScalarOperand<E2>()> >
 inline VectorScalarBinaryExpression<E1, E2, plus_test<typename E1::value_type, E2> >
 operator+ (const VectorExpression<E1>& e1, const E2& e2)
 {
@@ -87,7 +242,7 @@ operator+ (const VectorExpression<E1>& e1, const E2& e2)
 }
 
 template <typename E1, typename E2,
-          typename = Enable_if<Scalar<E1>()> >
+          typename = Enable_if<ScalarOperand<E1>()> >
 inline VectorScalarBinaryExpression<E2, E1, plus_test<typename E2::value_type, E1> >
 operator+ (const E1& e1, const VectorExpression<E2>& e2)
 {
@@ -97,7 +252,7 @@ operator+ (const E1& e1, const VectorExpression<E2>& e2)
 
 
 template <typename E1, typename E2,
-          typename = Enable_if<Scalar<E2>()> >
+          typename = Enable_if<ScalarOperand<E2>()> >
 inline VectorScalarBinaryExpression<E1, E2, minus_test<typename E1::value_type, E2> >
 operator- (const VectorExpression<E1>& e1, const E2& e2)
 {
@@ -106,7 +261,7 @@ operator- (const VectorExpression<E1>& e1, const E2& e2)
 }
 
 template <typename E1, typename E2,
-          typename = Enable_if<Scalar<E1>()> >
+          typename = Enable_if<ScalarOperand<E1>()> >
 inline VectorScalarBinaryExpression<E2, E1, inverse_minus<typename E2::value_type, E1> >
 operator- (const E1& e1, const VectorExpression<E2>& e2)
 {
@@ -115,7 +270,7 @@ operator- (const E1& e1, const VectorExpression<E2>& e2)
 }
 
 template <typename E1, typename E2,
-          typename = Enable_if<Scalar<E1>()> >
+          typename = Enable_if<ScalarOperand<E1>()> >
 inline VectorScalarBinaryExpression<E2, E1, product<typename E2::value_type, E1> >
 operator* (const E1& e1, const VectorExpression<E2>& e2)
 {
@@ -124,7 +279,7 @@ operator* (const E1& e1, const VectorExpression<E2>& e2)
 }
 
 template <typename E1, typename E2,
-          typename = Enable_if<Scalar<E2>()>>
+          typename = Enable_if<ScalarOperand<E2>()>>
 inline VectorScalarBinaryExpression<E1, E2, product<typename E1::value_type, E2> >
 operator* (const VectorExpression<E1>& e1, const E2& e2)
 {
@@ -133,7 +288,7 @@ operator* (const VectorExpression<E1>& e1, const E2& e2)
 }
 
 template <typename E1, typename E2,
-          typename = Enable_if<Scalar<E1>()> >
+          typename = Enable_if<ScalarOperand<E1>()> >
 inline VectorScalarBinaryExpression<E2, E1, inverse_divide<typename E2::value_type, E1> >
 operator/ (const E1& e1, const VectorExpression<E2>& e2)
 {
@@ -142,7 +297,7 @@ operator/ (const E1& e1, const VectorExpression<E2>& e2)
 }
 
 template <typename E1, typename E2,
-          typename = Enable_if<Scalar<E2>()>>
+          typename = Enable_if<ScalarOperand<E2>()>>
 inline VectorScalarBinaryExpression<E1, E2, divide<typename E1::value_type, E2> >
 operator/ (const VectorExpression<E1>& e1, const E2& e2)
 {
@@ -198,6 +353,14 @@ abs(const VectorExpression<E1>& e1)
     return rtype(static_cast<const E1&>(e1));
 }
 
+template <typename E1>
+inline VectorUnaryExpression<E1, Conj<typename E1::value_type> >
+conj(const VectorExpression<E1>& e1)
+{
+    using rtype = VectorUnaryExpression<E1, Conj<typename E1::value_type> >;
+    return rtype(static_cast<const E1&>(e1));
+}
+
 template <typename E1>
 inline VectorUnaryExpression<E1, Exp<typename E1::value_type> >
 exp(const VectorExpression<E1>& e1)
@@ -263,4 +426,177 @@ operator/= (VectorExpression<E1>& e1, const VectorExpression<E2>& e2)
 }
 
 
+//
+// Comparisons produce boolean vector expressions which are evaluated into a
+// bit-packed CSVector<bool> (see DynamicBoolVector.h), e.g.
+//
+//      CSVector<bool> mask = (abs(r) < tol);
+//
+template <typename E1, typename E2>
+inline VectorVectorBinaryExpression<E1, E2, compare_less<typename E1::value_type, typename E2::value_type> >
+operator< (const VectorExpression<E1>& e1, const VectorExpression<E2>& e2)
+{
+    using rtype = VectorVectorBinaryExpression<E1, E2, compare_less<typename E1::value_type, typename E2::value_type> >;
+    return rtype(static_cast<const E1&>(e1), static_cast<const E2&>(e2));
+}
+
+template <typename E1, typename E2,
+          typename = Enable_if<Scalar<E2>()> >
+inline VectorScalarBinaryExpression<E1, E2, compare_less<typename E1::value_type, E2> >
+operator< (const VectorExpression<E1>& e1, const E2& e2)
+{
+    using rtype = VectorScalarBinaryExpression<E1, E2, compare_less<typename E1::value_type, E2> >;
+    return rtype(static_cast<const E1&>(e1), e2);
+}
+
+template <typename E1, typename E2,
+          typename = Enable_if<Scalar<E1>()> >
+inline VectorScalarBinaryExpression<E2, E1, compare_greater<typename E2::value_type, E1> >
+operator< (const E1& e1, const VectorExpression<E2>& e2)
+{
+    using rtype = VectorScalarBinaryExpression<E2, E1, compare_greater<typename E2::value_type, E1> >;
+    return rtype(static_cast<const E2&>(e2), e1);
+}
+
+template <typename E1, typename E2>
+inline VectorVectorBinaryExpression<E1, E2, compare_less_equal<typename E1::value_type, typename E2::value_type> >
+operator<= (const VectorExpression<E1>& e1, const VectorExpression<E2>& e2)
+{
+    using rtype = VectorVectorBinaryExpression<E1, E2, compare_less_equal<typename E1::value_type, typename E2::value_type> >;
+    return rtype(static_cast<const E1&>(e1), static_cast<const E2&>(e2));
+}
+
+template <typename E1, typename E2,
+          typename = Enable_if<Scalar<E2>()> >
+inline VectorScalarBinaryExpression<E1, E2, compare_less_equal<typename E1::value_type, E2> >
+operator<= (const VectorExpression<E1>& e1, const E2& e2)
+{
+    using rtype = VectorScalarBinaryExpression<E1, E2, compare_less_equal<typename E1::value_type, E2> >;
+    return rtype(static_cast<const E1&>(e1), e2);
+}
+
+template <typename E1, typename E2,
+          typename = Enable_if<Scalar<E1>()> >
+inline VectorScalarBinaryExpression<E2, E1, compare_greater_equal<typename E2::value_type, E1> >
+operator<= (const E1& e1, const VectorExpression<E2>& e2)
+{
+    using rtype = VectorScalarBinaryExpression<E2, E1, compare_greater_equal<typename E2::value_type, E1> >;
+    return rtype(static_cast<const E2&>(e2), e1);
+}
+
+template <typename E1, typename E2>
+inline VectorVectorBinaryExpression<E1, E2, compare_greater<typename E1::value_type, typename E2::value_type> >
+operator> (const VectorExpression<E1>& e1, const VectorExpression<E2>& e2)
+{
+    using rtype = VectorVectorBinaryExpression<E1, E2, compare_greater<typename E1::value_type, typename E2::value_type> >;
+    return rtype(static_cast<const E1&>(e1), static_cast<const E2&>(e2));
+}
+
+template <typename E1, typename E2,
+          typename = Enable_if<Scalar<E2>()> >
+inline VectorScalarBinaryExpression<E1, E2, compare_greater<typename E1::value_type, E2> >
+operator> (const VectorExpression<E1>& e1, const E2& e2)
+{
+    using rtype = VectorScalarBinaryExpression<E1, E2, compare_greater<typename E1::value_type, E2> >;
+    return rtype(static_cast<const E1&>(e1), e2);
+}
+
+template <typename E1, typename E2,
+          typename = Enable_if<Scalar<E1>()> >
+inline VectorScalarBinaryExpression<E2, E1, compare_less<typename E2::value_type, E1> >
+operator> (const E1& e1, const VectorExpression<E2>& e2)
+{
+    using rtype = VectorScalarBinaryExpression<E2, E1, compare_less<typename E2::value_type, E1> >;
+    return rtype(static_cast<const E2&>(e2), e1);
+}
+
+template <typename E1, typename E2>
+inline VectorVectorBinaryExpression<E1, E2, compare_greater_equal<typename E1::value_type, typename E2::value_type> >
+operator>= (const VectorExpression<E1>& e1, const VectorExpression<E2>& e2)
+{
+    using rtype = VectorVectorBinaryExpression<E1, E2, compare_greater_equal<typename E1::value_type, typename E2::value_type> >;
+    return rtype(static_cast<const E1&>(e1), static_cast<const E2&>(e2));
+}
+
+template <typename E1, typename E2,
+          typename = Enable_if<Scalar<E2>()> >
+inline VectorScalarBinaryExpression<E1, E2, compare_greater_equal<typename E1::value_type, E2> >
+operator>= (const VectorExpression<E1>& e1, const E2& e2)
+{
+    using rtype = VectorScalarBinaryExpression<E1, E2, compare_greater_equal<typename E1::value_type, E2> >;
+    return rtype(static_cast<const E1&>(e1), e2);
+}
+
+template <typename E1, typename E2,
+          typename = Enable_if<Scalar<E1>()> >
+inline VectorScalarBinaryExpression<E2, E1, compare_less_equal<typename E2::value_type, E1> >
+operator>= (const E1& e1, const VectorExpression<E2>& e2)
+{
+    using rtype = VectorScalarBinaryExpression<E2, E1, compare_less_equal<typename E2::value_type, E1> >;
+    return rtype(static_cast<const E2&>(e2), e1);
+}
+
+template <typename E1, typename E2>
+inline VectorVectorBinaryExpression<E1, E2, compare_equal<typename E1::value_type, typename E2::value_type> >
+operator== (const VectorExpression<E1>& e1, const VectorExpression<E2>& e2)
+{
+    using rtype = VectorVectorBinaryExpression<E1, E2, compare_equal<typename E1::value_type, typename E2::value_type> >;
+    return rtype(static_cast<const E1&>(e1), static_cast<const E2&>(e2));
+}
+
+template <typename E1, typename E2,
+          typename = Enable_if<Scalar<E2>()> >
+inline VectorScalarBinaryExpression<E1, E2, compare_equal<typename E1::value_type, E2> >
+operator== (const VectorExpression<E1>& e1, const E2& e2)
+{
+    using rtype = VectorScalarBinaryExpression<E1, E2, compare_equal<typename E1::value_type, E2> >;
+    return rtype(static_cast<const E1&>(e1), e2);
+}
+
+template <typename E1, typename E2,
+          typename = Enable_if<Scalar<E1>()> >
+inline VectorScalarBinaryExpression<E2, E1, compare_equal<typename E2::value_type, E1> >
+operator== (const E1& e1, const VectorExpression<E2>& e2)
+{
+    using rtype = VectorScalarBinaryExpression<E2, E1, compare_equal<typename E2::value_type, E1> >;
+    return rtype(static_cast<const E2&>(e2), e1);
+}
+
+template <typename E1, typename E2>
+inline VectorVectorBinaryExpression<E1, E2, compare_not_equal<typename E1::value_type, typename E2::value_type> >
+operator!= (const VectorExpression<E1>& e1, const VectorExpression<E2>& e2)
+{
+    using rtype = VectorVectorBinaryExpression<E1, E2, compare_not_equal<typename E1::value_type, typename E2::value_type> >;
+    return rtype(static_cast<const E1&>(e1), static_cast<const E2&>(e2));
+}
+
+template <typename E1, typename E2,
+          typename = Enable_if<Scalar<E2>()> >
+inline VectorScalarBinaryExpression<E1, E2, compare_not_equal<typename E1::value_type, E2> >
+operator!= (const VectorExpression<E1>& e1, const E2& e2)
+{
+    using rtype = VectorScalarBinaryExpression<E1, E2, compare_not_equal<typename E1::value_type, E2> >;
+    return rtype(static_cast<const E1&>(e1), e2);
+}
+
+template <typename E1, typename E2,
+          typename = Enable_if<Scalar<E1>()> >
+inline VectorScalarBinaryExpression<E2, E1, compare_not_equal<typename E2::value_type, E1> >
+operator!= (const E1& e1, const VectorExpression<E2>& e2)
+{
+    using rtype = VectorScalarBinaryExpression<E2, E1, compare_not_equal<typename E2::value_type, E1> >;
+    return rtype(static_cast<const E2&>(e2), e1);
+}
+
+// If mask(i) is true select e1(i), otherwise e2(i). Either of e1 and e2 may be
+// a scalar.
+template <typename M, typename E1, typename E2>
+inline VectorSelectExpression<M, E1, E2>
+select(const VectorExpression<M>& mask, const E1& e1, const E2& e2)
+{
+    using rtype = VectorSelectExpression<M, E1, E2>;
+    return rtype(static_cast<const M&>(mask), e1, e2);
+}
+
+
 #endif
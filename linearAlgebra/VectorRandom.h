@@ -0,0 +1,315 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  File Name:  VectorRandom.h                                                //
+//                                                                            //
+//     Author:  Andreas Buttenschoen <andreas@buttenschoen.ca>                //
+//    Created:  2026-10-18 21:05:37                                           //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef VECTOR_RANDOM_H
+#define VECTOR_RANDOM_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#include "DynamicVector.h"
+
+//
+// Counter based random numbers (Salmon et al., "Parallel random numbers: as
+// easy as 1, 2, 3", SC11). Philox4x32-10 maps a 128-bit counter and a 64-bit
+// key to 128 random bits, so element i is a pure function of (seed, i):
+//
+//      fillNormal(x, seed);              // in parallel
+//      x = a + b * randn(n, seed);       // without storage
+//
+// give the same numbers whatever the number of threads, and whichever of
+// the two forms is used. Each counter block yields two elements: the
+// uniforms are built from 53 random bits, and the normals by the Box-Muller
+// transform of the block's two uniforms. Uniforms and normals use different
+// counter streams. The numbers are generated in double, and rounded to the
+// element type; uniforms which round up to the end of the interval are moved
+// below it.
+//
+// The fills, and the assignment of a generator to a vector, transform both
+// elements of a block, and generate the blocks of many elements in SIMD lanes.
+// In a longer expression such as a + b * randn(n, seed) each element generates
+// its own block, and computes only its half of the pair.
+//
+// The generators carry their length, as the other expressions take theirs
+// from their vector operands.
+//
+namespace impl {
+
+// the rounds on the four words of the counter, which stay in registers
+inline void philox4x32(uint32_t& x0, uint32_t& x1, uint32_t& x2, uint32_t& x3, uint32_t k0, uint32_t k1)
+{
+    constexpr uint32_t M0 = 0xD2511F53u, M1 = 0xCD9E8D57u;
+    constexpr uint32_t W0 = 0x9E3779B9u, W1 = 0xBB67AE85u;
+
+    #pragma GCC unroll 10
+    for (int round = 0; round < 10; ++round)
+    {
+        const uint64_t p0 = uint64_t(M0) * x0;
+        const uint64_t p1 = uint64_t(M1) * x2;
+
+        x0 = uint32_t(p1 >> 32) ^ x1 ^ k0;
+        x2 = uint32_t(p0 >> 32) ^ x3 ^ k1;
+        x1 = uint32_t(p1);
+        x3 = uint32_t(p0);
+
+        k0 += W0;
+        k1 += W1;
+    }
+}
+
+inline void philox4x32(uint32_t ctr[4], uint32_t k0, uint32_t k1)
+{
+    philox4x32(ctr[0], ctr[1], ctr[2], ctr[3], k0, k1);
+}
+
+enum random_stream : uint32_t { uniform_stream = 0, normal_stream = 1 };
+
+// the 128 random bits of counter block b
+inline void random_block(uint64_t seed, uint32_t stream, uint64_t b, uint32_t r[4])
+{
+    r[0] = uint32_t(b);
+    r[1] = uint32_t(b >> 32);
+    r[2] = stream;
+    r[3] = 0;
+    philox4x32(r, uint32_t(seed), uint32_t(seed >> 32));
+}
+
+// The random bits of the counter blocks [b, b + n), n <= RandomBlocks, one
+// array per word. The blocks are independent, so that their rounds run in the
+// SIMD lanes.
+constexpr size_t RandomBlocks = 64;
+
+inline void random_blocks(uint64_t seed, uint32_t stream, uint64_t b, size_t n, uint32_t r[4][RandomBlocks])
+{
+    #pragma omp simd
+    for (size_t j = 0; j < n; ++j)
+    {
+        uint32_t x0 = uint32_t(b + j), x1 = uint32_t((b + j) >> 32), x2 = stream, x3 = 0;
+        philox4x32(x0, x1, x2, x3, uint32_t(seed), uint32_t(seed >> 32));
+
+        r[0][j] = x0;
+        r[1][j] = x1;
+        r[2][j] = x2;
+        r[3][j] = x3;
+    }
+}
+
+// uniform in [0, 1) from 53 random bits
+inline double to_unit(uint32_t hi, uint32_t lo)
+{
+    return double(((uint64_t(hi) << 32) | lo) >> 11) * 0x1.0p-53;
+}
+
+//
+// The distributions map the bits r0 .. r3 of a counter block to its two
+// elements, or to one of them, and scale them to the element type.
+//
+struct uniform_distribution
+{
+    static constexpr uint32_t stream = uniform_stream;
+
+    static inline void pair(uint32_t r0, uint32_t r1, uint32_t r2, uint32_t r3, double& u0, double& u1)
+    {
+        u0 = to_unit(r0, r1);
+        u1 = to_unit(r2, r3);
+    }
+
+    static inline double value(uint32_t r0, uint32_t r1, uint32_t r2, uint32_t r3, bool second)
+    {
+        return second ? to_unit(r2, r3) : to_unit(r0, r1);
+    }
+
+    // in [lo, hi): rounded to T, e.g. float, lo + (hi - lo) u can reach hi,
+    // which is replaced by the largest T below it
+    template <typename T>
+    static inline T to(double u, const T lo, const T hi)
+    {
+        const T x = T(lo + T(hi - lo) * u);
+        return (x < hi) ? x : std::nextafter(hi, lo);
+    }
+};
+
+struct normal_distribution
+{
+    static constexpr uint32_t stream = normal_stream;
+
+    // the Box-Muller transform, 1 - u is in (0, 1] so the log is finite
+    static inline double radius(uint32_t r0, uint32_t r1)
+    {
+        return std::sqrt(-2. * std::log(1. - to_unit(r0, r1)));
+    }
+
+    static inline double angle(uint32_t r2, uint32_t r3)
+    {
+        return 2. * M_PI * to_unit(r2, r3);
+    }
+
+    static inline void pair(uint32_t r0, uint32_t r1, uint32_t r2, uint32_t r3, double& z0, double& z1)
+    {
+        const double rho   = radius(r0, r1);
+        const double theta = angle(r2, r3);
+
+        z0 = rho * std::cos(theta);
+        z1 = rho * std::sin(theta);
+    }
+
+    static inline double value(uint32_t r0, uint32_t r1, uint32_t r2, uint32_t r3, bool second)
+    {
+        const double theta = angle(r2, r3);
+        return radius(r0, r1) * (second ? std::sin(theta) : std::cos(theta));
+    }
+
+    template <typename T>
+    static inline T to(double z, const T mean, const T sd)
+    {
+        return T(mean + sd * z);
+    }
+};
+
+//
+// Fills v with the elements of Distribution, one counter block per two
+// elements. Each thread generates the bits of RandomBlocks blocks at a time,
+// and transforms them into both elements of each block.
+//
+template <typename Distribution, typename T>
+void random_fill(CSVector<T>& v, uint64_t seed, const T p0, const T p1)
+{
+    const size_t Threads = Tuning::profile().threads;
+
+    const size_t N         = v.size();
+    const size_t NO_BLOCKS = (N + 1) / 2;
+    const size_t NO_CHUNKS = (NO_BLOCKS + RandomBlocks - 1) / RandomBlocks;
+    T * a = v.data();
+
+    #pragma omp parallel for num_threads(Threads)
+    for (size_t c = 0; c < NO_CHUNKS; ++c)
+    {
+        const size_t b0 = c * RandomBlocks;
+        const size_t n  = std::min(RandomBlocks, NO_BLOCKS - b0);
+
+        uint32_t r[4][RandomBlocks];
+        random_blocks(seed, Distribution::stream, b0, n, r);
+
+        for (size_t j = 0; j < n; ++j)
+        {
+            double x0, x1;
+            Distribution::pair(r[0][j], r[1][j], r[2][j], r[3][j], x0, x1);
+
+            const size_t i = 2 * (b0 + j);
+            a[i] = Distribution::to(x0, p0, p1);
+            if (i + 1 < N)
+                a[i + 1] = Distribution::to(x1, p0, p1);
+        }
+    }
+}
+
+} // end namespace
+
+template <typename T, typename Distribution>
+struct VectorRandomExpression : VectorExpression<VectorRandomExpression<T, Distribution> >
+{
+    using value_type  = T;
+    using result_type = T;
+    using size_type   = std::size_t;
+
+    VectorRandomExpression(size_type n, uint64_t seed)
+        : n(n), seed(seed)
+    {}
+
+    // only the element i of its counter block, see the assignment below
+    result_type operator()(size_type i) const
+    {
+        uint32_t r[4];
+        impl::random_block(seed, Distribution::stream, i / 2, r);
+        return Distribution::to(Distribution::value(r[0], r[1], r[2], r[3], i & 1), T(0), T(1));
+    }
+
+    uint64_t get_seed() const
+    {
+        return seed;
+    }
+
+    result_type operator[](size_type i) const
+    {
+        return (*this)(i);
+    }
+
+    template <typename TT, typename DD>
+    friend std::size_t size(const VectorRandomExpression<TT, DD>&);
+
+private:
+    size_type n;
+    uint64_t  seed;
+};
+
+template <typename TT, typename DD>
+inline std::size_t size(const VectorRandomExpression<TT, DD>& v)
+{
+    return v.n;
+}
+
+namespace Expression {
+
+template <typename T, typename Distribution>
+    struct AssignShapeHelper<VectorRandomExpression<T, Distribution> >
+    {
+        using type = Vector<scalar>;
+    };
+
+// x = randn(n, seed) uses both elements of each counter block, i.e. it is
+// fillNormal(x, seed)
+template <typename T, typename Distribution>
+struct VectorAssignment<CSVector<T>, VectorRandomExpression<T, Distribution> >
+{
+    using type = CSVector<T>&;
+    type operator()(CSVector<T>& vector, const VectorRandomExpression<T, Distribution>& src)
+    {
+        if (vector.size() != size(src))
+            throw std::runtime_error("Incompatible vector lengths " + std::to_string(vector.size())
+                                     + " " + std::to_string(size(src)) + "(random) !");
+
+        impl::random_fill<Distribution>(vector, src.get_seed(), T(0), T(1));
+        return vector;
+    }
+};
+
+} // end namespace
+
+// n uniform numbers in [0, 1)
+template <typename T = double>
+inline VectorRandomExpression<T, impl::uniform_distribution> randu(std::size_t n, uint64_t seed)
+{
+    return VectorRandomExpression<T, impl::uniform_distribution>(n, seed);
+}
+
+// n standard normal numbers
+template <typename T = double>
+inline VectorRandomExpression<T, impl::normal_distribution> randn(std::size_t n, uint64_t seed)
+{
+    return VectorRandomExpression<T, impl::normal_distribution>(n, seed);
+}
+
+// uniform in [lo, hi)
+template <typename T>
+void fillUniform(CSVector<T>& v, uint64_t seed, const T lo = T(0), const T hi = T(1))
+{
+    impl::random_fill<impl::uniform_distribution>(v, seed, lo, hi);
+}
+
+// normal with the given mean and standard deviation
+template <typename T>
+void fillNormal(CSVector<T>& v, uint64_t seed, const T mean = T(0), const T sd = T(1))
+{
+    impl::random_fill<impl::normal_distribution>(v, seed, mean, sd);
+}
+
+#endif
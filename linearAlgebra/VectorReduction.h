@@ -11,7 +11,21 @@
 #define CS_VECTOR_REDUCTION_H
 
 #include <iostream>
+#include <algorithm>
 #include <cmath>
+#include <complex>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "concepts.h"
+#include "VectorTraits.h"
+#include "TuningProfile.h"
+#include "Instrumentation.h"
+#include "Trace.h"
+#include "type_info.h"
 
 using std::abs;
 using std::max;
@@ -22,8 +36,29 @@ T zero(T value)
     return T(0);
 }
 
+// squared modulus of x, computed in the precision of Value
+template <typename Value, typename Element>
+inline Value abs2(const Element& x)
+{
+    return Value(x) * Value(x);
+}
+
+template <typename Value, typename T>
+inline Value abs2(const std::complex<T>& x)
+{
+    return Value(x.real()) * Value(x.real()) + Value(x.imag()) * Value(x.imag());
+}
+
+//
+// The functors define the type of their result for a given element type.
+// Norms are real, even for complex vectors.
+//
+
 struct one_norm_functor
 {
+    template <typename Element>
+    using result_type = Expression::Accumulate_type<Expression::Real_type<Element> >;
+
     template <typename Value>
     static inline void init(Value& value)
     {
@@ -51,6 +86,9 @@ struct one_norm_functor
 
 struct sum_functor
 {
+    template <typename Element>
+    using result_type = Expression::Accumulate_type<Element>;
+
     template <typename Value>
     static inline void init(Value& value)
     {
@@ -78,6 +116,9 @@ struct sum_functor
 
 struct product_functor
 {
+    template <typename Element>
+    using result_type = Expression::Accumulate_type<Element>;
+
     template <typename Value>
     static inline void init(Value& value)
     {
@@ -105,6 +146,9 @@ struct product_functor
 
 struct two_norm_functor
 {
+    template <typename Element>
+    using result_type = Expression::Accumulate_type<Expression::Real_type<Element> >;
+
     template <typename Value>
     static inline void init(Value& value)
     {
@@ -114,7 +158,8 @@ struct two_norm_functor
     template <typename Value, typename Element>
     static inline void update(Value& value, const Element& x)
     {
-        value += x * x;
+        // widen first, the accumulator may be of higher precision
+        value += abs2<Value>(x);
     }
 
     template <typename Value>
@@ -142,6 +187,9 @@ struct unary_dot : two_norm_functor
 
 struct infinity_norm_functor
 {
+    template <typename Element>
+    using result_type = Expression::Accumulate_type<Expression::Real_type<Element> >;
+
     template <typename Value>
     static inline void init(Value& value)
     {
@@ -151,7 +199,7 @@ struct infinity_norm_functor
     template <typename Value, typename Element>
     static inline void update(Value& value, const Element& x)
     {
-        value = max(value, abs(x));
+        value = max(value, Value(abs(x)));
     }
 
     template <typename Value>
@@ -167,6 +215,219 @@ struct infinity_norm_functor
     }
 };
 
+//
+// The extrema are only defined for real elements. They are written as
+// selects rather than std::max so that gcc turns them into vector max / min
+// instructions.
+//
+struct max_functor
+{
+    template <typename Element>
+    using result_type = Expression::Compute_type<Element>;
+
+    template <typename Value>
+    static inline void init(Value& value)
+    {
+        value = std::numeric_limits<Value>::lowest();
+    }
+
+    template <typename Value, typename Element>
+    static inline void update(Value& value, const Element& x)
+    {
+        value = Value(x) > value ? Value(x) : value;
+    }
+
+    template <typename Value>
+    static inline void finish(Value& value, const Value& value2)
+    {
+        value = value2 > value ? value2 : value;
+    }
+
+    template <typename Value>
+    static inline Value post_reduction(const Value& value)
+    {
+        return value;
+    }
+};
+
+struct min_functor
+{
+    template <typename Element>
+    using result_type = Expression::Compute_type<Element>;
+
+    template <typename Value>
+    static inline void init(Value& value)
+    {
+        value = std::numeric_limits<Value>::max();
+    }
+
+    template <typename Value, typename Element>
+    static inline void update(Value& value, const Element& x)
+    {
+        value = Value(x) < value ? Value(x) : value;
+    }
+
+    template <typename Value>
+    static inline void finish(Value& value, const Value& value2)
+    {
+        value = value2 < value ? value2 : value;
+    }
+
+    template <typename Value>
+    static inline Value post_reduction(const Value& value)
+    {
+        return value;
+    }
+};
+
+// Both extrema in one pass, the result is the pair (min, max).
+struct minmax_functor
+{
+    template <typename Element>
+    using result_type = std::pair<Expression::Compute_type<Element>, Expression::Compute_type<Element> >;
+
+    template <typename Value>
+    static inline void init(Value& value)
+    {
+        min_functor::init(value.first);
+        max_functor::init(value.second);
+    }
+
+    template <typename Value, typename Element>
+    static inline void update(Value& value, const Element& x)
+    {
+        min_functor::update(value.first,  x);
+        max_functor::update(value.second, x);
+    }
+
+    template <typename Value>
+    static inline void finish(Value& value, const Value& value2)
+    {
+        min_functor::finish(value.first,  value2.first);
+        max_functor::finish(value.second, value2.second);
+    }
+
+    template <typename Value>
+    static inline Value post_reduction(const Value& value)
+    {
+        return value;
+    }
+};
+
+//
+// One pass statistics. Each accumulator keeps the count, mean and central
+// moment sums M_k = sum (x_i - mean)^k together with the extrema, and is
+// updated by Welford's method. The accumulators of the unrolled lanes and
+// threads are combined by the pairwise formulas of Chan et al. This avoids
+// the cancellation of the textbook sum(x^2) - n mean^2.
+//
+template <typename T>
+struct VectorStatistics
+{
+    std::size_t count;
+    T mean;
+    T M2, M3, M4;
+    T min, max;
+
+    T variance() const       { return M2 / T(count); }
+    T sampleVariance() const { return M2 / T(count - 1); }
+
+    // only computed by moments()
+    T skewness() const { return std::sqrt(T(count)) * M3 / std::pow(M2, T(1.5)); }
+    T kurtosis() const { return T(count) * M4 / (M2 * M2); }
+};
+
+template <bool HigherMoments>
+struct statistics_functor_base
+{
+    template <typename Element>
+    using result_type = VectorStatistics<Expression::Accumulate_type<Element> >;
+
+    template <typename Value>
+    static inline void init(Value& value)
+    {
+        using T = decltype(value.mean);
+        value.count = 0;
+        value.mean  = value.M2 = value.M3 = value.M4 = T(0);
+        value.min   = std::numeric_limits<T>::max();
+        value.max   = std::numeric_limits<T>::lowest();
+    }
+
+    template <typename Value, typename Element>
+    static inline void update(Value& value, const Element& x)
+    {
+        using T = decltype(value.mean);
+        const T y  = T(x);
+        const T n1 = T(value.count);
+        const T n  = T(++value.count);
+
+        const T delta   = y - value.mean;
+        const T delta_n = delta / n;
+        const T term1   = delta * delta_n * n1;
+
+        value.mean += delta_n;
+        if (HigherMoments)
+        {
+            const T delta_n2 = delta_n * delta_n;
+            value.M4 += term1 * delta_n2 * (n * n - T(3) * n + T(3))
+                + T(6) * delta_n2 * value.M2 - T(4) * delta_n * value.M3;
+            value.M3 += term1 * delta_n * (n - T(2)) - T(3) * delta_n * value.M2;
+        }
+        value.M2 += term1;
+
+        value.min = y < value.min ? y : value.min;
+        value.max = y > value.max ? y : value.max;
+    }
+
+    template <typename Value>
+    static inline void finish(Value& value, const Value& value2)
+    {
+        using T = decltype(value.mean);
+        if (value2.count == 0)
+            return;
+
+        if (value.count == 0)
+        {
+            value = value2;
+            return;
+        }
+
+        const T na = T(value.count);
+        const T nb = T(value2.count);
+        const T n  = na + nb;
+
+        const T delta  = value2.mean - value.mean;
+        const T delta2 = delta * delta;
+
+        if (HigherMoments)
+        {
+            value.M4 += value2.M4 + delta2 * delta2 * na * nb * (na * na - na * nb + nb * nb) / (n * n * n)
+                + T(6) * delta2 * (na * na * value2.M2 + nb * nb * value.M2) / (n * n)
+                + T(4) * delta * (na * value2.M3 - nb * value.M3) / n;
+            value.M3 += value2.M3 + delta2 * delta * na * nb * (na - nb) / (n * n)
+                + T(3) * delta * (na * value2.M2 - nb * value.M2) / n;
+        }
+        value.M2   += value2.M2 + delta2 * na * nb / n;
+        value.mean += delta * nb / n;
+        value.count = value.count + value2.count;
+
+        value.min = value2.min < value.min ? value2.min : value.min;
+        value.max = value2.max > value.max ? value2.max : value.max;
+    }
+
+    template <typename Value>
+    static inline Value post_reduction(const Value& value)
+    {
+        return value;
+    }
+};
+
+// count, mean, M2 and the extrema
+using statistics_functor = statistics_functor_base<false>;
+
+// as above and M3, M4
+using moments_functor = statistics_functor_base<true>;
+
 namespace impl {
 
     template <unsigned long Index0, unsigned long Max0, typename Functor>
@@ -218,41 +479,69 @@ namespace impl {
 } // end namespace
 
 
+//
+// The reductions split the vector into Tuning::chunks() contiguous chunks,
+// which are reduced in parallel, and the partial results are then combined in
+// order. Hence the result depends on the chunks of the tuning profile, but not
+// on the threads of the assignment. Small vectors are reduced in one chunk on
+// the calling thread.
+//
+static constexpr std::size_t ReductionParallelThreshold = 1 << 15;
+
 template <unsigned long Unroll, typename Functor, typename Result>
 struct reduction
 {
-    template <typename Vector>
-    static inline Result apply(const Vector& v)
+    // reduce the elements [begin, end) of v into result
+    template <typename Vector, typename Size>
+    static inline void apply(const Vector& v, Size begin, Size end, Result& result)
     {
-        //using value_type  = typename Vector::value_type;
-        using size_type   = typename Vector::size_type;
+        constexpr Size UNROLL = std::min(Size(Unroll), Size(8));
 
-        Result result;
         Result tmp00, tmp01, tmp02, tmp03, tmp04, tmp05, tmp06, tmp07;
+        auto sb = begin + (end - begin) / UNROLL * UNROLL;
 
-        constexpr size_type UNROLL = std::min(Unroll, size_type(8));
+        Functor::init(result);
+        impl::reduction<0, UNROLL-1, Functor>::init(tmp00, tmp01, tmp02, tmp03, tmp04, tmp05, tmp06, tmp07);
 
-        auto s  = size(v);
-        auto sb = s / UNROLL * UNROLL;
+        for (Size i = begin; i < sb; i+=UNROLL)
+            impl::reduction<0, UNROLL-1, Functor>::update(tmp00, tmp01, tmp02, tmp03, tmp04, tmp05, tmp06, tmp07, v, i);
 
-        Functor::init(result);
+        impl::reduction<0, UNROLL-1, Functor>::finish(tmp00, tmp01, tmp02, tmp03, tmp04, tmp05, tmp06, tmp07);
+        Functor::finish(result, tmp00);
 
-        //#pragma omp parallel
-        {
-            impl::reduction<0, UNROLL-1, Functor>::init(tmp00, tmp01, tmp02, tmp03, tmp04, tmp05, tmp06, tmp07);
+        for (Size i = sb; i < end; i++)
+            Functor::update(result, v[i]);
+    }
+
+    template <typename Vector>
+    static inline Result apply(const Vector& v)
+    {
+        using size_type = typename Vector::size_type;
+        const size_type Threads = Tuning::chunks();
 
-            //#pragma omp for
-            for (size_t i = 0; i < sb; i+=UNROLL)
-                impl::reduction<0, UNROLL-1, Functor>::update(tmp00, tmp01, tmp02, tmp03, tmp04, tmp05, tmp06, tmp07, v, i);
+        const size_type s = size(v);
 
-            impl::reduction<0, UNROLL-1, Functor>::finish(tmp00, tmp01, tmp02, tmp03, tmp04, tmp05, tmp06, tmp07);
+        FASTVECTOR_INSTRUMENT((type_name<Functor, Result>()), s, s * sizeof(typename Vector::value_type));
 
-            //#pragma omp critical
-            Functor::finish(result, tmp00);
+        Result result;
+        if (s < ReductionParallelThreshold)
+        {
+            apply(v, size_type(0), s, result);
+            return Functor::post_reduction(result);
         }
 
-        for (size_t i = sb; i < s; i++)
-            Functor::update(result, v[i]);
+        std::vector<Result> partial(Threads);
+
+        #pragma omp parallel for num_threads(Threads)
+        for (size_type c = 0; c < Threads; ++c)
+        {
+            FASTVECTOR_TRACE((type_name<Functor, Vector>()), s);
+            apply(v, c * s / Threads, (c + 1) * s / Threads, partial[c]);
+        }
+
+        result = partial[0];
+        for (size_type c = 1; c < Threads; ++c)
+            Functor::finish(result, partial[c]);
 
         return Functor::post_reduction(result);
     }
@@ -261,6 +550,24 @@ struct reduction
 
 namespace impl {
 
+    // value + conj(a) * b, i.e. the update of the Hermitian dot product
+    template <typename Value, typename T, typename U>
+    inline Value dot_update(const T& a, const U& b, const Value& value)
+    {
+        return std::fma(Value(a), Value(b), value);
+    }
+
+    // avoid the std::complex operator* which checks for nan and inf
+    template <typename Value, typename T, typename U>
+    inline Value dot_update(const std::complex<T>& a, const std::complex<U>& b, const Value& value)
+    {
+        using R = typename Value::value_type;
+        R ar = R(a.real()), ai = R(a.imag());
+        R br = R(b.real()), bi = R(b.imag());
+        return Value(value.real() + ar * br + ai * bi,
+                     value.imag() + ar * bi - ai * br);
+    }
+
     template <unsigned long Index0, unsigned long Max0>
     struct dot_aux
     {
@@ -269,7 +576,7 @@ namespace impl {
         template <typename Value, typename Vector1, typename Vector2, typename Size>
         static inline void apply(Value& tmp00, Value& tmp01, Value& tmp02, Value& tmp03, Value& tmp04, Value& tmp05, Value& tmp06, Value& tmp07, const Vector1& v1, const Vector2& v2, Size i)
         {
-            tmp00 = std::fma(v1[i + Index0], v2[i + Index0], tmp00);
+            tmp00 = dot_update(v1[i + Index0], v2[i + Index0], tmp00);
             next::apply(tmp01, tmp02, tmp03, tmp04, tmp05, tmp06, tmp07, tmp00, v1, v2, i);
         }
     };
@@ -280,40 +587,66 @@ namespace impl {
         template <typename Value, typename Vector1, typename Vector2, typename Size>
         static inline void apply(Value& tmp00, Value&, Value&, Value&, Value&, Value&, Value&, Value&, const Vector1& v1, const Vector2& v2, Size i)
         {
-            tmp00 = std::fma(v1[i + Max0], v2[i + Max0], tmp00);
+            tmp00 = dot_update(v1[i + Max0], v2[i + Max0], tmp00);
         }
     };
 
     template <unsigned long Unroll>
     struct dot
     {
+        // the dot product of the elements [begin, end)
+        template <typename Value, typename Vector1, typename Vector2, typename Size>
+        static inline Value apply(const Vector1& v1, const Vector2& v2, Size begin, Size end)
+        {
+            constexpr Size UNROLL = std::min(Size(Unroll), Size(8));
+
+            Value z = Value(0);
+            Value tmp00 = z, tmp01 = z, tmp02 = z, tmp03 = z, tmp04 = z, tmp05 = z, tmp06 = z, tmp07 = z;
+
+            const Size sb = begin + (end - begin) / UNROLL * UNROLL;
+            for (Size i = begin; i < sb; i+=UNROLL)
+                dot_aux<0, UNROLL-1>::apply(tmp00, tmp01, tmp02, tmp03, tmp04, tmp05, tmp06, tmp07, v1, v2, i);
+
+            Value result = ((tmp00 + tmp01) + (tmp02 + tmp03)) + ((tmp04 + tmp05) + (tmp06 + tmp07));
+
+            for (Size i = sb; i < end; i++)
+                result = dot_update(v1[i], v2[i], result);
+
+            return result;
+        }
+
         template <typename Vector1, typename Vector2>
         static inline auto apply(const Vector1& v1, const Vector2& v2)
         {
-            using value_type  = typename Vector1::value_type;
+            using value_type  = Expression::Accumulate_type<Common_type<typename Vector1::value_type,
+                                                                        typename Vector2::value_type> >;
             using size_type   = typename Vector1::size_type;
-            value_type z      = value_type(0);
-            value_type result = z;
+            const size_type Threads = Tuning::chunks();
 
-            constexpr size_type UNROLL = std::min(Unroll, size_type(8));
+            const size_type N = size(v1);
+            if (N != size(v2))
+                throw std::runtime_error("Incompatible vector lengths " + std::to_string(N)
+                                         + " " + std::to_string(size(v2)) + "(dot) !");
 
-            const size_type N        = size(v1);
-            const size_type no_loops = N / UNROLL;
+            FASTVECTOR_INSTRUMENT(("dot, " + type_name<typename Vector1::value_type, typename Vector2::value_type>()),
+                                  N, N * (sizeof(typename Vector1::value_type) + sizeof(typename Vector2::value_type)));
 
-            //#pragma omp parallel
-            {
-                value_type tmp00 = z, tmp01 = z, tmp02 = z, tmp03 = z, tmp04 = z, tmp05 = z, tmp06 = z, tmp07 = z;
+            if (N < ReductionParallelThreshold)
+                return apply<value_type>(v1, v2, size_type(0), N);
 
-                //#pragma omp for
-                for (size_type i = 0; i < no_loops; i+=UNROLL)
-                    dot_aux<0, UNROLL-1>::apply(tmp00, tmp01, tmp02, tmp03, tmp04, tmp05, tmp06, tmp07, v1, v2, i);
+            // see reduction above
+            std::vector<value_type> partial(Threads);
 
-                //#pragma omp critical
-                result += ((tmp00 + tmp01) + (tmp02 + tmp03)) + ((tmp04 + tmp05) + (tmp06 + tmp07));
+            #pragma omp parallel for num_threads(Threads)
+            for (size_type c = 0; c < Threads; ++c)
+            {
+                FASTVECTOR_TRACE(("dot, " + type_name<Vector1, Vector2>()), N);
+                partial[c] = apply<value_type>(v1, v2, c * N / Threads, (c + 1) * N / Threads);
             }
 
-            for (size_type i = UNROLL * no_loops; i < N; i++)
-                result = std::fma(v1[i], v2[i], result);
+            value_type result = partial[0];
+            for (size_type c = 1; c < Threads; ++c)
+                result += partial[c];
 
             return result;
         }
@@ -0,0 +1,486 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  File Name:  VectorSoA.h                                                   //
+//                                                                            //
+//     Author:  Andreas Buttenschoen <andreas@buttenschoen.ca>                //
+//    Created:  2026-10-19 05:21:37                                           //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CS_VECTOR_SOA_H
+#define CS_VECTOR_SOA_H
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "DynamicVector.h"
+#include "Vector.h"
+
+//
+// The columns of a structure of arrays: component k of the elements, i.e.
+// element[k], is kept in the aligned CSVector column(k). This is the storage
+// of VectorSoA below and of MatrixBatch.
+//
+template <typename Element, typename T, std::size_t N>
+class ColumnStorage
+{
+public:
+    using size_type    = std::size_t;
+    using value_type   = T;
+    using element_type = Element;
+
+    // Creates the columns without initializing them
+    explicit ColumnStorage(const size_type size = 0)
+        : ColumnStorage(size, std::make_index_sequence<N>())
+    {}
+
+    ColumnStorage(const std::vector<element_type>& elements)
+        : ColumnStorage(elements.size())
+    {
+        for (size_type i = 0; i < elements.size(); ++i)
+            set(i, elements[i]);
+    }
+
+    ColumnStorage(const ColumnStorage& other) = default;
+    ColumnStorage(ColumnStorage&& other)      = default;
+
+    // the columns are swapped, as the assignments of CSVector reallocate
+    ColumnStorage& operator=(ColumnStorage&& other)
+    {
+        swap(other);
+        return *this;
+    }
+
+    ColumnStorage& operator=(const ColumnStorage& other)
+    {
+        ColumnStorage copy(other);
+        swap(copy);
+        return *this;
+    }
+
+    void swap(ColumnStorage& other)
+    {
+        for (size_type k = 0; k < N; ++k)
+            columns[k].swap(other.columns[k]);
+    }
+
+    size_type size() const { return columns[0].size(); }
+    static constexpr size_type components() { return N; }
+
+    // The column of component k
+    CSVector<T>& column(const size_type k) { return columns[k]; }
+    const CSVector<T>& column(const size_type k) const { return columns[k]; }
+
+    element_type get(const size_type i) const
+    {
+        element_type ret;
+        for (size_type k = 0; k < N; ++k)
+            ret[k] = columns[k][i];
+        return ret;
+    }
+
+    void set(const size_type i, const element_type& element)
+    {
+        for (size_type k = 0; k < N; ++k)
+            columns[k][i] = element[k];
+    }
+
+    element_type operator()(const size_type i) const { return get(i); }
+
+    element_type at(const size_type i) const
+    {
+        if (!(i < size()))
+            throw std::out_of_range("Index " + std::to_string(i) + " larger than "
+                                    + std::to_string(size()));
+
+        return get(i);
+    }
+
+    std::vector<element_type> to_vector() const
+    {
+        std::vector<element_type> ret(size());
+        for (size_type i = 0; i < size(); ++i)
+            ret[i] = get(i);
+        return ret;
+    }
+
+    // the pointers to the columns, for the kernels
+    std::array<T *, N> data()
+    {
+        std::array<T *, N> ret;
+        for (size_type k = 0; k < N; ++k)
+            ret[k] = columns[k].data();
+        return ret;
+    }
+
+    std::array<const T *, N> data() const
+    {
+        std::array<const T *, N> ret;
+        for (size_type k = 0; k < N; ++k)
+            ret[k] = columns[k].data();
+        return ret;
+    }
+
+private:
+    template <std::size_t... K>
+    ColumnStorage(const size_type size, std::index_sequence<K...>)
+        : columns{{(static_cast<void>(K), CSVector<T>(size))...}}
+    {}
+
+    std::array<CSVector<T>, N> columns;
+};
+
+//
+// Many fixed size vectors, e.g. the positions of the particles, stored as a
+// structure of arrays
+//
+//      VectorSoA<double, 3> positions(points);     // from std::vector<Vector3d>
+//      CSVector<double> r = Norm(positions);
+//      positions = Rotate(positions, axis, angle);
+//
+// Each component is an aligned CSVector, so that the columns can be used in
+// the vector expressions directly, and the batched versions of the geometry
+// functions of vector_detail.h below are vectorized across the elements
+// rather than within one. Elements are read and written as ConstantVector.
+//
+// The batched functions split large vectors into one chunk per thread (see
+// TuningProfile.h), and run small ones on the calling thread.
+//
+// The loops calling std::sqrt need -fno-math-errno, see CMakeLists.txt.
+//
+template <typename T, std::size_t N>
+class VectorSoA : public ColumnStorage<ConstantVector<T, N>, T, N>
+{
+public:
+    static_assert(N > 1, "VectorSoA must have more than one component!");
+
+    using ColumnStorage<ConstantVector<T, N>, T, N>::ColumnStorage;
+};
+
+template <typename T, std::size_t N>
+inline std::size_t size(const VectorSoA<T, N>& v)
+{
+    return v.size();
+}
+
+namespace impl {
+
+// Calls kernel(begin, end) on chunks covering [0, n) (see chunked_for in
+// DynamicVector.h), on the calling thread for short vectors
+template <class T, class Kernel>
+inline void soa_for(std::size_t n, Kernel kernel)
+{
+    chunked_for<T>(n, n, ReductionParallelThreshold, kernel);
+}
+
+template <typename T, std::size_t N>
+inline void soa_check(const VectorSoA<T, N>& a, const VectorSoA<T, N>& b, const char * name)
+{
+    if (a.size() != b.size())
+        throw std::runtime_error(std::string("Incompatible vector lengths in ") + name + "!");
+}
+
+} // end namespace
+
+template <typename T, std::size_t N>
+CSVector<T> Norm2Squared(const VectorSoA<T, N>& a)
+{
+    CSVector<T> ret(a.size());
+    const auto x = a.data();
+    T * __restrict__ r = ret.data();
+
+    impl::soa_for<T>(a.size(), [&](std::size_t begin, std::size_t end)
+    {
+        #pragma omp simd
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            T sum = x[0][i] * x[0][i];
+            for (std::size_t k = 1; k < N; ++k)
+                sum += x[k][i] * x[k][i];
+            r[i] = sum;
+        }
+    });
+
+    return ret;
+}
+
+template <typename T, std::size_t N>
+CSVector<T> Norm(const VectorSoA<T, N>& a)
+{
+    CSVector<T> ret(a.size());
+    const auto x = a.data();
+    T * __restrict__ r = ret.data();
+
+    impl::soa_for<T>(a.size(), [&](std::size_t begin, std::size_t end)
+    {
+        #pragma omp simd
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            T sum = x[0][i] * x[0][i];
+            for (std::size_t k = 1; k < N; ++k)
+                sum += x[k][i] * x[k][i];
+            r[i] = std::sqrt(sum);
+        }
+    });
+
+    return ret;
+}
+
+template <typename T, std::size_t N>
+CSVector<T> Dot(const VectorSoA<T, N>& a, const VectorSoA<T, N>& b)
+{
+    impl::soa_check(a, b, "Dot");
+
+    CSVector<T> ret(a.size());
+    const auto x = a.data();
+    const auto y = b.data();
+    T * __restrict__ r = ret.data();
+
+    impl::soa_for<T>(a.size(), [&](std::size_t begin, std::size_t end)
+    {
+        #pragma omp simd
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            T sum = x[0][i] * y[0][i];
+            for (std::size_t k = 1; k < N; ++k)
+                sum += x[k][i] * y[k][i];
+            r[i] = sum;
+        }
+    });
+
+    return ret;
+}
+
+template <typename T, std::size_t N>
+CSVector<T> EuclideanDistance(const VectorSoA<T, N>& a, const VectorSoA<T, N>& b)
+{
+    impl::soa_check(a, b, "EuclideanDistance");
+
+    CSVector<T> ret(a.size());
+    const auto x = a.data();
+    const auto y = b.data();
+    T * __restrict__ r = ret.data();
+
+    impl::soa_for<T>(a.size(), [&](std::size_t begin, std::size_t end)
+    {
+        #pragma omp simd
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            T sum = 0;
+            for (std::size_t k = 0; k < N; ++k)
+            {
+                const T d = x[k][i] - y[k][i];
+                sum += d * d;
+            }
+            r[i] = std::sqrt(sum);
+        }
+    });
+
+    return ret;
+}
+
+// As Normalize, elements of length zero become NaN
+template <typename T, std::size_t N>
+VectorSoA<T, N> Normalize(const VectorSoA<T, N>& a)
+{
+    VectorSoA<T, N> ret(a.size());
+    const auto x = a.data();
+    const auto r = ret.data();
+
+    impl::soa_for<T>(a.size(), [&](std::size_t begin, std::size_t end)
+    {
+        #pragma omp simd
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            T sum = x[0][i] * x[0][i];
+            for (std::size_t k = 1; k < N; ++k)
+                sum += x[k][i] * x[k][i];
+
+            const T norm = std::sqrt(sum);
+            for (std::size_t k = 0; k < N; ++k)
+                r[k][i] = x[k][i] / norm;
+        }
+    });
+
+    return ret;
+}
+
+template <typename T>
+VectorSoA<T, 3> Cross(const VectorSoA<T, 3>& a, const VectorSoA<T, 3>& b)
+{
+    impl::soa_check(a, b, "Cross");
+
+    VectorSoA<T, 3> ret(a.size());
+    const auto x = a.data();
+    const auto y = b.data();
+    const auto r = ret.data();
+
+    impl::soa_for<T>(a.size(), [&](std::size_t begin, std::size_t end)
+    {
+        #pragma omp simd
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            const T x0 = x[0][i], x1 = x[1][i], x2 = x[2][i];
+            const T y0 = y[0][i], y1 = y[1][i], y2 = y[2][i];
+
+            r[0][i] = x1 * y2 - x2 * y1;
+            r[1][i] = x2 * y0 - x0 * y2;
+            r[2][i] = x0 * y1 - x1 * y0;
+        }
+    });
+
+    return ret;
+}
+
+// The unit vectors of inclinations theta and azimuths phi, which are wrapped
+// as in UnitVector
+template <typename T, typename = Enable_if<Floating_Point<T>()> >
+VectorSoA<T, 3> UnitVector(const CSVector<T>& theta, const CSVector<T>& phi)
+{
+    if (theta.size() != phi.size())
+        throw std::runtime_error("Incompatible vector lengths in UnitVector!");
+
+    VectorSoA<T, 3> ret(theta.size());
+    const T * __restrict__ t = theta.data();
+    const T * __restrict__ p = phi.data();
+    const auto r = ret.data();
+
+    impl::soa_for<T>(theta.size(), [&](std::size_t begin, std::size_t end)
+    {
+        #pragma omp simd
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            const T ti = wrap_angle(t[i], T(M_PI));
+            const T ph = wrap_angle(p[i], T(2. * M_PI));
+
+            const T sinTheta = std::sin(ti);
+            r[0][i] = sinTheta * std::cos(ph);
+            r[1][i] = sinTheta * std::sin(ph);
+            r[2][i] = std::cos(ti);
+        }
+    });
+
+    return ret;
+}
+
+// Transforms all elements by the same transform
+template <typename T>
+VectorSoA<T, 3> Apply(const BasicDatatypes::Transform<T>& transform, const VectorSoA<T, 3>& a)
+{
+    const auto& m = transform.matrix();
+    const T m00 = m(0, 0), m01 = m(0, 1), m02 = m(0, 2);
+    const T m10 = m(1, 0), m11 = m(1, 1), m12 = m(1, 2);
+    const T m20 = m(2, 0), m21 = m(2, 1), m22 = m(2, 2);
+
+    VectorSoA<T, 3> ret(a.size());
+    const auto x = a.data();
+    const auto r = ret.data();
+
+    impl::soa_for<T>(a.size(), [&](std::size_t begin, std::size_t end)
+    {
+        #pragma omp simd
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            const T x0 = x[0][i], x1 = x[1][i], x2 = x[2][i];
+
+            r[0][i] = m00 * x0 + m01 * x1 + m02 * x2;
+            r[1][i] = m10 * x0 + m11 * x1 + m12 * x2;
+            r[2][i] = m20 * x0 + m21 * x1 + m22 * x2;
+        }
+    });
+
+    return ret;
+}
+
+// Rotates all elements about the same axis, the rotation matrix is assembled
+// once
+template <typename T, typename = Enable_if<Floating_Point<T>()> >
+VectorSoA<T, 3> Rotate(const VectorSoA<T, 3>& a, const ConstantVector<T, 3>& axis, const T angle)
+{
+    return Apply(BasicDatatypes::Transform<T>::rotate(axis, angle), a);
+}
+
+// A single quaternion is cheaper to apply as its matrix
+template <typename T>
+VectorSoA<T, 3> Rotate(const VectorSoA<T, 3>& a, const BasicDatatypes::Quaternion<T>& q)
+{
+    return Apply(q.transform(), a);
+}
+
+// Rotates each element by its own unit quaternion, whose coefficients are
+// stored in the order x, y, z, w as in Quaternion
+template <typename T>
+VectorSoA<T, 3> Rotate(const VectorSoA<T, 3>& a, const VectorSoA<T, 4>& q)
+{
+    if (a.size() != q.size())
+        throw std::runtime_error("Incompatible vector lengths in Rotate!");
+
+    VectorSoA<T, 3> ret(a.size());
+    const auto x = a.data();
+    const auto u = q.data();
+    const auto r = ret.data();
+
+    impl::soa_for<T>(a.size(), [&](std::size_t begin, std::size_t end)
+    {
+        #pragma omp simd
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            const T x0 = x[0][i], x1 = x[1][i], x2 = x[2][i];
+            const T u0 = u[0][i], u1 = u[1][i], u2 = u[2][i], w = u[3][i];
+
+            // v + w t + u x t with t = 2 u x v
+            const T t0 = T(2) * (u1 * x2 - u2 * x1);
+            const T t1 = T(2) * (u2 * x0 - u0 * x2);
+            const T t2 = T(2) * (u0 * x1 - u1 * x0);
+
+            r[0][i] = x0 + w * t0 + (u1 * t2 - u2 * t1);
+            r[1][i] = x1 + w * t1 + (u2 * t0 - u0 * t2);
+            r[2][i] = x2 + w * t2 + (u0 * t1 - u1 * t0);
+        }
+    });
+
+    return ret;
+}
+
+// Rotates each element about its own axis by its own angle, the axes must be
+// of unit length
+template <typename T, typename = Enable_if<Floating_Point<T>()> >
+VectorSoA<T, 3> Rotate(const VectorSoA<T, 3>& a, const VectorSoA<T, 3>& axes, const CSVector<T>& angles)
+{
+    impl::soa_check(a, axes, "Rotate");
+    if (a.size() != angles.size())
+        throw std::runtime_error("Incompatible vector lengths in Rotate!");
+
+    VectorSoA<T, 3> ret(a.size());
+    const auto x = a.data();
+    const auto k = axes.data();
+    const T * __restrict__ phi = angles.data();
+    const auto r = ret.data();
+
+    impl::soa_for<T>(a.size(), [&](std::size_t begin, std::size_t end)
+    {
+        #pragma omp simd
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            const T x0 = x[0][i], x1 = x[1][i], x2 = x[2][i];
+            const T k0 = k[0][i], k1 = k[1][i], k2 = k[2][i];
+
+            const T c = std::cos(phi[i]);
+            const T s = std::sin(phi[i]);
+            const T d = (k0 * x0 + k1 * x1 + k2 * x2) * (T(1) - c);
+
+            // Rodrigues' formula
+            r[0][i] = c * x0 + s * (k1 * x2 - k2 * x1) + d * k0;
+            r[1][i] = c * x1 + s * (k2 * x0 - k0 * x2) + d * k1;
+            r[2][i] = c * x2 + s * (k0 * x1 - k1 * x0) + d * k2;
+        }
+    });
+
+    return ret;
+}
+
+#endif
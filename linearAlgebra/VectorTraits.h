@@ -12,9 +12,7 @@
 
 #include <cstddef>
 #include <type_traits>
-
-// define the block size once!
-static constexpr std::size_t BlockSize = 4;
+#include <complex>
 
 template <typename T>
 struct root
@@ -78,6 +76,9 @@ template <typename E1, typename E2, typename Functor>
 template <typename E1, typename Functor>
     struct VectorUnaryExpression;
 
+template <typename M, typename E1, typename E2>
+    struct VectorSelectExpression;
+
 // Assignment expressions
 template <typename E1, typename E2, typename Functor, typename ExecutionPolicy>
     class VectorVectorAssignmentOpExpression;
@@ -110,6 +111,13 @@ template <typename E1, typename Functor>
         using type = typename AssignShape<E1>::type;
     };
 
+// select always has the shape of a vector, even if both operands are scalars
+template <typename M, typename E1, typename E2>
+    struct AssignShapeHelper<VectorSelectExpression<M, E1, E2> >
+    {
+        using type = Vector<scalar>;
+    };
+
 template <typename E1, typename Functor, unsigned long Unroll>
     class VectorReductionOperation;
 
@@ -119,6 +127,47 @@ template <typename E1, typename Functor, unsigned long Unroll>
         using type = scalar;
     };
 
+// Traits for the length of a vector when it is known at compile time, it is
+// zero for vectors whose length is only known at run time
+template <typename T>
+    struct StaticSize
+    {
+        static const std::size_t value = 0;
+    };
+
+template <typename Derived, typename Value, std::size_t N>
+    struct StaticSize<BaseConstantVector<Derived, Value, N> >
+    {
+        static const std::size_t value = N;
+    };
+
+// Traits for expressions of vectors with a length known at compile time, that
+// is of the vectors derived from BaseConstantVector and the expressions built
+// from them. Unlike StaticSize, which selects the execution policy of the
+// destination, these also see through the derived vector types.
+namespace detail {
+
+template <typename Derived, typename Value, std::size_t N>
+    std::true_type fixed_length(const BaseConstantVector<Derived, Value, N> *);
+
+    std::false_type fixed_length(const void *);
+
+} // end namespace
+
+template <typename T>
+    struct FixedLength : decltype(detail::fixed_length(static_cast<const T *>(nullptr))) {};
+
+template <typename E1, typename E2, typename Functor>
+    struct FixedLength<VectorVectorBinaryExpression<E1, E2, Functor> >
+        : std::integral_constant<bool, FixedLength<E1>::value || FixedLength<E2>::value> {};
+
+template <typename E1, typename E2, typename Functor>
+    struct FixedLength<VectorScalarBinaryExpression<E1, E2, Functor> >
+        : std::integral_constant<bool, FixedLength<E1>::value || FixedLength<E2>::value> {};
+
+template <typename E1, typename Functor>
+    struct FixedLength<VectorUnaryExpression<E1, Functor> > : FixedLength<E1> {};
+
 // Traits for unrolling
 template <typename T>
     struct UnrollBlockSize
@@ -138,6 +187,66 @@ template <>
         static const std::size_t value = 8;
     };
 
+// complex values are interleaved, so keep the bytes per block of the real type
+template <typename T>
+    struct UnrollBlockSize<std::complex<T> >
+    {
+        static const std::size_t value = UnrollBlockSize<T>::value / 2 > 0 ? UnrollBlockSize<T>::value / 2 : 1;
+    };
+
+// Traits for the type in which the elements are computed. This differs from
+// the element type only for storage types such as half (see HalfPrecision.h),
+// which are widened on load and narrowed on store.
+template <typename T>
+    struct Compute
+    {
+        using type = T;
+    };
+
+template <typename T>
+    using Compute_type = typename Compute<T>::type;
+
+// Traits for the real type underlying a (possibly complex) type. Norms of
+// complex vectors are real.
+template <typename T>
+    struct Real
+    {
+        using type = T;
+    };
+
+template <typename T>
+    struct Real<std::complex<T> >
+    {
+        using type = T;
+    };
+
+template <typename T>
+    using Real_type = typename Real<T>::type;
+
+// Traits for the accumulator used by reductions. Single precision data is
+// accumulated in double precision, so that vectors can be stored in float
+// without losing accuracy in long dot products and norms.
+template <typename T>
+    struct Accumulate
+    {
+        using type = T;
+    };
+
+template <>
+    struct Accumulate<float>
+    {
+        using type = double;
+    };
+
+template <typename T>
+    struct Accumulate<std::complex<T> >
+    {
+        using type = std::complex<typename Accumulate<T>::type>;
+    };
+
+template <typename T>
+    using Accumulate_type = typename Accumulate<T>::type;
+
 // Traits for unrolling
 template <typename T>
     struct UnrollThreads
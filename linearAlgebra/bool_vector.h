@@ -25,6 +25,11 @@ public:
         : bitset<N>()
     {}
 
+    // bit i is the value of element i
+    explicit BoolVector(unsigned long long bits)
+        : bitset<N>(bits)
+    {}
+
     template< class CharT, class Traits, class Alloc>
     BoolVector(const std::basic_string<CharT, Traits, Alloc>& str,
                typename std::basic_string<CharT, Traits, Alloc>::size_type pos = 0,
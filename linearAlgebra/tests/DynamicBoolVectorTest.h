@@ -0,0 +1,158 @@
+// test
+#define _NO_CORE_
+
+#include <cxxtest/TestSuite.h>
+
+#include <iostream>
+#include <string>
+#include <memory>
+
+#include "DynamicVectorCommonTest.h"
+
+#define private public
+#define protected public
+#include "DynamicVector.h"
+
+using namespace std;
+
+class CSVectorTest : public CxxTest::TestSuite
+{
+private:
+    int repeats;
+    size_t currentLength;
+    size_t size_step = 256 * 1024;
+
+    const size_t mbytes = 8;
+    const size_t vectorLength = mbytes * 1024 * 1024 / sizeof(double);
+
+    void increaseLength()
+    {
+        if (currentLength <= 1024)
+            currentLength++;
+        else
+        {
+            currentLength += size_step;
+            currentLength = std::min(currentLength, vectorLength);
+        }
+
+        repeats = 3;
+    }
+
+    bool keepGoing()
+    {
+        return (currentLength < vectorLength);
+    }
+
+public:
+
+    void setUp()
+    {
+        repeats = 3;
+        currentLength = 1;
+    }
+
+    void tearDown()
+    {}
+
+    void testConstruction()
+    {
+        for (size_t n : {0, 1, 63, 64, 65, 257, 1000})
+        {
+            CSVector<bool> ones(n, true), zeros(n);
+            TS_ASSERT_EQUALS(ones.count(), n);
+            TS_ASSERT_EQUALS(zeros.count(), size_t(0));
+            TS_ASSERT(ones.all());
+            TS_ASSERT(zeros.none());
+            TS_ASSERT_EQUALS(ones.any(), n > 0);
+
+            // the padding is kept zero
+            auto flipped = ~ones;
+            TS_ASSERT(flipped.none());
+            TS_ASSERT_EQUALS((~zeros).count(), n);
+        }
+
+        CSVector<bool> mask(130);
+        mask.set(0);
+        mask.set(129);
+        TS_ASSERT(mask[0] && mask[129] && !mask[64]);
+        TS_ASSERT_EQUALS(mask.count(), size_t(2));
+        mask.reset(0);
+        TS_ASSERT_EQUALS(mask.count(), size_t(1));
+        TS_ASSERT(!mask.all());
+        TS_ASSERT_THROWS(mask.test(130), std::out_of_range);
+    }
+
+    void testComparison()
+    {
+        TS_TRACE("Starting comparison test");
+        while (keepGoing())
+        {
+            while (repeats --> 0)
+            {
+                auto x = getVectorRandom<double>(currentLength);
+                auto y = getVectorRandom<double>(currentLength);
+                double tol = 500.;
+
+                CSVector<bool> pos = (x > 0.);
+                CSVector<bool> small = (abs(x - y) < tol);
+                CSVector<bool> less = (x <= y);
+                CSVector<bool> flip = (0. < x);
+
+                size_t npos = 0;
+                for (size_t i = 0; i < currentLength; i++)
+                {
+                    TS_ASSERT_EQUALS(pos[i], x[i] > 0.);
+                    TS_ASSERT_EQUALS(small[i], std::abs(x[i] - y[i]) < tol);
+                    TS_ASSERT_EQUALS(less[i], x[i] <= y[i]);
+                    TS_ASSERT_EQUALS(flip[i], pos[i]);
+                    npos += (x[i] > 0.);
+                }
+
+                TS_ASSERT_EQUALS(pos.count(), npos);
+
+                auto both   = pos & small;
+                auto either = pos | small;
+                auto one    = pos ^ small;
+                auto neg    = ~pos;
+                for (size_t i = 0; i < currentLength; i++)
+                {
+                    TS_ASSERT_EQUALS(both[i], pos[i] && small[i]);
+                    TS_ASSERT_EQUALS(either[i], pos[i] || small[i]);
+                    TS_ASSERT_EQUALS(one[i], pos[i] != small[i]);
+                    TS_ASSERT_EQUALS(neg[i], !pos[i]);
+                }
+
+                TS_ASSERT_EQUALS(neg.count() + pos.count(), currentLength);
+            }
+
+            increaseLength();
+        }
+    }
+
+    void testSelect()
+    {
+        TS_TRACE("Starting select test");
+        while (keepGoing())
+        {
+            while (repeats --> 0)
+            {
+                auto x = getVectorRandom<double>(currentLength);
+                auto y = getVectorRandom<double>(currentLength);
+
+                CSVector<bool> pos = (x > 0.);
+                CSVector<double> relu(currentLength), mixed(currentLength);
+
+                relu  = select(pos, x, 0.);
+                mixed = select(x < y, 2. * x, y);
+
+                for (size_t i = 0; i < currentLength; i++)
+                {
+                    TS_ASSERT_EQUALS(relu[i], x[i] > 0. ? x[i] : 0.);
+                    TS_ASSERT_EQUALS(mixed[i], x[i] < y[i] ? 2. * x[i] : y[i]);
+                }
+            }
+
+            increaseLength();
+        }
+    }
+};
@@ -0,0 +1,232 @@
+// test
+#define _NO_CORE_
+
+#include <cxxtest/TestSuite.h>
+
+#include <iostream>
+#include <string>
+#include <memory>
+#include <complex>
+
+#include "DynamicVectorCommonTest.h"
+
+#define private public
+#define protected public
+#include "DynamicVector.h"
+#include "DynamicComplexVector.h"
+
+using namespace std;
+
+class CSVectorTest : public CxxTest::TestSuite
+{
+private:
+    using complex_t = std::complex<double>;
+
+    const double tol = 1.e-8;
+
+    int repeats;
+    size_t currentLength;
+    size_t size_step = 256 * 1024;
+
+    const size_t mbytes = 8;
+    const size_t vectorLength = mbytes * 1024 * 1024 / sizeof(complex_t);
+
+    void increaseLength()
+    {
+        if (currentLength <= 1024)
+            currentLength++;
+        else
+        {
+            currentLength += size_step;
+            currentLength = std::min(currentLength, vectorLength);
+        }
+
+        repeats = 5;
+    }
+
+    bool keepGoing()
+    {
+        return (currentLength < vectorLength);
+    }
+
+    template <class T>
+    CSVector<std::complex<T> > getComplexRandom(size_t length)
+    {
+        auto re = getVectorRandom<T>(length);
+        auto im = getVectorRandom<T>(length);
+
+        CSVector<std::complex<T> > ret(length);
+        for (size_t i = 0; i < length; i++)
+            ret[i] = std::complex<T>(re[i], im[i]);
+
+        return ret;
+    }
+
+    template <class T>
+    std::complex<double> hermitianDot(const CSVector<std::complex<T> >& lhs, const CSVector<std::complex<T> >& rhs)
+    {
+        std::complex<double> ret = 0;
+        for (size_t i = 0; i < lhs.size(); i++)
+            ret += std::conj(std::complex<double>(lhs[i])) * std::complex<double>(rhs[i]);
+        return ret;
+    }
+
+public:
+
+    void setUp()
+    {
+        repeats = 5;
+        currentLength = 1;
+    }
+
+    void tearDown()
+    {}
+
+    void testTraits()
+    {
+        TS_ASSERT((Same<Real_type<complex_t>, double>()));
+        TS_ASSERT((Same<Accumulate_type<std::complex<float> >, std::complex<double> >()));
+        TS_ASSERT((Same<two_norm_functor::result_type<complex_t>, double>()));
+        TS_ASSERT_EQUALS(UnrollBlockSize<complex_t>::value, size_t(2));
+    }
+
+    void testHermitianDot()
+    {
+        TS_TRACE("Starting complex dot product test");
+        while (keepGoing())
+        {
+            while (repeats --> 0)
+            {
+                auto vec1 = getComplexRandom<double>(currentLength);
+                auto vec2 = getComplexRandom<double>(currentLength);
+
+                auto dotVal   = dot(vec1, vec2);
+                auto expected = hermitianDot(vec1, vec2);
+                double scale  = 1e6 * double(currentLength);
+
+                TS_ASSERT_DELTA(dotVal.real(), expected.real(), 1e-12 * scale);
+                TS_ASSERT_DELTA(dotVal.imag(), expected.imag(), 1e-12 * scale);
+
+                // the expression template version
+                auto exprVal = ::dot<4>(vec1, vec2);
+                TS_ASSERT_DELTA(exprVal.real(), expected.real(), 1e-12 * scale);
+                TS_ASSERT_DELTA(exprVal.imag(), expected.imag(), 1e-12 * scale);
+
+                // the split version
+                CSSplitComplexVector<double> split1(vec1), split2(vec2);
+                auto splitVal = dot(split1, split2);
+                TS_ASSERT_DELTA(splitVal.real(), expected.real(), 1e-12 * scale);
+                TS_ASSERT_DELTA(splitVal.imag(), expected.imag(), 1e-12 * scale);
+
+                // float data is accumulated in double
+                CSVector<std::complex<float> > vecf(currentLength);
+                for (size_t i = 0; i < currentLength; i++)
+                    vecf[i] = std::complex<float>(vec1[i]);
+
+                auto dotf = dot(vecf, vecf);
+                TS_ASSERT((Same<decltype(dotf), std::complex<double> >()));
+                TS_ASSERT_DELTA(dotf.real(), hermitianDot(vecf, vecf).real(), 1e-12 * scale);
+                TS_ASSERT_DELTA(dotf.imag(), 0., 1e-12 * scale);
+            }
+
+            increaseLength();
+        }
+    }
+
+    void testNorms()
+    {
+        TS_TRACE("Starting complex norm test");
+        while (keepGoing())
+        {
+            while (repeats --> 0)
+            {
+                auto vec = getComplexRandom<double>(currentLength);
+
+                double expected = std::sqrt(hermitianDot(vec, vec).real());
+                double sup = 0;
+                for (size_t i = 0; i < currentLength; i++)
+                    sup = std::max(sup, std::abs(vec[i]));
+
+                TS_ASSERT_DELTA(norm(vec), expected, tol * expected);
+                TS_ASSERT_DELTA(supNorm(vec), sup, tol * sup);
+
+                double norm2 = Norm2(vec);
+                TS_ASSERT_DELTA(norm2, expected, tol * expected);
+                TS_ASSERT_DELTA(norm(CSSplitComplexVector<double>(vec)), expected, tol * expected);
+            }
+
+            increaseLength();
+        }
+    }
+
+    void testMultiply()
+    {
+        TS_TRACE("Starting complex multiply test");
+        while (keepGoing())
+        {
+            while (repeats --> 0)
+            {
+                auto vec1 = getComplexRandom<double>(currentLength);
+                auto vec2 = getComplexRandom<double>(currentLength);
+
+                CSVector<complex_t> res1(currentLength), res2(currentLength), res3(currentLength);
+                multiply(res1, vec1, vec2);
+                conj_multiply(res2, vec1, vec2);
+                res3 = vec1 * vec2 + 2. * conj(vec1);
+
+                // the plain products are assigned with the kernels above
+                CSVector<complex_t> res4 = vec1 * vec2;
+                CSVector<complex_t> res5(currentLength);
+                res5 = conj(vec1) * vec2;
+
+                // and may write to one of their operands
+                CSVector<complex_t> res8(vec1), res9(vec2);
+                res8 = res8 * vec2;
+                res9 = conj(vec1) * res9;
+
+                // complex scalars
+                const complex_t a(0.5, -1.);
+                CSVector<complex_t> res6 = a * vec1 + vec2;
+                CSVector<complex_t> res7 = vec1 / a - a;
+                res7 *= a;
+
+                CSSplitComplexVector<double> split1(vec1), split2(vec2), split3(currentLength);
+                multiply(split3, split1, split2);
+
+                for (size_t i = 0; i < currentLength; i++)
+                {
+                    complex_t expected = vec1[i] * vec2[i];
+                    TS_ASSERT_DELTA(std::abs(res1[i] - expected), 0., tol);
+                    TS_ASSERT_DELTA(std::abs(res2[i] - std::conj(vec1[i]) * vec2[i]), 0., tol);
+                    TS_ASSERT_DELTA(std::abs(res3[i] - (expected + 2. * std::conj(vec1[i]))), 0., tol);
+                    TS_ASSERT_DELTA(std::abs(split3[i] - expected), 0., tol);
+                    TS_ASSERT_EQUALS(res4[i], res1[i]);
+                    TS_ASSERT_EQUALS(res5[i], res2[i]);
+                    TS_ASSERT_EQUALS(res8[i], res1[i]);
+                    TS_ASSERT_EQUALS(res9[i], res2[i]);
+                    TS_ASSERT_DELTA(std::abs(res6[i] - (a * vec1[i] + vec2[i])), 0., tol);
+                    TS_ASSERT_DELTA(std::abs(res7[i] - (vec1[i] / a - a) * a), 0., tol);
+                }
+            }
+
+            increaseLength();
+        }
+    }
+
+    void testSplitRoundTrip()
+    {
+        for (size_t n : {1, 3, 8, 17, 1031})
+        {
+            auto vec = getComplexRandom<float>(n);
+            CSSplitComplexVector<float> split(vec);
+            auto back = split.interleaved();
+
+            for (size_t i = 0; i < n; i++)
+            {
+                TS_ASSERT_EQUALS(split.real()[i], vec[i].real());
+                TS_ASSERT_EQUALS(split.imag()[i], vec[i].imag());
+                TS_ASSERT_EQUALS(back[i], vec[i]);
+            }
+        }
+    }
+};
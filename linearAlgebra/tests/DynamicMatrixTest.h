@@ -0,0 +1,212 @@
+// test
+#define _NO_CORE_
+
+#include <cxxtest/TestSuite.h>
+
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "DynamicVectorCommonTest.h"
+
+#include "DynamicMatrix.h"
+
+using namespace std;
+
+class DynamicMatrixTest : public CxxTest::TestSuite
+{
+private:
+    std::mt19937 generator {42};
+
+    template <class Matrix>
+    Matrix random(size_t m, size_t n)
+    {
+        std::uniform_real_distribution<double> uniform(-1., 1.);
+
+        Matrix ret(m, n);
+        for (size_t i = 0; i < m; ++i)
+            for (size_t j = 0; j < n; ++j)
+                ret(i, j) = typename Matrix::value_type(uniform(generator));
+        return ret;
+    }
+
+    template <class T>
+    CSVector<T> random(size_t n)
+    {
+        std::uniform_real_distribution<double> uniform(-1., 1.);
+
+        CSVector<T> ret(n);
+        for (auto& value : ret)
+            value = T(uniform(generator));
+        return ret;
+    }
+
+    template <class A, class B, class C>
+    void check_gemm(const A& a, const B& b, const C& c, double eps)
+    {
+        TS_ASSERT_EQUALS(c.rows(), a.rows());
+        TS_ASSERT_EQUALS(c.cols(), b.cols());
+
+        for (size_t i = 0; i < a.rows(); ++i)
+            for (size_t j = 0; j < b.cols(); ++j)
+            {
+                double sum = 0.;
+                for (size_t k = 0; k < a.cols(); ++k)
+                    sum += double(a(i, k)) * double(b(k, j));
+                TS_ASSERT_DELTA(c(i, j), sum, eps * double(a.cols()));
+            }
+    }
+
+    template <class T, StorageOrder Order>
+    void check_gemv(size_t m, size_t n, double eps)
+    {
+        const auto a = random<DynamicMatrix<T, Order> >(m, n);
+        const auto x = random<T>(n);
+        const auto w = random<T>(m);
+        const auto b = random<T>(m);
+
+        CSVector<T> y = a * x + b;
+        CSVector<T> z = w * a;
+        TS_ASSERT_EQUALS(y.size(), m);
+        TS_ASSERT_EQUALS(z.size(), n);
+
+        for (size_t i = 0; i < m; ++i)
+        {
+            double sum = 0.;
+            for (size_t j = 0; j < n; ++j)
+                sum += double(a(i, j)) * double(x[j]);
+            TS_ASSERT_DELTA(y[i], sum + double(b[i]), eps * double(n + 1));
+        }
+
+        for (size_t j = 0; j < n; ++j)
+        {
+            double sum = 0.;
+            for (size_t i = 0; i < m; ++i)
+                sum += double(w[i]) * double(a(i, j));
+            TS_ASSERT_DELTA(z[j], sum, eps * double(m + 1));
+        }
+    }
+
+    template <class T, StorageOrder Order1, StorageOrder Order2>
+    void check_gemm(size_t m, size_t k, size_t n, double eps)
+    {
+        const auto a = random<DynamicMatrix<T, Order1> >(m, k);
+        const auto b = random<DynamicMatrix<T, Order2> >(k, n);
+        check_gemm(a, b, a * b, eps);
+    }
+
+    template <class T, StorageOrder Order1, StorageOrder Order2>
+    void check_gemm_sizes(double eps)
+    {
+        // the edges of the microkernel and of the blocks
+        for (size_t m : {1, 5, 6, 7, 97})
+            for (size_t n : {1, 8, 17, 33})
+                for (size_t k : {1, 3, 257})
+                    check_gemm<T, Order1, Order2>(m, k, n, eps);
+    }
+
+public:
+
+    void testLayout()
+    {
+        TS_TRACE("Starting dynamic matrix layout test");
+
+        DynamicMatrix<double> a = {{1., 2., 3.}, {4., 5., 6.}};
+        TS_ASSERT_EQUALS(a.rows(), 2u);
+        TS_ASSERT_EQUALS(a.cols(), 3u);
+        TS_ASSERT_EQUALS(a.size(), 6u);
+        TS_ASSERT_EQUALS(a(1, 0), 4.);
+        TS_ASSERT_EQUALS(a.at(0, 2), 3.);
+        TS_ASSERT_THROWS(a.at(2, 0), std::out_of_range);
+        TS_ASSERT_THROWS((DynamicMatrix<double>{{1., 2.}, {3.}}), std::runtime_error);
+
+        // the rows are padded and aligned
+        TS_ASSERT_EQUALS(a.leading_dimension() % a.VectorSize, 0u);
+        TS_ASSERT_EQUALS(a.data(1)[0], 4.);
+        TS_ASSERT_EQUALS(a.data(0)[3], 0.);
+        TS_ASSERT_EQUALS(reinterpret_cast<uintptr_t>(a.data(1)) % __alignment, 0u);
+
+        DynamicMatrix<float, StorageOrder::ColumnMajor> c = {{1.f, 2.f}, {3.f, 4.f}, {5.f, 6.f}};
+        TS_ASSERT_EQUALS(c.lines(), 2u);
+        TS_ASSERT_EQUALS(c.data(1)[2], 6.f);
+        TS_ASSERT_EQUALS(reinterpret_cast<uintptr_t>(c.data(1)) % __alignment, 0u);
+
+        const auto t = transpose(a);
+        TS_ASSERT_EQUALS(t.rows(), 3u);
+        TS_ASSERT_EQUALS(t(2, 1), 6.);
+        TS_ASSERT(t.storage_order == StorageOrder::ColumnMajor);
+
+        DynamicMatrix<double> copy(a);
+        copy(0, 0) = 7.;
+        TS_ASSERT_EQUALS(a(0, 0), 1.);
+        copy = a;
+        TS_ASSERT_EQUALS(copy(0, 0), 1.);
+
+        DynamicMatrix<double> moved(std::move(copy));
+        TS_ASSERT_EQUALS(moved(1, 2), 6.);
+        TS_ASSERT_EQUALS(copy.size(), 0u);
+
+        const auto id = DynamicMatrix<double>::identity(4);
+        TS_ASSERT_EQUALS(id(2, 2), 1.);
+        TS_ASSERT_EQUALS(id(2, 3), 0.);
+
+        DynamicMatrix<double> f(3, 5, 2.);
+        TS_ASSERT_EQUALS(f(2, 4), 2.);
+    }
+
+    void testGemv()
+    {
+        TS_TRACE("Starting dynamic matrix gemv test");
+
+        for (size_t m : {1, 3, 4, 7, 64, 129})
+            for (size_t n : {1, 2, 5, 8, 31, 100})
+            {
+                check_gemv<double, StorageOrder::RowMajor>(m, n, 1e-15);
+                check_gemv<double, StorageOrder::ColumnMajor>(m, n, 1e-15);
+                check_gemv<float, StorageOrder::RowMajor>(m, n, 1e-6);
+                check_gemv<float, StorageOrder::ColumnMajor>(m, n, 1e-6);
+            }
+
+        // large enough to run in parallel
+        check_gemv<double, StorageOrder::RowMajor>(1001, 517, 1e-15);
+        check_gemv<double, StorageOrder::ColumnMajor>(1001, 517, 1e-15);
+
+        // expressions on the right are evaluated first
+        const auto a = random<DynamicMatrix<double> >(5, 4);
+        const auto x = random<double>(4);
+        CSVector<double> y = a * (2. * x);
+        CSVector<double> z = 2. * (a * x);
+        for (size_t i = 0; i < 5; ++i)
+            TS_ASSERT_DELTA(y[i], z[i], 1e-14);
+
+        TS_ASSERT_THROWS(a * CSVector<double>(5), std::runtime_error);
+        TS_ASSERT_THROWS(CSVector<double>(4) * a, std::runtime_error);
+    }
+
+    void testGemm()
+    {
+        TS_TRACE("Starting dynamic matrix gemm test");
+
+        check_gemm_sizes<double, StorageOrder::RowMajor, StorageOrder::RowMajor>(1e-15);
+        check_gemm_sizes<double, StorageOrder::RowMajor, StorageOrder::ColumnMajor>(1e-15);
+        check_gemm_sizes<double, StorageOrder::ColumnMajor, StorageOrder::RowMajor>(1e-15);
+        check_gemm_sizes<double, StorageOrder::ColumnMajor, StorageOrder::ColumnMajor>(1e-15);
+        check_gemm_sizes<float, StorageOrder::RowMajor, StorageOrder::RowMajor>(1e-6);
+        check_gemm_sizes<float, StorageOrder::ColumnMajor, StorageOrder::RowMajor>(1e-6);
+
+        // several panels of B and blocks of A, in parallel
+        check_gemm<double, StorageOrder::RowMajor, StorageOrder::RowMajor>(301, 300, 4200, 1e-15);
+
+        const auto a = random<DynamicMatrix<double> >(7, 9);
+        check_gemm(a, DynamicMatrix<double>::identity(9), a * DynamicMatrix<double>::identity(9), 0.);
+        check_gemm(transpose(a), a, transpose(a) * a, 1e-15);
+
+        // an empty inner dimension gives zeros
+        const auto z = DynamicMatrix<double>(3, 0) * DynamicMatrix<double>(0, 2);
+        TS_ASSERT_EQUALS(z(2, 1), 0.);
+
+        TS_ASSERT_THROWS(a * a, std::runtime_error);
+    }
+};
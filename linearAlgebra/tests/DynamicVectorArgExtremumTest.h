@@ -0,0 +1,118 @@
+// test
+#define _NO_CORE_
+
+#include <cxxtest/TestSuite.h>
+
+#include <iostream>
+#include <string>
+#include <memory>
+#include <algorithm>
+
+#include "DynamicVectorCommonTest.h"
+
+#define private public
+#define protected public
+#include "DynamicVector.h"
+
+using namespace std;
+
+class CSVectorTest : public CxxTest::TestSuite
+{
+private:
+    int repeats;
+    size_t currentLength;
+    size_t size_step = 256 * 1024;
+
+    const size_t mbytes = 8;
+    const size_t vectorLength = mbytes * 1024 * 1024 / sizeof(double);
+
+    void increaseLength()
+    {
+        if (currentLength <= 1024)
+            currentLength++;
+        else
+        {
+            currentLength += size_step;
+            currentLength = std::min(currentLength, vectorLength);
+        }
+
+        repeats = 3;
+    }
+
+    bool keepGoing()
+    {
+        return (currentLength < vectorLength);
+    }
+
+    template <typename T>
+    void checkArgExtremum()
+    {
+        while (keepGoing())
+        {
+            while (repeats --> 0)
+            {
+                auto vec = getVectorRandom<T>(currentLength);
+
+                auto absless = [](T a, T b) { return std::abs(a) < std::abs(b); };
+                size_t imax = std::max_element(vec.begin(), vec.end()) - vec.begin();
+                size_t imin = std::min_element(vec.begin(), vec.end()) - vec.begin();
+                size_t iabs = std::max_element(vec.begin(), vec.end(), absless) - vec.begin();
+
+                TS_ASSERT_EQUALS(argmax(vec), imax);
+                TS_ASSERT_EQUALS(argmin(vec), imin);
+                TS_ASSERT_EQUALS(iamax(vec), iabs);
+            }
+
+            increaseLength();
+        }
+    }
+
+public:
+
+    void setUp()
+    {
+        repeats = 3;
+        currentLength = 1;
+    }
+
+    void tearDown()
+    {}
+
+    void testArgExtremumDouble()
+    {
+        TS_TRACE("Starting arg extremum test double");
+        checkArgExtremum<double>();
+    }
+
+    void testArgExtremumFloat()
+    {
+        TS_TRACE("Starting arg extremum test float");
+        checkArgExtremum<float>();
+    }
+
+    void testTies()
+    {
+        TS_TRACE("Starting arg extremum ties test");
+        for (size_t N : {size_t(7), size_t(1000), vectorLength})
+        {
+            CSVector<double> vec(N, 1.);
+
+            // the first of several equal extrema is returned
+            TS_ASSERT_EQUALS(argmax(vec), 0);
+            TS_ASSERT_EQUALS(argmin(vec), 0);
+
+            vec[N - 1] = 2.;
+            vec[N / 2] = 2.;
+            vec[N / 3] = -2.;
+            TS_ASSERT_EQUALS(argmax(vec), N / 2);
+            TS_ASSERT_EQUALS(argmin(vec), N / 3);
+            TS_ASSERT_EQUALS(iamax(vec), N / 3);
+        }
+    }
+
+    void testEmpty()
+    {
+        CSVector<double> vec(0);
+        TS_ASSERT_THROWS(argmax(vec), std::runtime_error);
+    }
+};
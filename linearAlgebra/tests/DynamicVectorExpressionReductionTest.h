@@ -0,0 +1,171 @@
+// test
+#define _NO_CORE_
+
+#include <cxxtest/TestSuite.h>
+
+#include <iostream>
+#include <string>
+#include <memory>
+#include <limits>
+
+#include "DynamicVectorCommonTest.h"
+
+#define private public
+#define protected public
+#include "DynamicVector.h"
+
+using namespace std;
+
+class CSVectorTest : public CxxTest::TestSuite
+{
+private:
+    int repeats;
+    size_t currentLength;
+    size_t size_step = 256 * 1024;
+
+    const size_t mbytes = 8;
+    const size_t vectorLength = mbytes * 1024 * 1024 / sizeof(double);
+
+    void increaseLength()
+    {
+        if (currentLength <= 1024)
+            currentLength++;
+        else
+        {
+            currentLength += size_step;
+            currentLength = std::min(currentLength, vectorLength);
+        }
+
+        repeats = 3;
+    }
+
+    bool keepGoing()
+    {
+        return (currentLength < vectorLength);
+    }
+
+public:
+
+    void setUp()
+    {
+        repeats = 3;
+        currentLength = 1;
+    }
+
+    void tearDown()
+    {}
+
+    void testSumMean()
+    {
+        TS_TRACE("Starting expression sum test");
+        while (keepGoing())
+        {
+            while (repeats --> 0)
+            {
+                auto vec1 = getVectorRandom<double>(currentLength);
+                auto vec2 = getVectorRandom<double>(currentLength);
+
+                // the summation order differs, compare relative to sum |x_k|
+                double s = 0, a = 0, t = 0;
+                for (size_t i = 0; i < currentLength; ++i)
+                {
+                    s += vec1[i] - 2. * vec2[i];
+                    a += std::abs(vec1[i] - 2. * vec2[i]);
+                    t += std::abs(vec1[i] - vec2[i]);
+                }
+
+                TS_ASSERT_DELTA(sum(vec1 - 2. * vec2), s, 1e-12 * a);
+                TS_ASSERT_DELTA(mean(vec1 - 2. * vec2), s / double(currentLength), 1e-12 * a / double(currentLength));
+                TS_ASSERT_DELTA(oneNorm(vec1 - vec2), t, 1e-12 * t);
+            }
+
+            increaseLength();
+        }
+    }
+
+    void testMinMax()
+    {
+        TS_TRACE("Starting expression min max test");
+        while (keepGoing())
+        {
+            while (repeats --> 0)
+            {
+                auto vec1 = getVectorRandom<double>(currentLength);
+                auto vec2 = getVectorRandom<double>(currentLength);
+
+                double lo = std::numeric_limits<double>::max();
+                double hi = std::numeric_limits<double>::lowest();
+                double sup = 0;
+                for (size_t i = 0; i < currentLength; ++i)
+                {
+                    double d = vec1[i] - vec2[i];
+                    lo  = std::min(lo, d);
+                    hi  = std::max(hi, d);
+                    sup = std::max(sup, std::abs(d));
+                }
+
+                TS_ASSERT_EQUALS(min(vec1 - vec2), lo);
+                TS_ASSERT_EQUALS(max(vec1 - vec2), hi);
+                TS_ASSERT_EQUALS(supNorm(vec1 - vec2), sup);
+                TS_ASSERT_EQUALS(max(abs(vec1 - vec2)), sup);
+
+                auto mm = minmax(vec1 - vec2);
+                TS_ASSERT_EQUALS(mm.first, lo);
+                TS_ASSERT_EQUALS(mm.second, hi);
+            }
+
+            increaseLength();
+        }
+    }
+
+    void testDot()
+    {
+        TS_TRACE("Starting expression dot test");
+        while (keepGoing())
+        {
+            while (repeats --> 0)
+            {
+                auto vec1 = getVectorRandom<double>(currentLength);
+                auto vec2 = getVectorRandom<double>(currentLength);
+                auto vec3 = getVectorRandom<double>(currentLength);
+
+                // the summation order differs, compare relative to sum |a_k b_k|
+                double d = 0, a = 0;
+                for (size_t i = 0; i < currentLength; ++i)
+                {
+                    d += (vec1[i] - vec2[i]) * vec3[i];
+                    a += std::abs((vec1[i] - vec2[i]) * vec3[i]);
+                }
+
+                TS_ASSERT_DELTA(dot(vec1 - vec2, vec3), d, 1e-12 * a);
+
+                // the concrete overload gives the same result
+                TS_ASSERT_DELTA(dot(vec1 + 0. * vec2, vec3), dot(vec1, vec3), 1e-12 * a);
+            }
+
+            increaseLength();
+        }
+    }
+
+    void testDeterministic()
+    {
+        auto vec1 = getVectorRandom<double>(vectorLength);
+        auto vec2 = getVectorRandom<double>(vectorLength);
+
+        // the partial sums are combined in a fixed order
+        double s = sum(vec1 * vec2);
+        for (int i = 0; i < 5; ++i)
+            TS_ASSERT_EQUALS(sum(vec1 * vec2), s);
+    }
+
+    void testEmpty()
+    {
+        CSVector<double> vec1(0), vec2(0);
+        TS_ASSERT_EQUALS(sum(vec1 + vec2), 0.);
+        TS_ASSERT_THROWS(max(vec1 + vec2), std::runtime_error);
+        TS_ASSERT_THROWS(mean(vec1 + vec2), std::runtime_error);
+
+        CSVector<double> vec3(3);
+        TS_ASSERT_THROWS(dot(vec1 + vec2, vec3 + vec3), std::runtime_error);
+    }
+};
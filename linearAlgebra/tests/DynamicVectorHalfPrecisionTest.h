@@ -0,0 +1,219 @@
+// test
+#define _NO_CORE_
+
+#include <cxxtest/TestSuite.h>
+
+#include <iostream>
+#include <string>
+#include <memory>
+#include <limits>
+
+#include "DynamicVectorCommonTest.h"
+
+#define private public
+#define protected public
+#include "DynamicVector.h"
+#include "HalfPrecision.h"
+
+using namespace std;
+
+class CSVectorTest : public CxxTest::TestSuite
+{
+private:
+    int repeats;
+    size_t currentLength;
+    size_t size_step = 256 * 1024;
+
+    const size_t mbytes = 4;
+    const size_t vectorLength = mbytes * 1024 * 1024 / sizeof(float);
+
+    void increaseLength()
+    {
+        if (currentLength <= 1024)
+            currentLength++;
+        else
+        {
+            currentLength += size_step;
+            currentLength = std::min(currentLength, vectorLength);
+        }
+
+        repeats = 3;
+    }
+
+    bool keepGoing()
+    {
+        return (currentLength < vectorLength);
+    }
+
+    CSVector<float> getVectorSmall(size_t length)
+    {
+        auto ret = getVectorRandom<float>(length);
+        for (auto& v : ret)
+            v *= 1e-2f;
+        return ret;
+    }
+
+public:
+
+    void setUp()
+    {
+        repeats = 3;
+        currentLength = 1;
+    }
+
+    void tearDown()
+    {}
+
+    void testHalfScalarConversion()
+    {
+        // exactly representable values
+        for (float v : {0.f, -0.f, 1.f, -2.f, 0.5f, 65504.f, 6.103515625e-05f, 5.9604645e-08f})
+        {
+            TS_ASSERT_EQUALS(float(half(v)), v);
+            TS_ASSERT_EQUALS(impl::float_to_half_soft(v), half(v).bits);
+        }
+
+        // round to nearest even: 2049 is halfway between 2048 and 2050
+        TS_ASSERT_EQUALS(float(half(2049.f)), 2048.f);
+        TS_ASSERT_EQUALS(float(half(2051.f)), 2052.f);
+
+        TS_ASSERT(std::isinf(float(half(1e6f))));
+        TS_ASSERT(std::isnan(float(half(std::numeric_limits<float>::quiet_NaN()))));
+        TS_ASSERT_EQUALS(float(half(1e-9f)), 0.f);
+
+        // the software path must agree with the hardware one on all values
+        for (uint32_t b = 0; b < 0x10000u; b++)
+        {
+            float f = impl::half_to_float_soft(uint16_t(b));
+            if (!std::isnan(f))
+                TS_ASSERT_EQUALS(float(half::from_bits(uint16_t(b))), f);
+        }
+    }
+
+    void testBf16ScalarConversion()
+    {
+        for (float v : {0.f, 1.f, -2.f, 0.5f, 3.0e38f, 1.f / 256.f})
+            TS_ASSERT_DELTA(static_cast<float>(bf16(v)), v, std::abs(v) * 1e-2f);
+
+        // 1 + 2^-8 is halfway between 1 and 1 + 2^-7
+        TS_ASSERT_EQUALS(float(bf16(1.f + 1.f / 256.f)), 1.f);
+        TS_ASSERT(std::isnan(float(bf16(std::numeric_limits<float>::quiet_NaN()))));
+        TS_ASSERT(std::isinf(float(bf16(std::numeric_limits<float>::infinity()))));
+    }
+
+    void testStorageTypes()
+    {
+        TS_ASSERT((Same<Compute_type<half>, float>()));
+        TS_ASSERT((Same<Compute_type<bf16>, float>()));
+        TS_ASSERT((Same<std::common_type_t<half, half>, float>()));
+        TS_ASSERT((Same<std::common_type_t<bf16, double>, double>()));
+    }
+
+    void testHalfRoundTrip()
+    {
+        TS_TRACE("Starting half conversion test");
+        while (keepGoing())
+        {
+            while (repeats --> 0)
+            {
+                auto vecf = getVectorSmall(currentLength);
+
+                CSVector<half> vech(vecf);
+                CSVector<bf16> vecb(vecf);
+                CSVector<float> backh(vech);
+                CSVector<double> backb(vecb);
+
+                for (size_t i = 0; i < currentLength; i++)
+                {
+                    TS_ASSERT_EQUALS(vech[i].bits, half(vecf[i]).bits);
+                    TS_ASSERT_EQUALS(vecb[i].bits, bf16(vecf[i]).bits);
+                    TS_ASSERT_EQUALS(backh[i], float(vech[i]));
+                    TS_ASSERT_EQUALS(backb[i], double(float(vecb[i])));
+                }
+            }
+
+            increaseLength();
+        }
+    }
+
+    void testHalfDot()
+    {
+        TS_TRACE("Starting half dot product test");
+        while (keepGoing())
+        {
+            while (repeats --> 0)
+            {
+                CSVector<half> vec1(getVectorSmall(currentLength));
+                CSVector<bf16> vec2(getVectorSmall(currentLength));
+
+                double expected = 0, expected2 = 0;
+                for (size_t i = 0; i < currentLength; i++)
+                {
+                    expected  += double(float(vec1[i])) * double(float(vec1[i]));
+                    expected2 += double(float(vec1[i])) * double(float(vec2[i]));
+                }
+
+                TS_ASSERT_DELTA(dot(vec1, vec1), expected, 1e-4 * expected + 1e-6);
+                TS_ASSERT_DELTA(dot(vec1, vec2), expected2, 1e-3 * std::abs(expected) + 1e-6);
+            }
+
+            increaseLength();
+        }
+    }
+
+    void testHalfMaxMin()
+    {
+        TS_TRACE("Starting half max, min and supNorm test");
+        while (keepGoing())
+        {
+            while (repeats --> 0)
+            {
+                CSVector<half> vec1(getVectorSmall(currentLength));
+                CSVector<bf16> vec2(getVectorSmall(currentLength));
+
+                float max1 = vec1[0], min1 = vec1[0], sup1 = 0.f;
+                float max2 = vec2[0], min2 = vec2[0], sup2 = 0.f;
+                for (size_t i = 0; i < currentLength; i++)
+                {
+                    max1 = std::max(max1, float(vec1[i]));
+                    min1 = std::min(min1, float(vec1[i]));
+                    sup1 = std::max(sup1, std::abs(float(vec1[i])));
+                    max2 = std::max(max2, float(vec2[i]));
+                    min2 = std::min(min2, float(vec2[i]));
+                    sup2 = std::max(sup2, std::abs(float(vec2[i])));
+                }
+
+                TS_ASSERT_EQUALS(float(max(vec1)), max1);
+                TS_ASSERT_EQUALS(float(min(vec1)), min1);
+                TS_ASSERT_EQUALS(float(supNorm(vec1)), sup1);
+                TS_ASSERT_EQUALS(float(max(vec2)), max2);
+                TS_ASSERT_EQUALS(float(min(vec2)), min2);
+                TS_ASSERT_EQUALS(float(supNorm(vec2)), sup2);
+            }
+
+            increaseLength();
+        }
+
+        TS_ASSERT_THROWS(max(CSVector<half>()), std::runtime_error);
+    }
+
+    void testHalfExpression()
+    {
+        size_t N = 4099;
+        auto vecf = getVectorSmall(N);
+        CSVector<half> vech(vecf);
+        CSVector<bf16> vecb(vecf);
+
+        CSVector<float> res(N);
+        res = 2.f * vech + vecb;
+
+        CSVector<half> resh(N);
+        resh = vech - 0.5f * vecf;
+
+        for (size_t i = 0; i < N; i++)
+        {
+            TS_ASSERT_EQUALS(res[i], 2.f * float(vech[i]) + float(vecb[i]));
+            TS_ASSERT_EQUALS(resh[i].bits, half(float(vech[i]) - 0.5f * vecf[i]).bits);
+        }
+    }
+};
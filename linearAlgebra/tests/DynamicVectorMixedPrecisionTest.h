@@ -0,0 +1,168 @@
+// test
+#define _NO_CORE_
+
+#include <cxxtest/TestSuite.h>
+
+#include <iostream>
+#include <string>
+#include <memory>
+#include <functional>
+
+#include "DynamicVectorCommonTest.h"
+
+#define private public
+#define protected public
+#include "DynamicVector.h"
+
+using namespace std;
+
+class CSVectorTest : public CxxTest::TestSuite
+{
+private:
+    const double tol = 1.e-8;
+
+    int repeats;
+    size_t currentLength;
+    size_t size_step = 256 * 1024;
+
+    const size_t mbytes = 8;
+    const size_t vectorLength = mbytes * 1024 * 1024 / sizeof(double);
+
+    void increaseLength()
+    {
+        if (currentLength <= 1024)
+            currentLength++;
+        else
+        {
+            currentLength += size_step;
+            currentLength = std::min(currentLength, vectorLength);
+        }
+
+        repeats = 10;
+    }
+
+    bool keepGoing()
+    {
+        return (currentLength < vectorLength);
+    }
+
+    template <class T, class U>
+    double dotProductDouble(const CSVector<T>& lhs, const CSVector<U>& rhs)
+    {
+        double ret = 0;
+        for (size_t i = 0; i < lhs.size(); i++)
+            ret += double(lhs[i]) * double(rhs[i]);
+        return ret;
+    }
+
+public:
+
+    void setUp()
+    {
+        repeats = 10;
+        currentLength = 1;
+    }
+
+    void tearDown()
+    {}
+
+    void testAccumulateType()
+    {
+        TS_ASSERT((Same<Accumulate_type<float>, double>()));
+        TS_ASSERT((Same<Accumulate_type<double>, double>()));
+        TS_ASSERT((Same<Accumulate_type<int>, int>()));
+    }
+
+    void testFloatDotDoubleAccumulation()
+    {
+        TS_TRACE("Starting float dot product test");
+        while (keepGoing())
+        {
+            while (repeats --> 0)
+            {
+                auto vec1 = getVectorRandom<float>(currentLength);
+                auto vec2 = getVectorRandom<float>(currentLength);
+
+                auto dotVal = dot(vec1, vec2);
+                TS_ASSERT((Same<decltype(dotVal), double>()));
+
+                double expected = dotProductDouble(vec1, vec2);
+                TS_ASSERT_DELTA(dotVal, expected, 1e-9 * double(currentLength) * 1e6);
+            }
+
+            increaseLength();
+        }
+    }
+
+    void testMixedDot()
+    {
+        TS_TRACE("Starting mixed dot product test");
+        while (keepGoing())
+        {
+            while (repeats --> 0)
+            {
+                auto vec1 = getVectorRandom<float>(currentLength);
+                auto vec2 = getVectorRandom<double>(currentLength);
+
+                double dotVal = dot(vec1, vec2);
+                double expected = dotProductDouble(vec1, vec2);
+                TS_ASSERT_DELTA(dotVal, expected, 1e-9 * double(currentLength) * 1e6);
+            }
+
+            increaseLength();
+        }
+    }
+
+    void testConvertingAssignment()
+    {
+        TS_TRACE("Starting converting assignment test");
+        while (keepGoing())
+        {
+            while (repeats --> 0)
+            {
+                auto vecd = getVectorRandom<double>(currentLength);
+                CSVector<float> vecf(currentLength);
+
+                vecf = vecd;
+                for (size_t i = 0; i < currentLength; i++)
+                    TS_ASSERT_EQUALS(vecf[i], float(vecd[i]));
+
+                CSVector<double> back(vecf);
+                for (size_t i = 0; i < currentLength; i++)
+                    TS_ASSERT_EQUALS(back[i], double(vecf[i]));
+            }
+
+            increaseLength();
+        }
+    }
+
+    void testCastExpression()
+    {
+        TS_TRACE("Starting cast expression test");
+        while (keepGoing())
+        {
+            while (repeats --> 0)
+            {
+                auto vecf = getVectorRandom<float>(currentLength);
+                auto vecd = getVectorRandom<double>(currentLength);
+
+                CSVector<double> res(currentLength);
+                res = 2. * cast<double>(vecf) + vecd;
+
+                for (size_t i = 0; i < currentLength; i++)
+                    TS_ASSERT_DELTA(res[i], 2. * double(vecf[i]) + vecd[i], tol);
+            }
+
+            increaseLength();
+        }
+    }
+
+    void testFloatNormDoubleAccumulation()
+    {
+        auto vec = getVectorRandom<float>(4096);
+        auto norm2 = Norm2(vec);
+        TS_ASSERT((Same<decltype(norm2), double>()));
+        TS_ASSERT_DELTA(norm2, std::sqrt(dotProductDouble(vec, vec)), 1e-6);
+        TS_ASSERT_DELTA(norm(vec), std::sqrt(dotProductDouble(vec, vec)), 1e-6);
+    }
+};
@@ -0,0 +1,178 @@
+// test
+#define _NO_CORE_
+
+#include <cxxtest/TestSuite.h>
+
+#include <iostream>
+#include <string>
+#include <memory>
+#include <limits>
+
+#include "DynamicVectorCommonTest.h"
+
+#define private public
+#define protected public
+#include "DynamicVector.h"
+#include "DynamicVectorPredicates.h"
+#include "HalfPrecision.h"
+
+using namespace std;
+
+class CSVectorTest : public CxxTest::TestSuite
+{
+private:
+    int repeats;
+    size_t currentLength;
+    size_t size_step = 256 * 1024;
+
+    const size_t mbytes = 8;
+    const size_t vectorLength = mbytes * 1024 * 1024 / sizeof(double);
+
+    void increaseLength()
+    {
+        if (currentLength <= 1024)
+            currentLength++;
+        else
+        {
+            currentLength += size_step;
+            currentLength = std::min(currentLength, vectorLength);
+        }
+
+        repeats = 3;
+    }
+
+    bool keepGoing()
+    {
+        return (currentLength < vectorLength);
+    }
+
+public:
+
+    void setUp()
+    {
+        repeats = 3;
+        currentLength = 1;
+    }
+
+    void tearDown()
+    {}
+
+    void testFiniteNaN()
+    {
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        const double inf = std::numeric_limits<double>::infinity();
+
+        TS_TRACE("Starting finite test");
+        while (keepGoing())
+        {
+            while (repeats --> 0)
+            {
+                auto vec = getVectorRandom<double>(currentLength);
+                TS_ASSERT(allFinite(vec));
+                TS_ASSERT(!anyNaN(vec));
+
+                size_t pos = size_t(std::abs(vec[0])) % currentLength;
+                vec[pos] = inf;
+                TS_ASSERT(!allFinite(vec));
+                TS_ASSERT(!anyNaN(vec));
+
+                vec[pos] = nan;
+                TS_ASSERT(!allFinite(vec));
+                TS_ASSERT(anyNaN(vec));
+                TS_ASSERT_EQUALS(findFirst(vec, [](double x) { return impl::is_nan(x); }), pos);
+            }
+
+            increaseLength();
+        }
+    }
+
+    // the classification by bits, for the other element types
+    void testFiniteNaNTypes()
+    {
+        TS_TRACE("Starting finite types test");
+
+        const float fmax = std::numeric_limits<float>::max();
+        CSVector<float> f = {0.f, -0.f, fmax, -fmax, std::numeric_limits<float>::denorm_min()};
+        TS_ASSERT(allFinite(f));
+        TS_ASSERT(!anyNaN(f));
+        f[2] = -std::numeric_limits<float>::infinity();
+        TS_ASSERT(!allFinite(f));
+        TS_ASSERT(!anyNaN(f));
+        f[2] = -std::numeric_limits<float>::quiet_NaN();
+        TS_ASSERT(anyNaN(f));
+
+        CSVector<double> d = {std::numeric_limits<double>::max(), std::numeric_limits<double>::denorm_min()};
+        TS_ASSERT(allFinite(d));
+        TS_ASSERT(!allFinite(2. * d + d));
+
+        CSVector<std::complex<double> > c(5, std::complex<double>(1., 2.));
+        TS_ASSERT(allFinite(c));
+        c[3] = std::complex<double>(1., std::numeric_limits<double>::quiet_NaN());
+        TS_ASSERT(anyNaN(c));
+        TS_ASSERT(!allFinite(c));
+
+        CSVector<half> h(7, half(65504.f));
+        TS_ASSERT(allFinite(h));
+        h[6] = half(std::numeric_limits<float>::infinity());
+        TS_ASSERT(!allFinite(h));
+        TS_ASSERT(!anyNaN(h));
+        h[6] = half(std::numeric_limits<float>::quiet_NaN());
+        TS_ASSERT(anyNaN(h));
+    }
+
+    void testFindFirst()
+    {
+        TS_TRACE("Starting find first test");
+        while (keepGoing())
+        {
+            while (repeats --> 0)
+            {
+                auto vec = getVectorRandom<double>(currentLength);
+
+                size_t expected = currentLength;
+                for (size_t i = 0; i < currentLength; i++)
+                    if (vec[i] > 900.)
+                    {
+                        expected = i;
+                        break;
+                    }
+
+                TS_ASSERT_EQUALS(findFirst(vec, [](double x) { return x > 900.; }), expected);
+                TS_ASSERT_EQUALS(findFirst(vec, [](double x) { return x > 1e3; }), currentLength);
+
+                // works on expressions too
+                TS_ASSERT_EQUALS(findFirst(2. * vec, [](double x) { return x > 1800.; }), expected);
+            }
+
+            increaseLength();
+        }
+    }
+
+    void testApproxEqual()
+    {
+        TS_TRACE("Starting approximately equal test");
+        while (keepGoing())
+        {
+            while (repeats --> 0)
+            {
+                auto vec1 = getVectorRandom<double>(currentLength);
+                CSVector<double> vec2 = vec1 + 1e-10;
+
+                TS_ASSERT(approxEqual(vec1, vec2, 1e-9));
+                TS_ASSERT(!approxEqual(vec1, vec2, 1e-11));
+
+                CSVector<double> vec3 = vec1 * (1. + 1e-9);
+                TS_ASSERT(approxEqual(vec1, vec3, 0., 1e-6));
+                TS_ASSERT(!approxEqual(vec1, 2. * vec3, 0., 1e-6));
+
+                vec2[currentLength - 1] = std::numeric_limits<double>::quiet_NaN();
+                TS_ASSERT(!approxEqual(vec1, vec2, 1.));
+            }
+
+            increaseLength();
+        }
+
+        CSVector<double> a(3), b(4);
+        TS_ASSERT_THROWS(approxEqual(a, b, 1.), std::runtime_error);
+    }
+};
@@ -0,0 +1,173 @@
+// test
+#define _NO_CORE_
+
+#include <cxxtest/TestSuite.h>
+
+#include <iostream>
+#include <string>
+#include <memory>
+#include <numeric>
+
+#include "DynamicVectorCommonTest.h"
+
+#define private public
+#define protected public
+#include "DynamicVector.h"
+#include "DynamicVectorScan.h"
+
+using namespace std;
+
+class CSVectorTest : public CxxTest::TestSuite
+{
+private:
+    int repeats;
+    size_t currentLength;
+    size_t size_step = 256 * 1024;
+
+    const size_t mbytes = 8;
+    const size_t vectorLength = mbytes * 1024 * 1024 / sizeof(double);
+
+    void increaseLength()
+    {
+        if (currentLength <= 1024)
+            currentLength++;
+        else
+        {
+            currentLength += size_step;
+            currentLength = std::min(currentLength, vectorLength);
+        }
+
+        repeats = 3;
+    }
+
+    bool keepGoing()
+    {
+        return (currentLength < vectorLength);
+    }
+
+public:
+
+    void setUp()
+    {
+        repeats = 3;
+        currentLength = 1;
+    }
+
+    void tearDown()
+    {}
+
+    void testInclusiveSum()
+    {
+        TS_TRACE("Starting inclusive scan test");
+        while (keepGoing())
+        {
+            while (repeats --> 0)
+            {
+                auto vec = getVectorRandom<double>(currentLength);
+                CSVector<double> result;
+                inclusiveScan(vec, result);
+
+                TS_ASSERT_EQUALS(result.size(), currentLength);
+
+                // the sums are associated differently, compare relative to sum |x|
+                double s = 0, a = 0;
+                for (size_t i = 0; i < currentLength; ++i)
+                {
+                    s += vec[i];
+                    a += std::abs(vec[i]);
+                    TS_ASSERT_DELTA(result[i], s, 1e-12 * a);
+                }
+            }
+
+            increaseLength();
+        }
+    }
+
+    void testExclusiveInteger()
+    {
+        TS_TRACE("Starting exclusive scan test");
+        while (keepGoing())
+        {
+            while (repeats --> 0)
+            {
+                CSVector<long> vec(currentLength);
+                for (size_t i = 0; i < currentLength; ++i)
+                    vec[i] = long(i % 7);
+
+                CSVector<long> result(currentLength);
+                exclusiveScan(vec, result, 3l);
+
+                std::vector<long> expected(currentLength);
+                std::exclusive_scan(vec.begin(), vec.end(), expected.begin(), 3l);
+
+                bool same = true;
+                for (size_t i = 0; i < currentLength; ++i)
+                    same &= (result[i] == expected[i]);
+                TS_ASSERT(same);
+
+                // in place
+                inclusiveScan(vec, vec);
+                long total = 0;
+                for (size_t i = 0; i < currentLength; ++i)
+                {
+                    total += long(i % 7);
+                    same &= (vec[i] == total);
+                }
+                TS_ASSERT(same);
+            }
+
+            increaseLength();
+        }
+    }
+
+    void testOperator()
+    {
+        TS_TRACE("Starting scan operator test");
+        for (size_t N : {size_t(1), size_t(1000), vectorLength})
+        {
+            CSVector<int> vec(N);
+            for (size_t i = 0; i < N; ++i)
+                vec[i] = int((i * 7919) % 1000);
+
+            auto maxop = [](int a, int b) { return std::max(a, b); };
+
+            CSVector<int> result;
+            inclusiveScan(vec, result, maxop);
+
+            int m = vec[0];
+            bool same = true;
+            for (size_t i = 0; i < N; ++i)
+            {
+                m = std::max(m, vec[i]);
+                same &= (result[i] == m);
+            }
+            TS_ASSERT(same);
+
+            exclusiveScan(vec, result, -1, maxop);
+            m = -1;
+            for (size_t i = 0; i < N; ++i)
+            {
+                same &= (result[i] == m);
+                m = std::max(m, vec[i]);
+            }
+            TS_ASSERT(same);
+        }
+    }
+
+    void testMoreChunksThanPackets()
+    {
+        TS_TRACE("Starting scan with more chunks than packets test");
+
+        const size_t N = ReductionParallelThreshold + 5;
+        const size_t chunks = Tuning::profile().chunks;
+        Tuning::profile().chunks = N;
+
+        // no chunk is empty, reduce_chunk would count an element twice
+        const size_t Threads = impl::scan_chunks<int>(N);
+        for (size_t c = 0; c < Threads; ++c)
+            TS_ASSERT_LESS_THAN(impl::chunk_start<int>(c, Threads, N),
+                                impl::chunk_start<int>(c + 1, Threads, N));
+
+        Tuning::profile().chunks = chunks;
+    }
+};
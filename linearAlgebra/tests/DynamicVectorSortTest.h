@@ -0,0 +1,147 @@
+// test
+#define _NO_CORE_
+
+#include <cxxtest/TestSuite.h>
+
+#include <iostream>
+#include <string>
+#include <memory>
+#include <algorithm>
+
+#include "DynamicVectorCommonTest.h"
+
+#define private public
+#define protected public
+#include "DynamicVector.h"
+#include "DynamicVectorSort.h"
+
+using namespace std;
+
+class CSVectorTest : public CxxTest::TestSuite
+{
+private:
+    int repeats;
+    size_t currentLength;
+    size_t size_step = 256 * 1024;
+
+    const size_t mbytes = 8;
+    const size_t vectorLength = mbytes * 1024 * 1024 / sizeof(double);
+
+    void increaseLength()
+    {
+        if (currentLength <= 1024)
+            currentLength++;
+        else
+        {
+            currentLength += size_step;
+            currentLength = std::min(currentLength, vectorLength);
+        }
+
+        repeats = 3;
+    }
+
+    bool keepGoing()
+    {
+        return (currentLength < vectorLength);
+    }
+
+public:
+
+    void setUp()
+    {
+        repeats = 3;
+        currentLength = 1;
+    }
+
+    void tearDown()
+    {}
+
+    void testSort()
+    {
+        TS_TRACE("Starting sort test");
+        while (keepGoing())
+        {
+            while (repeats --> 0)
+            {
+                auto vec = getVectorRandom<double>(currentLength);
+                std::vector<double> expected(vec.begin(), vec.end());
+                std::sort(expected.begin(), expected.end());
+
+                sort(vec);
+
+                bool same = true;
+                for (size_t i = 0; i < currentLength; ++i)
+                    same &= (vec[i] == expected[i]);
+                TS_ASSERT(same);
+
+                sort(vec, std::greater<double>());
+                TS_ASSERT(std::is_sorted(vec.begin(), vec.end(), std::greater<double>()));
+            }
+
+            increaseLength();
+        }
+    }
+
+    void testArgsort()
+    {
+        TS_TRACE("Starting argsort test");
+        for (size_t N : {size_t(1), size_t(1000), vectorLength})
+        {
+            // many equal keys
+            CSVector<int> keys(N);
+            CSVector<double> values(N);
+            for (size_t i = 0; i < N; ++i)
+            {
+                keys[i]   = int((i * 7919) % 101);
+                values[i] = double(i);
+            }
+
+            auto p = argsort(keys);
+            bool ok = true;
+            for (size_t i = 1; i < N; ++i)
+                ok &= (keys[p[i - 1]] < keys[p[i]]) || (keys[p[i - 1]] == keys[p[i]] && p[i - 1] < p[i]);
+            TS_ASSERT(ok);
+
+            sortByKey(keys, values);
+            TS_ASSERT(std::is_sorted(keys.begin(), keys.end()));
+            for (size_t i = 0; i < N; ++i)
+                ok &= (values[i] == double(p[i]));
+            TS_ASSERT(ok);
+        }
+    }
+
+    void testSelect()
+    {
+        TS_TRACE("Starting select test");
+        for (size_t N : {size_t(1), size_t(999), size_t(100000), vectorLength})
+        {
+            auto vec = getVectorRandom<double>(N);
+            std::vector<double> sorted(vec.begin(), vec.end());
+            std::sort(sorted.begin(), sorted.end());
+
+            for (size_t k : {size_t(0), N / 3, N / 2, N - 1})
+            {
+                TS_ASSERT_EQUALS(select(vec, k), sorted[k]);
+
+                auto copy = vec;
+                nthElement(copy, k);
+                TS_ASSERT_EQUALS(copy[k], sorted[k]);
+
+                bool ok = true;
+                for (size_t i = 0; i < k; ++i)
+                    ok &= !(copy[k] < copy[i]);
+                for (size_t i = k + 1; i < N; ++i)
+                    ok &= !(copy[i] < copy[k]);
+                TS_ASSERT(ok);
+            }
+        }
+
+        // many duplicates, the bracket is wide
+        CSVector<int> vec(vectorLength);
+        for (size_t i = 0; i < vectorLength; ++i)
+            vec[i] = int(i % 3);
+        TS_ASSERT_EQUALS(select(vec, vectorLength / 2), 1);
+
+        TS_ASSERT_THROWS(select(vec, vectorLength), std::runtime_error);
+    }
+};
@@ -0,0 +1,128 @@
+// test
+#define _NO_CORE_
+
+#include <cxxtest/TestSuite.h>
+
+#include <iostream>
+#include <string>
+#include <memory>
+#include <algorithm>
+
+#include "DynamicVectorCommonTest.h"
+
+#define private public
+#define protected public
+#include "DynamicVector.h"
+
+using namespace std;
+
+class CSVectorTest : public CxxTest::TestSuite
+{
+private:
+    int repeats;
+    size_t currentLength;
+    size_t size_step = 256 * 1024;
+
+    const size_t mbytes = 8;
+    const size_t vectorLength = mbytes * 1024 * 1024 / sizeof(double);
+
+    void increaseLength()
+    {
+        if (currentLength <= 1024)
+            currentLength++;
+        else
+        {
+            currentLength += size_step;
+            currentLength = std::min(currentLength, vectorLength);
+        }
+
+        repeats = 3;
+    }
+
+    bool keepGoing()
+    {
+        return (currentLength < vectorLength);
+    }
+
+public:
+
+    void setUp()
+    {
+        repeats = 3;
+        currentLength = 1;
+    }
+
+    void tearDown()
+    {}
+
+    void testStatistics()
+    {
+        TS_TRACE("Starting statistics test");
+        while (keepGoing())
+        {
+            while (repeats --> 0)
+            {
+                auto vec = getVectorRandom<double>(currentLength);
+
+                // two pass reference
+                double mean = 0, lo = vec[0], hi = vec[0];
+                for (size_t i = 0; i < currentLength; ++i)
+                {
+                    mean += vec[i];
+                    lo = std::min(lo, vec[i]);
+                    hi = std::max(hi, vec[i]);
+                }
+                mean /= double(currentLength);
+
+                double M2 = 0, M3 = 0, M4 = 0;
+                for (size_t i = 0; i < currentLength; ++i)
+                {
+                    double d = vec[i] - mean;
+                    M2 += d * d;
+                    M3 += d * d * d;
+                    M4 += d * d * d * d;
+                }
+
+                auto stats = statistics(vec);
+                TS_ASSERT_EQUALS(stats.count, currentLength);
+                TS_ASSERT_DELTA(stats.mean, mean, 1e-10 * (std::abs(mean) + std::abs(hi) + std::abs(lo)));
+                TS_ASSERT_DELTA(stats.M2, M2, 1e-10 * M2 + 1e-12);
+                TS_ASSERT_EQUALS(stats.min, lo);
+                TS_ASSERT_EQUALS(stats.max, hi);
+
+                auto m = moments(vec);
+                TS_ASSERT_DELTA(m.M2, M2, 1e-10 * M2 + 1e-12);
+                TS_ASSERT_DELTA(m.M3, M3, 1e-8 * std::sqrt(M2 * M4) + 1e-12);
+                TS_ASSERT_DELTA(m.M4, M4, 1e-10 * M4 + 1e-12);
+            }
+
+            increaseLength();
+        }
+    }
+
+    void testExpression()
+    {
+        auto vec1 = getVectorRandom<double>(10000);
+        auto vec2 = getVectorRandom<double>(10000);
+
+        auto stats = statistics(vec1 - vec2);
+        TS_ASSERT_DELTA(stats.mean, mean(vec1 - vec2), 1e-10 * max(abs(vec1 - vec2)));
+        TS_ASSERT_EQUALS(stats.min, min(vec1 - vec2));
+        TS_ASSERT_EQUALS(stats.max, max(vec1 - vec2));
+    }
+
+    void testStability()
+    {
+        TS_TRACE("Starting statistics stability test");
+
+        // a large offset with small spread, the naive formula loses all digits
+        const size_t N = vectorLength;
+        CSVector<double> vec(N);
+        for (size_t i = 0; i < N; ++i)
+            vec[i] = 1e9 + ((i % 2) ? 1. : -1.);
+
+        auto stats = statistics(vec);
+        TS_ASSERT_DELTA(stats.mean, 1e9, 1e-6);
+        TS_ASSERT_DELTA(stats.variance(), 1., 1e-6);
+    }
+};
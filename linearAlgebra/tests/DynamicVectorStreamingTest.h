@@ -0,0 +1,130 @@
+// test
+#define _NO_CORE_
+
+// stream everything above 64 KiB, so that the tests exercise both paths
+#define STREAMING_STORE_THRESHOLD (64ul * 1024)
+
+#include <cxxtest/TestSuite.h>
+
+#include <iostream>
+#include <string>
+#include <memory>
+
+#include "DynamicVectorCommonTest.h"
+
+#define private public
+#define protected public
+#include "DynamicVector.h"
+
+using namespace std;
+
+class CSVectorTest : public CxxTest::TestSuite
+{
+private:
+    int repeats;
+    size_t currentLength;
+    size_t size_step = 256 * 1024;
+
+    const size_t mbytes = 8;
+    const size_t vectorLength = mbytes * 1024 * 1024 / sizeof(double);
+
+    void increaseLength()
+    {
+        if (currentLength <= 1024)
+            currentLength++;
+        else
+        {
+            currentLength += size_step;
+            currentLength = std::min(currentLength, vectorLength);
+        }
+
+        repeats = 3;
+    }
+
+    bool keepGoing()
+    {
+        return (currentLength < vectorLength);
+    }
+
+public:
+
+    void setUp()
+    {
+        repeats = 3;
+        currentLength = 1;
+    }
+
+    void tearDown()
+    {}
+
+    void testAssign()
+    {
+        TS_TRACE("Starting streaming assign test");
+        while (keepGoing())
+        {
+            while (repeats --> 0)
+            {
+                auto vec1 = getVectorRandom<double>(currentLength);
+                auto vec2 = getVectorRandom<double>(currentLength);
+
+                CSVector<double> result(currentLength);
+                result = 2. * vec1 + vec2;
+
+                bool same = true;
+                for (size_t i = 0; i < currentLength; ++i)
+                    same &= (result[i] == 2. * vec1[i] + vec2[i]);
+                TS_ASSERT(same);
+
+                result = 3.;
+                for (size_t i = 0; i < currentLength; ++i)
+                    same &= (result[i] == 3.);
+                TS_ASSERT(same);
+
+                streamAssign(result, vec1 - vec2);
+                for (size_t i = 0; i < currentLength; ++i)
+                    same &= (result[i] == vec1[i] - vec2[i]);
+                TS_ASSERT(same);
+
+                // compound assignments read the destination
+                result += vec2;
+                for (size_t i = 0; i < currentLength; ++i)
+                    same &= (std::abs(result[i] - vec1[i]) <= 1e-12 * (std::abs(vec1[i]) + std::abs(vec2[i])));
+                TS_ASSERT(same);
+            }
+
+            increaseLength();
+        }
+    }
+
+    void testCopyFill()
+    {
+        TS_TRACE("Starting streaming copy and fill test");
+        while (keepGoing())
+        {
+            while (repeats --> 0)
+            {
+                auto vec1 = getVectorRandom<float>(currentLength);
+
+                CSVector<float> copy(vec1);
+                bool same = true;
+                for (size_t i = 0; i < currentLength; ++i)
+                    same &= (copy[i] == vec1[i]);
+                TS_ASSERT(same);
+
+                copy.setZero();
+                for (size_t i = 0; i < currentLength; ++i)
+                    same &= (copy[i] == 0.f);
+                TS_ASSERT(same);
+
+                // the filled part starts unaligned
+                copy.resize(currentLength / 3 + 1);
+                copy.resizeAndFill(2 * currentLength, 5.f);
+                for (size_t i = currentLength / 3 + 1; i < 2 * currentLength; ++i)
+                    same &= (copy[i] == 5.f);
+                TS_ASSERT(same);
+            }
+
+            increaseLength();
+        }
+    }
+};
@@ -0,0 +1,163 @@
+// test
+#define _NO_CORE_
+#define FASTVECTOR_INSTRUMENTATION
+
+#include <cxxtest/TestSuite.h>
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <memory>
+
+#include "DynamicVectorCommonTest.h"
+
+#define private public
+#define protected public
+#include "DynamicVector.h"
+
+using namespace std;
+
+class CSVectorTest : public CxxTest::TestSuite
+{
+private:
+    int repeats;
+    size_t currentLength;
+    size_t size_step = 64 * 1024;
+
+    const size_t mbytes = 2;
+    const size_t vectorLength = mbytes * 1024 * 1024 / sizeof(double);
+
+    void increaseLength()
+    {
+        if (currentLength <= 1024)
+            currentLength++;
+        else
+        {
+            currentLength += size_step;
+            currentLength = std::min(currentLength, vectorLength);
+        }
+
+        repeats = 3;
+    }
+
+    bool keepGoing()
+    {
+        return (currentLength < vectorLength);
+    }
+
+    static Instrumentation::Record find(const std::string& label)
+    {
+        for (const auto& record : Instrumentation::snapshot())
+            if (record.label == label)
+                return record;
+
+        return Instrumentation::Record();
+    }
+
+public:
+
+    void setUp()
+    {
+        repeats = 3;
+        currentLength = 1;
+        Instrumentation::reset();
+    }
+
+    void tearDown()
+    {}
+
+    void testCounts()
+    {
+        TS_TRACE("Starting instrumentation count test");
+
+        size_t calls = 0, elements = 0;
+        while (keepGoing())
+        {
+            while (repeats --> 0)
+            {
+                auto vec1 = getVectorRandom<double>(currentLength);
+                auto vec2 = getVectorRandom<double>(currentLength);
+
+                CSVector<double> result(currentLength);
+                result = vec1 + vec2;
+                result += vec1;
+
+                TS_ASSERT_DELTA(dot(vec1, vec2), dot(vec2, vec1), 1e-10 * double(currentLength));
+                TS_ASSERT_LESS_THAN_EQUALS(min(vec1), max(vec1));
+                TS_ASSERT_LESS_THAN_EQUALS(0., oneNorm(vec1 - vec2));
+
+                calls++;
+                elements += currentLength;
+            }
+
+            increaseLength();
+        }
+
+        const auto assignment = find(type_name<assign<double, double> >());
+        TS_ASSERT_EQUALS(assignment.calls, calls);
+        TS_ASSERT_EQUALS(assignment.elements, elements);
+        TS_ASSERT_EQUALS(assignment.bytes, elements * sizeof(double));
+
+        const auto compound = find(type_name<plus_assign<double, double> >());
+        TS_ASSERT_EQUALS(compound.calls, calls);
+        TS_ASSERT_EQUALS(compound.bytes, 2 * elements * sizeof(double));
+
+        const auto d = find("dot, " + type_name<double, double>());
+        TS_ASSERT_EQUALS(d.calls, 2 * calls);
+        TS_ASSERT_EQUALS(d.bytes, 4 * elements * sizeof(double));
+        TS_ASSERT_LESS_THAN(0u, d.cycles);
+
+        TS_ASSERT_EQUALS(find("max, " + type_name<double>()).calls, calls);
+        TS_ASSERT_EQUALS(find("min, " + type_name<double>()).elements, elements);
+
+        const auto norm = find(type_name<one_norm_functor, double>());
+        TS_ASSERT_EQUALS(norm.calls, calls);
+        TS_ASSERT_EQUALS(norm.elements, elements);
+
+        Instrumentation::reset();
+        TS_ASSERT(Instrumentation::snapshot().empty());
+    }
+
+    void testThreads()
+    {
+        TS_TRACE("Starting instrumentation thread test");
+
+        const size_t N = 1 << 16;
+        auto work = [N]()
+        {
+            auto vec1 = getVectorRandom<float>(N);
+            CSVector<float> result(N);
+            for (int i = 0; i < 10; ++i)
+                result = 2.f * vec1;
+        };
+
+        // the counters of exited threads are kept
+        std::thread t1(work), t2(work);
+        t1.join();
+        t2.join();
+        work();
+
+        const auto assignment = find(type_name<assign<float, float> >());
+        TS_ASSERT_EQUALS(assignment.calls, 30u);
+        TS_ASSERT_EQUALS(assignment.elements, 30 * N);
+    }
+
+    void testReport()
+    {
+        TS_TRACE("Starting instrumentation report test");
+
+        auto vec1 = getVectorRandom<double>(1000);
+        TS_ASSERT_LESS_THAN_EQUALS(0., supNorm(vec1));
+
+        std::ostringstream json, table;
+        Instrumentation::dump(json);
+        Instrumentation::report(table);
+
+        const std::string label = "supNorm, " + type_name<double>();
+        TS_ASSERT(json.str().find("{\"label\": \"" + label + "\", \"calls\": 1, \"elements\": 1000, \"bytes\": 8000")
+                  != std::string::npos);
+        TS_ASSERT(table.str().find(label) != std::string::npos);
+        TS_ASSERT_EQUALS(Hooks::json_escape("a\"b\\"), "a\\\"b\\\\");
+    }
+};
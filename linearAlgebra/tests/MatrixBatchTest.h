@@ -0,0 +1,214 @@
+// test
+#define _NO_CORE_
+
+#include <cxxtest/TestSuite.h>
+
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "DynamicVectorCommonTest.h"
+
+#include "MatrixBatch.h"
+
+using namespace std;
+using namespace BasicDatatypes;
+
+class MatrixBatchTest : public CxxTest::TestSuite
+{
+private:
+    double tol = 1e-12;
+    std::mt19937 generator {42};
+
+    std::vector<Tensor> tensors(size_t n)
+    {
+        std::uniform_real_distribution<double> uniform(-1., 1.);
+
+        std::vector<Tensor> ret(n);
+        for (auto& t : ret)
+        {
+            for (auto& value : t)
+                value = uniform(generator);
+            for (size_t i = 0; i < 3; ++i)
+                t(i, i) += 3.;
+        }
+        return ret;
+    }
+
+    std::vector<SymTensor> symmetric(size_t n)
+    {
+        std::uniform_real_distribution<double> uniform(-1., 1.);
+
+        std::vector<SymTensor> ret(n);
+        for (auto& t : ret)
+            for (auto& value : t)
+                value = uniform(generator);
+        return ret;
+    }
+
+    std::vector<Vector3d> points(size_t n)
+    {
+        std::uniform_real_distribution<double> uniform(-10., 10.);
+
+        std::vector<Vector3d> ret(n);
+        for (auto& p : ret)
+            p = Vector3d(uniform(generator), uniform(generator), uniform(generator));
+        return ret;
+    }
+
+    template <typename A, typename B>
+    void assert_equals(const A& a, const B& b, double eps)
+    {
+        for (size_t i = 0; i < 3; ++i)
+            for (size_t j = 0; j < 3; ++j)
+                TS_ASSERT_DELTA(a(i, j), b(i, j), eps);
+    }
+
+    void assert_equals(const Vector3d& a, const Vector3d& b, double eps)
+    {
+        TS_ASSERT_DELTA(a.x, b.x, eps);
+        TS_ASSERT_DELTA(a.y, b.y, eps);
+        TS_ASSERT_DELTA(a.z, b.z, eps);
+    }
+
+    // A V = V diag(values), V orthogonal, and the values ascending
+    void check_eigen(const SymTensor& a, const Vector3d& values, const Tensor& v, double eps)
+    {
+        TS_ASSERT_LESS_THAN_EQUALS(values[0], values[1]);
+        TS_ASSERT_LESS_THAN_EQUALS(values[1], values[2]);
+
+        assert_equals(transpose(v) * v, Tensor::identity(), eps);
+
+        for (size_t k = 0; k < 3; ++k)
+            for (size_t i = 0; i < 3; ++i)
+            {
+                double av = 0.;
+                for (size_t j = 0; j < 3; ++j)
+                    av += a(i, j) * v(j, k);
+                TS_ASSERT_DELTA(av, values[k] * v(i, k), eps);
+            }
+    }
+
+public:
+
+    void testLayout()
+    {
+        TS_TRACE("Starting matrix batch layout test");
+
+        const auto t = tensors(100);
+        TensorBatch<double> batch(t);
+
+        TS_ASSERT_EQUALS(batch.size(), 100u);
+        TS_ASSERT_EQUALS(size(batch), 100u);
+        TS_ASSERT_EQUALS(batch.components(), 9u);
+        TS_ASSERT_EQUALS(SymmetricTensorBatch<double>::components(), 6u);
+
+        for (size_t i = 0; i < t.size(); ++i)
+        {
+            TS_ASSERT_EQUALS(batch.column(1, 2)[i], t[i](1, 2));
+            assert_equals(batch(i), t[i], 0.);
+        }
+
+        for (size_t k = 0; k < 9; ++k)
+            TS_ASSERT_EQUALS(reinterpret_cast<uintptr_t>(batch.column(k).data()) % __alignment, 0u);
+
+        const auto s = symmetric(10);
+        SymmetricTensorBatch<double> sym(s);
+        TS_ASSERT_EQUALS(&sym.column(2, 0), &sym.column(0, 2));
+        assert_equals(sym.at(4), s[4], 0.);
+        TS_ASSERT_THROWS(sym.at(10), std::out_of_range);
+
+        TensorBatch<double> copy(batch);
+        copy = batch;
+        copy.set(3, Tensor::identity());
+        assert_equals(copy.to_vector()[3], Tensor::identity(), 0.);
+        assert_equals(batch(3), t[3], 0.);
+    }
+
+    void testInverse()
+    {
+        TS_TRACE("Starting matrix batch inverse test");
+
+        // below and above the parallel threshold
+        for (size_t n : {size_t(1), size_t(37), size_t(ReductionParallelThreshold + 13)})
+        {
+            const auto t = tensors(n);
+            const auto s = symmetric(n);
+            const auto p = points(n);
+            TensorBatch<double> a(t);
+            SymmetricTensorBatch<double> b(s);
+            VectorSoA<double, 3> rhs(p);
+
+            const auto det  = determinant(a);
+            const auto inv  = inverse(a);
+            const auto x    = solve(a, rhs);
+            const auto sdet = determinant(b);
+            const auto sinv = inverse(b);
+            const auto y    = solve(b, rhs);
+
+            for (size_t i = 0; i < n; ++i)
+            {
+                TS_ASSERT_DELTA(det[i], determinant(t[i]), tol);
+                assert_equals(inv(i) * t[i], Tensor::identity(), 1e-12);
+                assert_equals(t[i] * x(i), p[i], 1e-10);
+
+                TS_ASSERT_DELTA(sdet[i], determinant(s[i]), tol);
+                assert_equals(sinv(i), inverse(s[i]), 1e-8 * std::max(1., std::abs(inverse(s[i])(0, 0))));
+                assert_equals(s[i] * y(i), p[i], 1e-8 / std::min(1., std::abs(sdet[i])));
+            }
+        }
+
+        // a singular matrix only spoils its own lane
+        std::vector<Tensor> t = {Tensor::identity(), Tensor(1.), 2. * Tensor::identity()};
+        const auto inv = inverse(TensorBatch<double>(t));
+        assert_equals(inv(0), Tensor::identity(), 0.);
+        TS_ASSERT(!std::isfinite(inv(1)(0, 0)));
+        assert_equals(inv(2), 0.5 * Tensor::identity(), 0.);
+
+        TS_ASSERT_THROWS(solve(TensorBatch<double>(3), VectorSoA<double, 3>(4)), std::runtime_error);
+    }
+
+    void testEigen()
+    {
+        TS_TRACE("Starting matrix batch eigen test");
+
+        for (size_t n : {size_t(5), size_t(ReductionParallelThreshold + 7)})
+        {
+            const auto s = symmetric(n);
+            const auto e = eigen(SymmetricTensorBatch<double>(s));
+
+            for (size_t i = 0; i < n; ++i)
+                check_eigen(s[i], e.values(i), e.vectors(i), 1e-12);
+        }
+
+        // diagonal, repeated and (nearly) degenerate eigenvalues
+        const Tensor r = Tensor::rotate(Normalize(Vector3d(1., 2., -1.)), 0.8);
+        std::vector<SymTensor> s;
+        for (const auto& d : {Vector3d(3., 1., 2.), Vector3d(2., 2., 2.), Vector3d(1., 1., 4.),
+                              Vector3d(1., 1. + 1e-10, -2.), Vector3d(0., 0., 0.),
+                              Vector3d(-1e8, 1., 1e8)})
+        {
+            const Tensor a = r * Tensor({{d.x, 0., 0.}, {0., d.y, 0.}, {0., 0., d.z}}) * transpose(r);
+            s.push_back(SymTensor({{a(0, 0), a(0, 1), a(0, 2)},
+                                   {a(1, 0), a(1, 1), a(1, 2)},
+                                   {a(2, 0), a(2, 1), a(2, 2)}}));
+        }
+        s.push_back(SymTensor({{3., 0., 0.}, {0., 1., 0.}, {0., 0., 2.}}));
+
+        const auto e = eigen(SymmetricTensorBatch<double>(s));
+        for (size_t i = 0; i < s.size(); ++i)
+        {
+            double scale = 1.;
+            for (const auto& value : s[i])
+                scale = std::max(scale, std::abs(value));
+            check_eigen(s[i], e.values(i), e.vectors(i), 1e-12 * scale);
+        }
+
+        assert_equals(e.values(0), Vector3d(1., 2., 3.), 1e-12);
+        assert_equals(e.values(1), Vector3d(2., 2., 2.), 1e-12);
+        assert_equals(e.values(6), Vector3d(1., 2., 3.), 0.);
+        assert_equals(e.vectors(6), Tensor({{0., 0., 1.}, {1., 0., 0.}, {0., 1., 0.}}), 0.);
+    }
+};
@@ -0,0 +1,261 @@
+// test
+#define _NO_CORE_
+
+#include <cxxtest/TestSuite.h>
+
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "../Vector.h"
+
+using namespace std;
+using namespace BasicDatatypes;
+
+class MatrixTest : public CxxTest::TestSuite
+{
+private:
+    double tol = 1e-12;
+    std::mt19937 generator {42};
+
+    template <std::size_t N, std::size_t M>
+    Matrix<double, N, M> random()
+    {
+        std::uniform_real_distribution<double> uniform(-1., 1.);
+
+        Matrix<double, N, M> ret;
+        for (auto& value : ret)
+            value = uniform(generator);
+        return ret;
+    }
+
+    // diagonally dominant, so that it is well conditioned
+    template <std::size_t N>
+    Matrix<double, N, N> regular()
+    {
+        auto ret = random<N, N>();
+        for (std::size_t i = 0; i < N; ++i)
+            ret(i, i) += double(N);
+        return ret;
+    }
+
+    template <typename Derived, std::size_t N, std::size_t M>
+    Matrix<double, N, M> dense(const MatrixBase<Derived, double, N, M>& m)
+    {
+        Matrix<double, N, M> ret;
+        for (std::size_t i = 0; i < N; ++i)
+            for (std::size_t j = 0; j < M; ++j)
+                ret(i, j) = m(i, j);
+        return ret;
+    }
+
+    template <typename D1, typename D2, std::size_t N, std::size_t M>
+    void assert_equals(const MatrixBase<D1, double, N, M>& a, const MatrixBase<D2, double, N, M>& b, double eps)
+    {
+        for (std::size_t i = 0; i < N; ++i)
+            for (std::size_t j = 0; j < M; ++j)
+                TS_ASSERT_DELTA(a(i, j), b(i, j), eps);
+    }
+
+    template <std::size_t N, std::size_t K, std::size_t M>
+    void check_product()
+    {
+        const auto a = random<N, K>();
+        const auto b = random<K, M>();
+        const auto c = a * b;
+
+        for (std::size_t i = 0; i < N; ++i)
+            for (std::size_t j = 0; j < M; ++j)
+            {
+                double sum = 0;
+                for (std::size_t k = 0; k < K; ++k)
+                    sum += a(i, k) * b(k, j);
+                TS_ASSERT_DELTA(c(i, j), sum, tol);
+            }
+
+        ConstantVector<double, K> v;
+        ConstantVector<double, N> w;
+        for (std::size_t k = 0; k < K; ++k)
+            v[k] = double(k) - 1.5;
+        for (std::size_t i = 0; i < N; ++i)
+            w[i] = 0.5 * double(i) + 1.;
+
+        const auto av = a * v;
+        const auto wa = w * a;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            double sum = 0;
+            for (std::size_t k = 0; k < K; ++k)
+                sum += a(i, k) * v[k];
+            TS_ASSERT_DELTA(av[i], sum, tol);
+        }
+
+        for (std::size_t k = 0; k < K; ++k)
+        {
+            double sum = 0;
+            for (std::size_t i = 0; i < N; ++i)
+                sum += w[i] * a(i, k);
+            TS_ASSERT_DELTA(wa[k], sum, tol);
+        }
+
+        const auto t = transpose(a);
+        for (std::size_t i = 0; i < N; ++i)
+            for (std::size_t k = 0; k < K; ++k)
+                TS_ASSERT_EQUALS(t(k, i), a(i, k));
+    }
+
+    template <std::size_t N>
+    void check_inverse()
+    {
+        const auto a = regular<N>();
+        const auto id = Matrix<double, N, N>::identity();
+
+        assert_equals(a * inverse(a), id, 1e-12);
+        assert_equals(inverse(a) * a, id, 1e-12);
+        const double det = LU<double, N>(a).determinant();
+        TS_ASSERT_DELTA(determinant(a), det, 1e-10 * std::abs(det));
+
+        ConstantVector<double, N> b;
+        for (std::size_t i = 0; i < N; ++i)
+            b[i] = double(i + 1);
+
+        const auto x = LU<double, N>(a).solve(b);
+        const auto r = a * x;
+        for (std::size_t i = 0; i < N; ++i)
+            TS_ASSERT_DELTA(r[i], b[i], 1e-12);
+    }
+
+public:
+
+    void testLayout()
+    {
+        TS_TRACE("Starting matrix layout test");
+
+        Matrix<double, 2, 4> m = {{1., 2., 3., 4.}, {5., 6., 7., 8.}};
+        TS_ASSERT_EQUALS(m.size(), 8u);
+        TS_ASSERT_EQUALS(m(0, 3), 4.);
+        TS_ASSERT_EQUALS(m(1, 0), 5.);
+        TS_ASSERT_EQUALS(m[5], 6.);
+        TS_ASSERT_EQUALS(sizeof(m), 8 * sizeof(double) + sizeof(double *));
+
+        m *= 2.;
+        TS_ASSERT_EQUALS(m(1, 3), 16.);
+        m /= 4.;
+        TS_ASSERT_EQUALS(m(1, 3), 4.);
+
+        auto n = 2. * m + m / 2.;
+        TS_ASSERT_EQUALS(n(0, 1), 2.5);
+        auto d = n - m;
+        TS_ASSERT_EQUALS(d(0, 1), 1.5);
+        auto r = 1. / m;
+        TS_ASSERT_EQUALS(r(0, 1), 1.);
+        TS_ASSERT_EQUALS(r(1, 3), 0.25);
+
+        TS_ASSERT_EQUALS(trace(Matrix<double, 5, 5>::identity()), 5.);
+    }
+
+    void testProducts()
+    {
+        TS_TRACE("Starting matrix product test");
+
+        check_product<2, 2, 2>();
+        check_product<3, 3, 3>();
+        check_product<4, 4, 4>();
+        check_product<2, 5, 3>();
+        check_product<8, 8, 8>();
+        check_product<6, 3, 7>();
+
+        // the 3x3 rotations
+        const auto r = Matrix<double, 3, 3>::rotate_z(0.3) * Matrix<double, 3, 3>::rotate_z(0.4);
+        assert_equals(r, Matrix<double, 3, 3>::rotate_z(0.7), tol);
+    }
+
+    void testInverse()
+    {
+        TS_TRACE("Starting matrix inverse test");
+
+        check_inverse<2>();
+        check_inverse<3>();
+        check_inverse<4>();
+        check_inverse<5>();
+        check_inverse<8>();
+
+        Matrix<double, 2, 2> a = {{4., 7.}, {2., 6.}};
+        TS_ASSERT_DELTA(determinant(a), 10., tol);
+        assert_equals(inverse(a), Matrix<double, 2, 2>({{0.6, -0.7}, {-0.2, 0.4}}), tol);
+
+        // a pivot is required
+        Matrix<double, 4, 4> p = {{0., 1., 0., 0.}, {1., 0., 0., 0.}, {0., 0., 0., 2.}, {0., 0., 3., 0.}};
+        TS_ASSERT_DELTA(determinant(p), 6., tol);
+        assert_equals(inverse(p) * p, Matrix<double, 4, 4>::identity(), tol);
+
+        Matrix<double, 4, 4> s = {{1., 2., 3., 4.}, {2., 4., 6., 8.}, {0., 1., 0., 1.}, {1., 0., 1., 0.}};
+        LU<double, 4> lu(s);
+        TS_ASSERT(lu.singular());
+        TS_ASSERT_EQUALS(determinant(s), 0.);
+        TS_ASSERT_THROWS(inverse(s), std::runtime_error);
+        TS_ASSERT_THROWS(inverse(Matrix<double, 3, 3>(1.)), std::runtime_error);
+    }
+
+    void testCholesky()
+    {
+        TS_TRACE("Starting Cholesky test");
+
+        const auto b = regular<5>();
+        const auto a = b * transpose(b);
+
+        Cholesky<double, 5> llt(a);
+        assert_equals(llt.matrixL() * transpose(llt.matrixL()), a, 1e-12);
+        TS_ASSERT_DELTA(llt.determinant(), determinant(a), 1e-10 * determinant(a));
+
+        ConstantVector<double, 5> rhs = {1., -2., 3., 0.5, 4.};
+        const auto x = llt.solve(rhs);
+        const auto r = a * x;
+        for (std::size_t i = 0; i < 5; ++i)
+            TS_ASSERT_DELTA(r[i], rhs[i], 1e-12);
+
+        // from the packed storage
+        SymTensor t = {{4., 1., 2.}, {1., 5., 3.}, {2., 3., 6.}};
+        Cholesky<double, 3> tllt(t);
+        assert_equals(tllt.matrixL() * transpose(tllt.matrixL()), dense(t), 1e-12);
+
+        SymTensor n = {{1., 2., 0.}, {2., 1., 0.}, {0., 0., 1.}};
+        TS_ASSERT_THROWS((Cholesky<double, 3>(n)), std::runtime_error);
+    }
+
+    void testSymmetric()
+    {
+        TS_TRACE("Starting symmetric matrix test");
+
+        SymTensor t = {{1., 2., 3.}, {2., 4., 5.}, {3., 5., 6.}};
+        TS_ASSERT_EQUALS(t.size(), 6u);
+        TS_ASSERT_EQUALS(t(2, 1), 5.);
+        TS_ASSERT_EQUALS(t.yy, 4.);
+        TS_ASSERT_EQUALS(t.yz, 5.);
+        TS_ASSERT_EQUALS(trace(t), 11.);
+        TS_ASSERT_DELTA(determinant(t), -1., tol);
+
+        t(0, 2) = 7.;
+        TS_ASSERT_EQUALS(t(2, 0), 7.);
+
+        SymmetricMatrix<double, 6> s;
+        std::uniform_real_distribution<double> uniform(-1., 1.);
+        for (auto& value : s)
+            value = uniform(generator);
+
+        ConstantVector<double, 6> v = {1., 2., -1., 0.5, 3., -2.};
+        const auto sv = s * v;
+        const auto dv = dense(s) * v;
+        for (std::size_t i = 0; i < 6; ++i)
+            TS_ASSERT_DELTA(sv[i], dv[i], tol);
+
+        const auto m = random<6, 4>();
+        assert_equals(s * m, dense(s) * m, tol);
+        assert_equals(m * transpose(m) * s, m * transpose(m) * dense(s), 1e-12);
+
+        auto scaled = 2. * s;
+        TS_ASSERT_EQUALS(scaled(4, 1), 2. * s(1, 4));
+        TS_ASSERT_EQUALS(scaled.size(), 21u);
+    }
+};
@@ -0,0 +1,184 @@
+// test
+#define _NO_CORE_
+
+#include <cxxtest/TestSuite.h>
+
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "../Vector.h"
+
+using namespace std;
+using namespace BasicDatatypes;
+
+class QuaternionTest : public CxxTest::TestSuite
+{
+private:
+    int repeats = 50;
+    double tol = 1e-12;
+    std::mt19937 generator {42};
+
+    Vector3d random_vector()
+    {
+        std::uniform_real_distribution<double> uniform(-3., 3.);
+        return Vector3d(uniform(generator), uniform(generator), uniform(generator));
+    }
+
+    double random_angle()
+    {
+        std::uniform_real_distribution<double> uniform(-M_PI, M_PI);
+        return uniform(generator);
+    }
+
+    void assert_equals(const Vector3d& a, const Vector3d& b, double eps)
+    {
+        TS_ASSERT_DELTA(a.x, b.x, eps);
+        TS_ASSERT_DELTA(a.y, b.y, eps);
+        TS_ASSERT_DELTA(a.z, b.z, eps);
+    }
+
+    template <typename Matrix>
+    void assert_equals(const Matrix& a, const Matrix& b, double eps)
+    {
+        for (size_t i = 0; i < 3; ++i)
+            for (size_t j = 0; j < 3; ++j)
+                TS_ASSERT_DELTA(a(i, j), b(i, j), eps);
+    }
+
+public:
+
+    void testTransformInverse()
+    {
+        TS_TRACE("Starting transform inverse test");
+
+        const Vector3d v(1., -2., 3.);
+        const Vector3d axis = Normalize(Vector3d(1., 1., -1.));
+
+        auto r = Transform<double>::rotate(axis, 0.4);
+        assert_equals(r.inverse()(r(v)), v, tol);
+        assert_equals(r.inverse().matrix(), Matrix<double, 3, 3>::rotate(axis, -0.4), tol);
+        assert_equals(r.inverse().inverse()(v), r(v), tol);
+
+        auto x = Transform<double>::rotate_x(1.1);
+        assert_equals(x.inverse()(x(v)), v, tol);
+
+        // the anisotropic scaling used to assemble a rotation
+        auto s = Transform<double>::scale(2., 4., 0.5);
+        assert_equals(s(v), Vector3d(2., -8., 1.5), 0.);
+        assert_equals(s.inverse()(v), Vector3d(0.5, -0.5, 6.), 0.);
+
+        auto u = Transform<double>::scale(4.);
+        assert_equals(u.inverse()(v), Vector3d(0.25, -0.5, 0.75), 0.);
+
+        // a general matrix is inverted from its adjugate
+        Transform<double> g(Matrix<double, 3, 3>({{2., 1., 0.}, {0., 3., 1.}, {1., 0., 4.}}));
+        assert_equals(g.inverse()(g(v)), v, tol);
+        TS_ASSERT_DELTA(determinant(g.matrix()), 25., tol);
+
+        Transform<double> singular(Matrix<double, 3, 3>({{1., 2., 3.}, {2., 4., 6.}, {0., 0., 1.}}));
+        TS_ASSERT_THROWS(singular.inverse(), std::runtime_error);
+
+        auto id = Transform<double>::identity();
+        assert_equals(id.inverse()(v), v, 0.);
+    }
+
+    void testRotate()
+    {
+        TS_TRACE("Starting quaternion rotation test");
+
+        for (int k = 0; k < repeats; ++k)
+        {
+            const Vector3d v = random_vector();
+            const Vector3d axis = Normalize(random_vector());
+            const double angle = random_angle();
+
+            const auto q = Quaterniond::rotate(axis, angle);
+            TS_ASSERT_DELTA(Norm(q), 1., tol);
+
+            assert_equals(q(v), Rotate(v, axis, angle), tol);
+            assert_equals(Apply(q, v), Rotate(v, axis, angle), tol);
+            assert_equals(Rotate(v, Vector3d(3. * axis), angle), Rotate(v, axis, angle), tol);
+            assert_equals(q.matrix(), Matrix<double, 3, 3>::rotate(axis, angle), tol);
+            assert_equals(q.inverse()(q(v)), v, tol);
+            assert_equals(q.conjugate()(q(v)), v, tol);
+
+            assert_equals(Quaterniond::rotate_x(angle)(v), Rotate_x(v, angle), tol);
+            assert_equals(Quaterniond::rotate_y(angle)(v), Rotate_y(v, angle), tol);
+            assert_equals(Quaterniond::rotate_z(angle)(v), Rotate_z(v, angle), tol);
+        }
+
+        // the generic path
+        const auto q = Quaternionf::rotate(Vector3f(0.f, 0.f, 1.f), float(M_PI / 2));
+        const auto r = q(Vector3f(1.f, 0.f, 0.f));
+        TS_ASSERT_DELTA(r.x, 0.f, 1e-6);
+        TS_ASSERT_DELTA(r.y, 1.f, 1e-6);
+
+        const Quaternion<long double> l = Quaternion<long double>::rotate_z(M_PI / 2);
+        const auto s = l(ConstantVector<long double, 3>(1., 0., 0.));
+        TS_ASSERT_DELTA(double(s.y), 1., tol);
+    }
+
+    void testCompose()
+    {
+        TS_TRACE("Starting quaternion composition test");
+
+        for (int k = 0; k < repeats; ++k)
+        {
+            const Vector3d v = random_vector();
+            const auto a = Quaterniond::rotate(Normalize(random_vector()), random_angle());
+            const auto b = Quaterniond::rotate(Normalize(random_vector()), random_angle());
+
+            assert_equals((a * b)(v), a(b(v)), 1e-11);
+
+            auto c = a;
+            c *= b;
+            assert_equals(c(v), a(b(v)), 1e-11);
+
+            // the packet and scalar products agree
+            const Quaternion<long double> al(a.w(), a.x(), a.y(), a.z());
+            const Quaternion<long double> bl(b.w(), b.x(), b.y(), b.z());
+            const auto cl = al * bl;
+            TS_ASSERT_DELTA(c.w(), double(cl.w()), tol);
+            TS_ASSERT_DELTA(c.x(), double(cl.x()), tol);
+            TS_ASSERT_DELTA(c.y(), double(cl.y()), tol);
+            TS_ASSERT_DELTA(c.z(), double(cl.z()), tol);
+
+            const auto fa = Quaternionf(float(a.w()), float(a.x()), float(a.y()), float(a.z()));
+            const auto fb = Quaternionf(float(b.w()), float(b.x()), float(b.y()), float(b.z()));
+            const auto fc = fa * fb;
+            TS_ASSERT_DELTA(fc.w(), c.w(), 1e-6);
+            TS_ASSERT_DELTA(fc.x(), c.x(), 1e-6);
+        }
+
+        const auto i = Quaterniond::identity();
+        const auto a = Quaterniond::rotate_y(0.3);
+        TS_ASSERT_EQUALS((i * a).coeffs(), a.coeffs());
+    }
+
+    void testSlerp()
+    {
+        TS_TRACE("Starting quaternion slerp test");
+
+        const Vector3d axis = Normalize(Vector3d(1., 2., 3.));
+        const auto a = Quaterniond::rotate(axis, 0.2);
+        const auto b = Quaterniond::rotate(axis, 1.4);
+
+        const Vector3d v(0., 1., 0.);
+        for (double t : {0., 0.25, 0.5, 1.})
+        {
+            const auto s = Slerp(a, b, t);
+            TS_ASSERT_DELTA(Norm(s), 1., tol);
+            assert_equals(s(v), Rotate(v, axis, 0.2 + t * 1.2), 1e-10);
+        }
+
+        // along the shorter arc, -b is the same rotation as b
+        const Quaterniond nb(-b.w(), -b.x(), -b.y(), -b.z());
+        assert_equals(Slerp(a, nb, 0.5)(v), Rotate(v, axis, 0.8), 1e-10);
+
+        // nearly parallel rotations
+        const auto c = Quaterniond::rotate(axis, 0.2 + 1e-9);
+        assert_equals(Slerp(a, c, 0.5)(v), a(v), 1e-8);
+    }
+};
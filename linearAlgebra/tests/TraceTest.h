@@ -0,0 +1,166 @@
+// test
+#define _NO_CORE_
+#define FASTVECTOR_TRACING
+
+#include <cxxtest/TestSuite.h>
+
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <memory>
+
+#include "DynamicVectorCommonTest.h"
+
+#define private public
+#define protected public
+#include "DynamicVector.h"
+
+using namespace std;
+
+class CSVectorTest : public CxxTest::TestSuite
+{
+private:
+    int repeats;
+    size_t currentLength;
+
+    // the events recorded so far, by label
+    static std::vector<std::pair<std::string, Trace::Event> > events()
+    {
+        std::vector<std::pair<std::string, Trace::Event> > all;
+        Trace::registry().for_each([&](const Trace::Ring& ring, const Hooks::LabelRegistry& labels)
+        {
+            for (const auto& e : ring.recorded())
+                all.emplace_back(labels.label(e.label), e);
+        });
+
+        return all;
+    }
+
+    static size_t count(const std::string& label)
+    {
+        size_t n = 0;
+        for (const auto& e : events())
+            n += (e.first == label);
+        return n;
+    }
+
+public:
+
+    void setUp()
+    {
+        repeats = 3;
+        currentLength = 1;
+        Trace::stop();
+        Trace::clear();
+    }
+
+    void tearDown()
+    {
+        Trace::stop();
+        Trace::clear();
+    }
+
+    void testStopped()
+    {
+        TS_TRACE("Starting stopped trace test");
+
+        auto vec1 = getVectorRandom<double>(1 << 16);
+        CSVector<double> result(1 << 16);
+        result = 2. * vec1;
+
+        TS_ASSERT(events().empty());
+    }
+
+    void testAssignment()
+    {
+        TS_TRACE("Starting assignment trace test");
+
+        const size_t N = 1 << 16;
+        auto vec1 = getVectorRandom<double>(N);
+        auto vec2 = getVectorRandom<double>(N);
+        CSVector<double> result(N);
+
+        Trace::start();
+        for (int i = 0; i < 5; ++i)
+            result = vec1 + vec2;
+        Trace::stop();
+
+        // one event per thread and assignment
+        const std::string label = type_name<decltype(vec1 + vec2)>();
+
+        size_t n = 0;
+        std::set<size_t> threads;
+        Trace::registry().for_each([&](const Trace::Ring& ring, const Hooks::LabelRegistry& labels)
+        {
+            for (const auto& e : ring.recorded())
+                if (labels.label(e.label) == label)
+                {
+                    n++;
+                    threads.insert(ring.thread);
+                    TS_ASSERT_EQUALS(e.size, N);
+                    TS_ASSERT_LESS_THAN_EQUALS(e.begin, e.end);
+                }
+        });
+
+        TS_ASSERT_EQUALS(n, 5 * Tuning::profile().threads);
+        TS_ASSERT_EQUALS(threads.size(), Tuning::profile().threads);
+    }
+
+    void testReduction()
+    {
+        TS_TRACE("Starting reduction trace test");
+
+        const size_t N = 1 << 16;
+        auto vec1 = getVectorRandom<double>(N);
+        auto vec2 = getVectorRandom<double>(N);
+
+        Trace::start();
+        TS_ASSERT_LESS_THAN(0., oneNorm(vec1 + vec2));
+        TS_ASSERT_DELTA(dot(vec1 + vec2, vec1), dot(vec1, vec1) + dot(vec2, vec1), 1e-8 * N * 1e6);
+        Trace::stop();
+
+        // the reductions are cut into the chunks of the tuning profile
+        const size_t chunks = Tuning::chunks();
+        TS_ASSERT_EQUALS(count(type_name<one_norm_functor, decltype(vec1 + vec2)>()), chunks);
+        TS_ASSERT_EQUALS(count("dot, " + type_name<decltype(vec1 + vec2), CSVector<double> >()), chunks);
+
+        // small vectors are reduced in one chunk, outside a parallel region
+        Trace::clear();
+        auto small = getVectorRandom<double>(1000);
+        Trace::start();
+        TS_ASSERT_LESS_THAN(0., oneNorm(small + small));
+        Trace::stop();
+        TS_ASSERT(events().empty());
+    }
+
+    void testDump()
+    {
+        TS_TRACE("Starting trace dump test");
+
+        CSVector<float> x(1 << 16, 1.f), y(1 << 16, 2.f);
+
+        Trace::start();
+        x = x + y;
+        Trace::stop();
+
+        std::ostringstream os;
+        Trace::dump(os);
+
+        const std::string json = os.str();
+        TS_ASSERT_EQUALS(json.find("{\"traceEvents\": ["), 0u);
+        TS_ASSERT(json.find("\"ph\": \"X\"") != std::string::npos);
+        TS_ASSERT(json.find("\"args\": {\"size\": 65536}") != std::string::npos);
+        TS_ASSERT(json.find(Hooks::json_escape(type_name<decltype(x + y)>())) != std::string::npos);
+
+        // the ring keeps the newest events
+        Trace::Ring ring(0);
+        for (size_t i = 0; i < Trace::RingCapacity + 10; ++i)
+            ring.push(Trace::Event{i, i + 1, i, 0});
+
+        const auto recorded = ring.recorded();
+        TS_ASSERT_EQUALS(recorded.size(), Trace::RingCapacity);
+        TS_ASSERT_EQUALS(recorded.front().begin, 10u);
+        TS_ASSERT_EQUALS(recorded.back().begin, Trace::RingCapacity + 9);
+    }
+};
@@ -0,0 +1,171 @@
+// test
+#define _NO_CORE_
+
+#include <cxxtest/TestSuite.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <memory>
+
+#include "DynamicVectorCommonTest.h"
+
+#define private public
+#define protected public
+#include "DynamicVector.h"
+#include "TuningProfile.h"
+
+using namespace std;
+
+class CSVectorTest : public CxxTest::TestSuite
+{
+private:
+    int repeats;
+    size_t currentLength;
+    size_t size_step = 64 * 1024;
+
+    const size_t mbytes = 4;
+    const size_t vectorLength = mbytes * 1024 * 1024 / sizeof(double);
+
+    Tuning::Profile defaults;
+
+    void increaseLength()
+    {
+        if (currentLength <= 1024)
+            currentLength++;
+        else
+        {
+            currentLength += size_step;
+            currentLength = std::min(currentLength, vectorLength);
+        }
+
+        repeats = 3;
+    }
+
+    bool keepGoing()
+    {
+        return (currentLength < vectorLength);
+    }
+
+    // the expression results under the current profile
+    void checkKernels()
+    {
+        while (keepGoing())
+        {
+            while (repeats --> 0)
+            {
+                auto vec1 = getVectorRandom<double>(currentLength);
+                auto vec2 = getVectorRandom<double>(currentLength);
+                auto vec3 = getVectorRandom<float>(currentLength);
+
+                CSVector<double> result(currentLength);
+                result = 2. * vec1 + vec2;
+
+                CSVector<float> fresult(currentLength);
+                fresult = vec3 * vec3;
+
+                bool same = true;
+                double sdot = 0, sabs = 0, smax = vec1[0];
+                for (size_t i = 0; i < currentLength; ++i)
+                {
+                    same &= (result[i] == 2. * vec1[i] + vec2[i]);
+                    same &= (fresult[i] == vec3[i] * vec3[i]);
+                    sdot += vec1[i] * vec2[i];
+                    sabs += std::abs(vec1[i] * vec2[i]);
+                    smax  = std::max(smax, vec1[i]);
+                }
+
+                TS_ASSERT(same);
+                TS_ASSERT_DELTA(dot(vec1, vec2), sdot, 1e-12 * sabs + 1e-300);
+                TS_ASSERT_EQUALS(max(vec1), smax);
+            }
+
+            increaseLength();
+        }
+    }
+
+public:
+
+    void setUp()
+    {
+        repeats = 3;
+        currentLength = 1;
+    }
+
+    void tearDown()
+    {
+        Tuning::profile() = defaults;
+    }
+
+    void testSaveLoad()
+    {
+        TS_TRACE("Starting tuning profile save and load test");
+        const std::string filename = "TuningProfileTest.tuning";
+
+        Tuning::Profile profile;
+        profile.threads            = 3;
+        profile.chunks             = 5;
+        profile.blockSizeDouble    = 8;
+        profile.blockSizeFloat     = 2;
+        profile.prefetchDistance   = 6;
+        profile.streamingThreshold = 12345;
+        TS_ASSERT(profile.save(filename));
+
+        // unknown keys and invalid values are skipped
+        {
+            std::ofstream out(filename, std::ios::app);
+            out << "unknown_key = 5\n";
+            out << "threads = zero\n";
+            out << "# block_size_double = 2\n";
+        }
+
+        Tuning::Profile loaded;
+        TS_ASSERT(loaded.load(filename));
+        TS_ASSERT_EQUALS(loaded.threads, 3u);
+        TS_ASSERT_EQUALS(loaded.chunks, 5u);
+        TS_ASSERT_EQUALS(loaded.blockSizeDouble, 8u);
+        TS_ASSERT_EQUALS(loaded.blockSizeFloat, 2u);
+        TS_ASSERT_EQUALS(loaded.prefetchDistance, 6u);
+        TS_ASSERT_EQUALS(loaded.streamingThreshold, 12345u);
+
+        std::remove(filename.c_str());
+        TS_ASSERT(!loaded.load(filename));
+    }
+
+    void testBlockSizes()
+    {
+        TS_TRACE("Starting tuned block size test");
+
+        Tuning::profile().blockSizeDouble = 2;
+        Tuning::profile().blockSizeFloat  = 4;
+        checkKernels();
+
+        setUp();
+        Tuning::profile().blockSizeDouble = 8;
+        Tuning::profile().blockSizeFloat  = 2;
+        checkKernels();
+
+        // block sizes which aren't compiled in fall back to the default
+        setUp();
+        Tuning::profile().blockSizeDouble = 3;
+        Tuning::profile().blockSizeFloat  = 5;
+        checkKernels();
+    }
+
+    void testThreadsPrefetch()
+    {
+        TS_TRACE("Starting tuned threads, chunks and prefetch test");
+
+        Tuning::profile().threads          = 1;
+        Tuning::profile().chunks           = 1;
+        Tuning::profile().prefetchDistance = 1;
+        checkKernels();
+
+        setUp();
+        Tuning::profile().threads          = 7;
+        Tuning::profile().chunks           = 7;
+        Tuning::profile().prefetchDistance = 16;
+        checkKernels();
+    }
+};
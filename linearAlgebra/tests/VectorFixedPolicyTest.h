@@ -0,0 +1,135 @@
+// test
+#define _NO_CORE_
+#define FASTVECTOR_TRACING
+
+#include <cxxtest/TestSuite.h>
+
+#include <iostream>
+#include <string>
+#include <type_traits>
+
+#include "../Vector.h"
+#include "../DynamicVector.h"
+
+using namespace std;
+
+class VectorFixedPolicyTest : public CxxTest::TestSuite
+{
+private:
+    // the number of events traced in parallel regions
+    static size_t events()
+    {
+        size_t n = 0;
+        Trace::registry().for_each([&](const Trace::Ring& ring, const Hooks::LabelRegistry&)
+        {
+            n += ring.recorded().size();
+        });
+
+        return n;
+    }
+
+    template <typename T, std::size_t N>
+    void check_arithmetic()
+    {
+        ConstantVector<T, N> a, b, c, v;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            a[i] = T(i + 1);
+            b[i] = T(2 * i + 1);
+            c[i] = T(N - i);
+        }
+
+        v = a + b * c;
+        for (std::size_t i = 0; i < N; ++i)
+            TS_ASSERT_EQUALS(v[i], a[i] + b[i] * c[i]);
+
+        v += a;
+        for (std::size_t i = 0; i < N; ++i)
+            TS_ASSERT_EQUALS(v[i], T(2) * a[i] + b[i] * c[i]);
+
+        v -= T(2) * a;
+        for (std::size_t i = 0; i < N; ++i)
+            TS_ASSERT_EQUALS(v[i], b[i] * c[i]);
+
+        v *= c;
+        for (std::size_t i = 0; i < N; ++i)
+            TS_ASSERT_EQUALS(v[i], b[i] * c[i] * c[i]);
+
+        v = T(3);
+        for (std::size_t i = 0; i < N; ++i)
+            TS_ASSERT_EQUALS(v[i], T(3));
+
+        ConstantVector<T, N> w = T(2) * a - b;
+        for (std::size_t i = 0; i < N; ++i)
+            TS_ASSERT_EQUALS(w[i], T(2) * a[i] - b[i]);
+    }
+
+public:
+
+    void setUp()
+    {
+        Trace::stop();
+        Trace::clear();
+    }
+
+    void tearDown()
+    {
+        Trace::stop();
+        Trace::clear();
+    }
+
+    void testPolicySelection()
+    {
+        TS_TRACE("Starting policy selection test");
+
+        using Fixed = BaseConstantVector<ConstantVector<double, 3>, double, 3>;
+        using Sum   = decltype(Vector3d() + Vector3d());
+
+        TS_ASSERT_EQUALS(StaticSize<Fixed>::value, 3u);
+        TS_ASSERT_EQUALS(StaticSize<CSVector<double> >::value, 0u);
+
+        TS_ASSERT((std::is_same<DefaultExecutionPolicy<Fixed, Sum, assign<double, double>, true>,
+                                FixedExecutionPolicy<Fixed, Sum, assign<double, double>, true> >::value));
+        TS_ASSERT((std::is_same<DefaultExecutionPolicy<CSVector<double>, double, assign<double, double>, false>,
+                                ParallelExecutionPolicy<CSVector<double>, double, assign<double, double>, false> >::value));
+    }
+
+    void testArithmetic()
+    {
+        TS_TRACE("Starting fixed size arithmetic test");
+
+        check_arithmetic<double, 2>();
+        check_arithmetic<double, 3>();
+        check_arithmetic<double, 4>();
+        check_arithmetic<double, 7>();
+        check_arithmetic<float, 3>();
+        check_arithmetic<int, 3>();
+    }
+
+    void testNoParallelRegion()
+    {
+        TS_TRACE("Starting fixed size parallel region test");
+
+        Vector3d a(1., 2., 3.), b(4., 5., 6.), v;
+
+        Trace::start();
+        for (int i = 0; i < 100; ++i)
+        {
+            v = a + 2. * b;
+            v += a;
+            v = Normalize(v);
+        }
+        Trace::stop();
+
+        TS_ASSERT_EQUALS(events(), 0u);
+        TS_ASSERT_DELTA(Norm(v), 1., 1e-14);
+
+        // the dynamic vectors still run in parallel
+        CSVector<double> x(1 << 16, 1.), y(1 << 16, 2.);
+        Trace::start();
+        x = x + y;
+        Trace::stop();
+
+        TS_ASSERT_LESS_THAN(0u, events());
+    }
+};
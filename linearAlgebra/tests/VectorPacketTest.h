@@ -0,0 +1,162 @@
+// test
+#define _NO_CORE_
+
+#include <cxxtest/TestSuite.h>
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+
+#include "../Vector.h"
+
+using namespace std;
+
+class VectorPacketTest : public CxxTest::TestSuite
+{
+private:
+    int repeats = 50;
+    std::mt19937 generator {42};
+
+    template <typename T, std::size_t N>
+    ConstantVector<T, N> random()
+    {
+        std::uniform_real_distribution<T> uniform(-2, 2);
+
+        ConstantVector<T, N> ret;
+        for (std::size_t i = 0; i < N; ++i)
+            ret[i] = uniform(generator);
+        return ret;
+    }
+
+    template <typename T, std::size_t N>
+    void check_packet()
+    {
+        static_assert(impl::fixed_packet<T, N>::value, "Not a packet type!");
+
+        const T tol = 32 * std::numeric_limits<T>::epsilon();
+
+        for (int r = 0; r < repeats; ++r)
+        {
+            auto a = random<T, N>();
+            auto b = random<T, N>();
+            auto c = random<T, N>();
+
+            T dot = 0;
+            for (std::size_t i = 0; i < N; ++i)
+                dot += a[i] * b[i];
+
+            TS_ASSERT_DELTA(Dot(a, b), dot, tol);
+            TS_ASSERT_DELTA(Norm2Squared(a), Dot(a, a), tol);
+
+            auto n = Normalize(a);
+            auto f = fma(a, b, c);
+            auto l = lerp(a, b, 0.3);
+            auto k = clamp(a, T(-0.5), T(1));
+
+            auto lt = (a < b);
+            auto eq = (a == b);
+
+            TS_ASSERT_DELTA(Norm(n), T(1), tol);
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                TS_ASSERT_DELTA(n[i], a[i] / Norm(a), tol);
+                TS_ASSERT_EQUALS(f[i], std::fma(a[i], b[i], c[i]));
+                TS_ASSERT_DELTA(l[i], a[i] + (b[i] - a[i]) * T(0.3), tol);
+                TS_ASSERT_EQUALS(k[i], clip(a[i], T(-0.5), T(1)));
+                TS_ASSERT_EQUALS(lt[i], a[i] < b[i]);
+                TS_ASSERT_EQUALS(eq[i], a[i] == b[i]);
+            }
+
+            TS_ASSERT(All(a == a));
+            TS_ASSERT(None(a != a));
+            TS_ASSERT_EQUALS(a >= b, !(a < b));
+        }
+    }
+
+    template <typename T>
+    void check_cross()
+    {
+        for (int r = 0; r < repeats; ++r)
+        {
+            auto a = random<T, 4>();
+            auto b = random<T, 4>();
+
+            const ConstantVector<T, 3> a3(a.x, a.y, a.z), b3(b.x, b.y, b.z);
+            const auto expected = Cross(a3, b3);
+            const auto c = Cross(a, b);
+
+            TS_ASSERT_EQUALS(c.x, expected.x);
+            TS_ASSERT_EQUALS(c.y, expected.y);
+            TS_ASSERT_EQUALS(c.z, expected.z);
+            TS_ASSERT_EQUALS(c.w, T(0));
+        }
+    }
+
+public:
+
+    void testLayout()
+    {
+        TS_TRACE("Starting packet layout test");
+
+        // the packets don't change the storage of the vectors
+        TS_ASSERT_EQUALS(sizeof(Vector2d), 2 * sizeof(double));
+        TS_ASSERT_EQUALS(sizeof(Vector3d), 3 * sizeof(double));
+        TS_ASSERT_EQUALS(sizeof(Vector4d), 4 * sizeof(double));
+        TS_ASSERT_EQUALS(sizeof(Vector4f), 4 * sizeof(float));
+        TS_ASSERT_EQUALS(alignof(Vector4d), alignof(double));
+
+        Vector4d v(1., 2., 3., 4.);
+        TS_ASSERT_EQUALS(&v.x, v.data());
+        TS_ASSERT_EQUALS(&v.w, v.data() + 3);
+        TS_ASSERT_EQUALS(v.xyz.z, 3.);
+
+        TS_ASSERT(!(impl::fixed_packet<double, 3>::value));
+        TS_ASSERT(!(impl::fixed_packet<int, 4>::value));
+    }
+
+    void testDouble2()
+    {
+        TS_TRACE("Starting Vector2d packet test");
+        check_packet<double, 2>();
+    }
+
+    void testDouble4()
+    {
+        TS_TRACE("Starting Vector4d packet test");
+        check_packet<double, 4>();
+        check_cross<double>();
+    }
+
+    void testFloat4()
+    {
+        TS_TRACE("Starting Vector4f packet test");
+        check_packet<float, 4>();
+        check_cross<float>();
+    }
+
+    void testSpecialValues()
+    {
+        TS_TRACE("Starting packet special values test");
+
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        Vector4d v(nan, -3., 0.5, 7.);
+
+        // clamp maps NaNs to the lower bound as clip does
+        auto k = clamp(v, 0., 1.);
+        TS_ASSERT_EQUALS(k.x, clip(nan, 0., 1.));
+        TS_ASSERT_EQUALS(k.y, 0.);
+        TS_ASSERT_EQUALS(k.z, 0.5);
+        TS_ASSERT_EQUALS(k.w, 1.);
+
+        auto eq = (v == v);
+        TS_ASSERT(!eq[0]);
+        TS_ASSERT(eq[1] && eq[2] && eq[3]);
+
+        // the generic paths are unchanged
+        Vector4i i(1, 2, 3, 4);
+        TS_ASSERT_EQUALS(Dot(i, i), 30);
+        TS_ASSERT_EQUALS(Cross(i, Vector4i(4, 3, 2, 1)).w, 0);
+    }
+};
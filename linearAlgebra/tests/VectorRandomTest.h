@@ -0,0 +1,160 @@
+// test
+#define _NO_CORE_
+
+#include <cxxtest/TestSuite.h>
+
+#include <iostream>
+#include <string>
+#include <memory>
+
+#include "DynamicVectorCommonTest.h"
+
+#define private public
+#define protected public
+#include "DynamicVector.h"
+#include "VectorRandom.h"
+
+using namespace std;
+
+class CSVectorTest : public CxxTest::TestSuite
+{
+private:
+    int repeats;
+    size_t currentLength;
+    size_t size_step = 256 * 1024;
+
+    const size_t mbytes = 8;
+    const size_t vectorLength = mbytes * 1024 * 1024 / sizeof(double);
+
+    void increaseLength()
+    {
+        if (currentLength <= 1024)
+            currentLength++;
+        else
+        {
+            currentLength += size_step;
+            currentLength = std::min(currentLength, vectorLength);
+        }
+
+        repeats = 3;
+    }
+
+    bool keepGoing()
+    {
+        return (currentLength < vectorLength);
+    }
+
+public:
+
+    void setUp()
+    {
+        repeats = 3;
+        currentLength = 1;
+    }
+
+    void tearDown()
+    {}
+
+    void testPhilox()
+    {
+        // known answers of the Random123 reference implementation
+        uint32_t r[4] = {0, 0, 0, 0};
+        impl::philox4x32(r, 0, 0);
+        TS_ASSERT_EQUALS(r[0], 0x6627e8d5u);
+        TS_ASSERT_EQUALS(r[1], 0xe169c58du);
+        TS_ASSERT_EQUALS(r[2], 0xbc57ac4cu);
+        TS_ASSERT_EQUALS(r[3], 0x9b00dbd8u);
+
+        uint32_t s[4] = {0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu};
+        impl::philox4x32(s, 0xffffffffu, 0xffffffffu);
+        TS_ASSERT_EQUALS(s[0], 0x408f276du);
+        TS_ASSERT_EQUALS(s[1], 0x41c83b0eu);
+        TS_ASSERT_EQUALS(s[2], 0xa20bc7c6u);
+        TS_ASSERT_EQUALS(s[3], 0x6d5451fdu);
+    }
+
+    void testReproducible()
+    {
+        TS_TRACE("Starting random reproducibility test");
+        while (keepGoing())
+        {
+            while (repeats --> 0)
+            {
+                const uint64_t seed = 12345 + repeats;
+
+                CSVector<double> vec1(currentLength), vec2(currentLength);
+                fillNormal(vec1, seed);
+                vec2 = randn(currentLength, seed);
+
+                // the fill and the expression agree, and so does a longer vector
+                CSVector<double> vec3(currentLength + 3);
+                fillNormal(vec3, seed);
+
+                // the element-wise evaluation agrees too
+                CSVector<double> vec4(currentLength);
+                vec4 = 1. * randn(currentLength, seed);
+
+                bool same = true;
+                for (size_t i = 0; i < currentLength; ++i)
+                    same &= (vec1[i] == vec2[i]) && (vec1[i] == vec3[i]) && (vec1[i] == vec4[i]);
+                TS_ASSERT(same);
+
+                fillUniform(vec1, seed, -1., 1.);
+                vec2 = -1. + 2. * randu(currentLength, seed);
+                same = true;
+                for (size_t i = 0; i < currentLength; ++i)
+                    same &= std::abs(vec1[i] - vec2[i]) < 1e-15;
+                TS_ASSERT(same);
+            }
+
+            increaseLength();
+        }
+    }
+
+    void testDistribution()
+    {
+        TS_TRACE("Starting random distribution test");
+        const size_t N = vectorLength;
+
+        CSVector<double> vec(N);
+        fillUniform(vec, 42);
+
+        auto stats = statistics(vec);
+        TS_ASSERT(stats.min >= 0. && stats.max < 1.);
+        TS_ASSERT_DELTA(stats.mean, 0.5, 5. / std::sqrt(12. * double(N)));
+        TS_ASSERT_DELTA(stats.variance(), 1. / 12., 0.01 / 12.);
+
+        vec = 2. + 3. * randn(N, 42);
+        stats = moments(vec);
+        TS_ASSERT_DELTA(stats.mean, 2., 5. * 3. / std::sqrt(double(N)));
+        TS_ASSERT_DELTA(std::sqrt(stats.variance()), 3., 0.01);
+        TS_ASSERT_DELTA(stats.kurtosis(), 3., 0.05);
+
+        // different seeds and streams are uncorrelated
+        CSVector<double> other(N);
+        fillUniform(other, 43);
+        TS_ASSERT_DELTA(dot(randu(N, 42) - 0.5, other - 0.5) / double(N), 0., 5. / (12. * std::sqrt(double(N))));
+    }
+
+    void testFloat()
+    {
+        CSVector<float> vec(1001);
+        fillNormal(vec, 7, 1.f, 2.f);
+
+        CSVector<float> vec2(1001);
+        vec2 = 1.f + 2.f * randn<float>(1001, 7);
+        TS_ASSERT_DELTA(supNorm(vec - vec2), 0.f, 1e-5f);
+
+        // uniforms which round up to the end of the interval stay below it
+        const double u = 1. - 0x1.0p-53;
+        TS_ASSERT_LESS_THAN(impl::uniform_distribution::to(u, 0.f, 1.f), 1.f);
+        TS_ASSERT_LESS_THAN(impl::uniform_distribution::to(u, -2.f, 3.f), 3.f);
+        TS_ASSERT_LESS_THAN(impl::uniform_distribution::to(u, 0., 1.), 1.);
+
+        fillUniform(vec, 7, 1.f, 1.000001f);
+        const auto stats = statistics(vec);
+        TS_ASSERT(stats.min >= 1.f && stats.max < 1.000001f);
+
+        TS_ASSERT_THROWS(vec = randu<float>(1000, 7), std::runtime_error);
+    }
+};
@@ -0,0 +1,197 @@
+// test
+#define _NO_CORE_
+
+#include <cxxtest/TestSuite.h>
+
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "DynamicVectorCommonTest.h"
+
+#define private public
+#define protected public
+#include "VectorSoA.h"
+
+using namespace std;
+
+class CSVectorTest : public CxxTest::TestSuite
+{
+private:
+    double tol = 1e-12;
+    std::mt19937 generator {42};
+
+    std::vector<Vector3d> points(size_t n)
+    {
+        std::uniform_real_distribution<double> uniform(-10., 10.);
+
+        std::vector<Vector3d> ret(n);
+        for (auto& p : ret)
+            p = Vector3d(uniform(generator), uniform(generator), uniform(generator));
+        return ret;
+    }
+
+    void assert_equals(const Vector3d& a, const Vector3d& b, double eps)
+    {
+        TS_ASSERT_DELTA(a.x, b.x, eps);
+        TS_ASSERT_DELTA(a.y, b.y, eps);
+        TS_ASSERT_DELTA(a.z, b.z, eps);
+    }
+
+public:
+
+    void testConversion()
+    {
+        TS_TRACE("Starting SoA conversion test");
+
+        const auto p = points(1000);
+        VectorSoA<double, 3> soa(p);
+
+        TS_ASSERT_EQUALS(soa.size(), p.size());
+        TS_ASSERT_EQUALS(size(soa), p.size());
+        TS_ASSERT_EQUALS(soa.components(), 3u);
+
+        for (size_t i = 0; i < p.size(); ++i)
+        {
+            TS_ASSERT_EQUALS(soa.column(0)[i], p[i].x);
+            TS_ASSERT_EQUALS(soa.column(1)[i], p[i].y);
+            TS_ASSERT_EQUALS(soa.column(2)[i], p[i].z);
+            assert_equals(soa(i), p[i], 0.);
+        }
+
+        // the columns are aligned
+        for (size_t k = 0; k < 3; ++k)
+            TS_ASSERT_EQUALS(reinterpret_cast<uintptr_t>(soa.column(k).data()) % __alignment, 0u);
+
+        soa.set(7, Vector3d(1., 2., 3.));
+        assert_equals(soa.at(7), Vector3d(1., 2., 3.), 0.);
+        TS_ASSERT_THROWS(soa.at(1000), std::out_of_range);
+
+        const auto back = soa.to_vector();
+        TS_ASSERT_EQUALS(back.size(), p.size());
+        assert_equals(back[3], p[3], 0.);
+
+        // the columns take part in the expressions
+        CSVector<double> sum = soa.column(0) + soa.column(1);
+        TS_ASSERT_EQUALS(sum[3], p[3].x + p[3].y);
+
+        VectorSoA<double, 3> copy(soa);
+        copy = soa;
+        assert_equals(copy(7), Vector3d(1., 2., 3.), 0.);
+    }
+
+    void testKernels()
+    {
+        TS_TRACE("Starting SoA kernel test");
+
+        // below and above the parallel threshold
+        for (size_t n : {size_t(1), size_t(37), size_t(1000), size_t(ReductionParallelThreshold + 13)})
+        {
+            const auto p = points(n);
+            const auto q = points(n);
+            VectorSoA<double, 3> a(p), b(q);
+
+            auto norm   = Norm(a);
+            auto norm2  = Norm2Squared(a);
+            auto dot    = Dot(a, b);
+            auto dist   = EuclideanDistance(a, b);
+            auto unit   = Normalize(a);
+            auto cross  = Cross(a, b);
+
+            const Vector3d axis = Normalize(Vector3d(1., -2., 0.5));
+            auto rotated = Rotate(a, axis, 0.7);
+
+            for (size_t i = 0; i < n; ++i)
+            {
+                TS_ASSERT_DELTA(norm[i], Norm(p[i]), tol);
+                TS_ASSERT_DELTA(norm2[i], Norm2Squared(p[i]), 1e-10);
+                TS_ASSERT_DELTA(dot[i], Dot(p[i], q[i]), 1e-10);
+                TS_ASSERT_DELTA(dist[i], EuclideanDistance(p[i], q[i]), tol);
+                assert_equals(unit(i), Normalize(p[i]), tol);
+                assert_equals(cross(i), Cross(p[i], q[i]), 1e-10);
+                assert_equals(rotated(i), Rotate(p[i], axis, 0.7), 1e-10);
+            }
+        }
+    }
+
+    void testUnitVector()
+    {
+        TS_TRACE("Starting SoA unit vector test");
+
+        const size_t n = 5000;
+        CSVector<double> theta(n), phi(n);
+        std::uniform_real_distribution<double> uniform(-7., 7.);
+        for (size_t i = 0; i < n; ++i)
+        {
+            theta[i] = uniform(generator);
+            phi[i]   = uniform(generator);
+        }
+
+        auto u = UnitVector(theta, phi);
+        for (size_t i = 0; i < n; ++i)
+            assert_equals(u(i), UnitVector(theta[i], phi[i]), tol);
+    }
+
+    void testTransforms()
+    {
+        TS_TRACE("Starting SoA transform test");
+
+        for (size_t n : {size_t(19), size_t(ReductionParallelThreshold + 5)})
+        {
+            const auto p = points(n);
+            VectorSoA<double, 3> a(p);
+
+            const auto t = BasicDatatypes::Transform<double>::scale(2., 3., 0.5);
+            const auto q = Quaterniond::rotate(Normalize(Vector3d(0.3, 1., -1.)), 2.1);
+
+            auto scaled = t.apply(a);
+            auto back   = t.inverse().apply(scaled);
+            auto turned = Rotate(a, q);
+
+            // per element axes, angles and quaternions
+            VectorSoA<double, 3> axes(Normalize(VectorSoA<double, 3>(points(n))));
+            CSVector<double> angles(n);
+            VectorSoA<double, 4> quaternions(n);
+            for (size_t i = 0; i < n; ++i)
+            {
+                angles[i] = 0.001 * double(i) - 3.;
+                quaternions.set(i, Quaterniond::rotate(axes(i), angles[i]).coeffs());
+            }
+
+            auto each  = Rotate(a, axes, angles);
+            auto eachq = Rotate(a, quaternions);
+
+            for (size_t i = 0; i < n; ++i)
+            {
+                assert_equals(scaled(i), t(p[i]), 0.);
+                assert_equals(back(i), p[i], tol);
+                assert_equals(turned(i), q(p[i]), 1e-10);
+                assert_equals(each(i), Rotate(p[i], axes(i), angles[i]), 1e-10);
+                assert_equals(eachq(i), Rotate(p[i], axes(i), angles[i]), 1e-10);
+            }
+        }
+
+        VectorSoA<double, 3> a(10), axes(10);
+        TS_ASSERT_THROWS(Rotate(a, axes, CSVector<double>(9)), std::runtime_error);
+        TS_ASSERT_THROWS(Rotate(a, VectorSoA<double, 4>(9)), std::runtime_error);
+    }
+
+    void testMismatch()
+    {
+        TS_TRACE("Starting SoA mismatch test");
+
+        VectorSoA<double, 3> a(10), b(11);
+        TS_ASSERT_THROWS(Dot(a, b), std::runtime_error);
+        TS_ASSERT_THROWS(Cross(a, b), std::runtime_error);
+        TS_ASSERT_THROWS(EuclideanDistance(a, b), std::runtime_error);
+        TS_ASSERT_THROWS(UnitVector(CSVector<double>(3), CSVector<double>(4)), std::runtime_error);
+
+        // other sizes and types
+        VectorSoA<float, 2> c(std::vector<Vector2f>{Vector2f(3.f, 4.f), Vector2f(0.f, 2.f)});
+        auto n = Norm(c);
+        TS_ASSERT_EQUALS(n[0], 5.f);
+        TS_ASSERT_EQUALS(n[1], 2.f);
+    }
+};
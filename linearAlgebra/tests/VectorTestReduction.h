@@ -500,6 +500,11 @@ public:
         float norm2 = Norm2Squared(c2 - d2);
         TS_ASSERT_DELTA(norm2, 0, ftol);
 
+        // the norms of fixed length float vectors stay in float
+        TS_ASSERT((std::is_same<decltype(Norm2Squared(c2 - d2)), float>::value));
+        TS_ASSERT((std::is_same<decltype(Norm(c2 - d2)), float>::value));
+        TS_ASSERT((std::is_same<decltype(Normalize(c2)), Vector2f>::value));
+
         Vector3f c3 {getVector3f()};
         Vector3f d3 {getVector3f()};
 
@@ -33,6 +33,7 @@
 #include "VectorExpression.h"
 #include "VectorOperations.h"
 #include "VectorReduction.h"
+#include "vector_packet.h"
 
 #include "bool_vector.h"
 
@@ -778,7 +779,10 @@ auto inline Norm(const ConstantVector<T, 4>& vector)
 template <typename T>
 auto inline Norm2Squared(const ConstantVector<T, 2>& vector)
 {
-    return vector.x * vector.x + vector.y * vector.y;
+    if constexpr (impl::fixed_packet<T, 2>::value)
+        return Dot(vector, vector);
+    else
+        return vector.x * vector.x + vector.y * vector.y;
 }
 
 template <typename T>
@@ -790,14 +794,26 @@ auto inline Norm2Squared(const ConstantVector<T, 3>& vector)
 template <typename T>
 auto inline Norm2Squared(const ConstantVector<T, 4>& vector)
 {
-    return vector.x * vector.x + vector.y * vector.y + vector.z * vector.z + vector.w * vector.w;
+    if constexpr (impl::fixed_packet<T, 4>::value)
+        return Dot(vector, vector);
+    else
+        return vector.x * vector.x + vector.y * vector.y + vector.z * vector.z + vector.w * vector.w;
 }
 
 // Need to do this here since we need to construct the correct Derived class
 template <typename Derived, typename T, std::size_t N>
 Derived inline Normalize(const BaseConstantVector<Derived, T, N>& vector)
 {
-    return {vector / Norm(vector)};
+    if constexpr (Same<Derived, ConstantVector<T, N> >() && impl::fixed_packet<T, N>::value)
+    {
+        const auto p = impl::packet_load<T, N>(vector.data());
+
+        Derived ret;
+        impl::packet_store<T, N>(ret.data(), p / impl::packet_broadcast<T, N>(T(Norm(static_cast<const Derived&>(vector)))));
+        return ret;
+    }
+    else
+        return {vector / Norm(vector)};
 }
 
 // TODO turn on only for signed types!
@@ -888,7 +904,10 @@ auto Dot(const ConstantVector<T, N>& lhs, const ConstantVector<T, N>& rhs)
 template <typename T>
 auto Dot(const ConstantVector<T, 2>& lhs, const ConstantVector<T, 2>& rhs)
 {
-    return lhs.x * rhs.x + lhs.y * rhs.y;
+    if constexpr (impl::fixed_packet<T, 2>::value)
+        return impl::packet_sum<T, 2>(impl::packet_load<T, 2>(lhs.data()) * impl::packet_load<T, 2>(rhs.data()));
+    else
+        return lhs.x * rhs.x + lhs.y * rhs.y;
 }
 
 template <typename T>
@@ -900,7 +919,10 @@ auto Dot(const ConstantVector<T, 3>& lhs, const ConstantVector<T, 3>& rhs)
 template <typename T>
 auto Dot(const ConstantVector<T, 4>& lhs, const ConstantVector<T, 4>& rhs)
 {
-    return lhs.x * rhs.x + lhs.y * rhs.y + lhs.z * rhs.z + lhs.w * rhs.w;
+    if constexpr (impl::fixed_packet<T, 4>::value)
+        return impl::packet_sum<T, 4>(impl::packet_load<T, 4>(lhs.data()) * impl::packet_load<T, 4>(rhs.data()));
+    else
+        return lhs.x * rhs.x + lhs.y * rhs.y + lhs.z * rhs.z + lhs.w * rhs.w;
 }
 
 template <typename T, typename Transform, std::size_t N>
@@ -925,6 +947,35 @@ ConstantVector<T, 3> Cross(const ConstantVector<T, 3>& lhs,
             lhs.x * rhs.y - lhs.y * rhs.x};
 }
 
+// The cross product of the xyz parts of homogeneous vectors, w is zero
+template <typename T>
+ConstantVector<T, 4> Cross(const ConstantVector<T, 4>& lhs,
+                        const ConstantVector<T, 4>& rhs)
+{
+    if constexpr (impl::fixed_packet<T, 4>::value)
+    {
+        using mask = typename impl::fixed_packet<T, 4>::mask;
+
+        const auto a = impl::packet_load<T, 4>(lhs.data());
+        const auto b = impl::packet_load<T, 4>(rhs.data());
+
+        // (y, z, x, w) and (z, x, y, w)
+        const mask yzx = {1, 2, 0, 3};
+        const mask zxy = {2, 0, 1, 3};
+
+        ConstantVector<T, 4> ret;
+        impl::packet_store<T, 4>(ret.data(), __builtin_shuffle(a, yzx) * __builtin_shuffle(b, zxy)
+                                           - __builtin_shuffle(a, zxy) * __builtin_shuffle(b, yzx));
+        ret.w = T(0);
+        return ret;
+    }
+    else
+        return {lhs.y * rhs.z - lhs.z * rhs.y,
+                lhs.z * rhs.x - lhs.x * rhs.z,
+                lhs.x * rhs.y - lhs.y * rhs.x,
+                T(0)};
+}
+
 template <typename T, std::size_t N>
 auto minComponent(const ConstantVector<T, N>& vector)
 {
@@ -981,10 +1032,14 @@ template <typename T, std::size_t N,
 auto fma(const ConstantVector<T, N>& x, const ConstantVector<T, N>& y,
          const ConstantVector<T, N>& z)
 {
-    // can we make this a AVX?
     ConstantVector<T, N> ret;
-    for (std::size_t i = 0; i < N; i++)
-        ret[i] = std::fma(x[i], y[i], z[i]);
+    if constexpr (impl::fixed_packet<T, N>::value)
+        impl::packet_store<T, N>(ret.data(), impl::packet_fma<T, N>(impl::packet_load<T, N>(x.data()),
+                                                                    impl::packet_load<T, N>(y.data()),
+                                                                    impl::packet_load<T, N>(z.data())));
+    else
+        for (std::size_t i = 0; i < N; i++)
+            ret[i] = std::fma(x[i], y[i], z[i]);
     return ret;
 }
 
@@ -1030,7 +1085,17 @@ template <typename T, std::size_t N>
 ConstantVector<T, N> lerp(const ConstantVector<T, N>& start,
                        const ConstantVector<T, N> end, double t)
 {
-    return start + (end - start) * clip(t, 0., 1.);
+    if constexpr (impl::fixed_packet<T, N>::value)
+    {
+        const auto a = impl::packet_load<T, N>(start.data());
+        const auto b = impl::packet_load<T, N>(end.data());
+
+        ConstantVector<T, N> ret;
+        impl::packet_store<T, N>(ret.data(), a + (b - a) * T(clip(t, 0., 1.)));
+        return ret;
+    }
+    else
+        return start + (end - start) * clip(t, 0., 1.);
 }
 
 template <typename T, typename U, std::size_t N,
@@ -1039,8 +1104,19 @@ auto clamp(const ConstantVector<T, N>& vector,
            const U lower_bound, const U upper_bound)
 {
     ConstantVector<T, N> ret;
-    std::transform(vector.cbegin(), vector.cend(), ret.begin(),
-                   std::bind(clip<T>, _1, T(lower_bound), T(upper_bound)));
+    if constexpr (impl::fixed_packet<T, N>::value)
+    {
+        // as clip: max(lower, min(v, upper)), so a NaN becomes the lower bound
+        const auto v     = impl::packet_load<T, N>(vector.data());
+        const auto lower = impl::packet_broadcast<T, N>(T(lower_bound));
+        const auto upper = impl::packet_broadcast<T, N>(T(upper_bound));
+
+        const auto m = (upper < v) ? upper : v;
+        impl::packet_store<T, N>(ret.data(), (lower < m) ? m : lower);
+    }
+    else
+        std::transform(vector.cbegin(), vector.cend(), ret.begin(),
+                       std::bind(clip<T>, _1, T(lower_bound), T(upper_bound)));
     return ret;
 }
 
@@ -1055,6 +1131,10 @@ template <typename T, std::size_t N>
 BoolVector<N> operator==(const ConstantVector<T, N>& vec1,
                          const ConstantVector<T, N>& vec2)
 {
+    if constexpr (impl::fixed_packet<T, N>::value)
+        return BoolVector<N>(impl::packet_bits<T, N>(impl::packet_load<T, N>(vec1.data())
+                                                     == impl::packet_load<T, N>(vec2.data())));
+
     BoolVector<N> ret;
     for (std::size_t i = 0; i < N; ++i)
         ret[i] = (vec1[i] == vec2[i]);
@@ -1104,6 +1184,10 @@ template <typename T, std::size_t N>
 BoolVector<N> operator<(const ConstantVector<T, N>& vec1,
                         const ConstantVector<T, N>& vec2)
 {
+    if constexpr (impl::fixed_packet<T, N>::value)
+        return BoolVector<N>(impl::packet_bits<T, N>(impl::packet_load<T, N>(vec1.data())
+                                                     < impl::packet_load<T, N>(vec2.data())));
+
     BoolVector<N> ret;
     for (std::size_t i = 0; i < N; ++i)
         ret[i] = (vec1[i] < vec2[i]);
@@ -1217,7 +1301,11 @@ auto Angle2(const ConstantVector<T, 3>& a, const ConstantVector<T, 3>& b)
 template <typename T, std::size_t N>
 auto EuclideanDistance(const ConstantVector<T, N>& a, const ConstantVector<T, N>& b)
 {
-    return Norm(a - b);
+    // Norm(a - b) would return a lazy reduction of the temporary difference
+    if constexpr (N <= 4)
+        return Norm(ConstantVector<T, N>(a - b));
+    else
+        return Norm2(a - b);
 }
 
 // input and output
@@ -0,0 +1,137 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  File Name:  vector_packet.h                                               //
+//                                                                            //
+//     Author:  Andreas Buttenschoen <andreas@buttenschoen.ca>                //
+//    Created:  2026-10-19 04:48:05                                           //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef VECTOR_PACKET_H
+#define VECTOR_PACKET_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#endif
+
+//
+// The fixed size vectors which fill a SIMD register, ConstantVector<float, 4>
+// (xmm), ConstantVector<double, 2> (xmm) and ConstantVector<double, 4> (ymm),
+// are evaluated as a single packet by the functions in vector_detail.h.
+//
+// The storage of the vectors is unchanged, i.e. m_data and the x, y, z, w
+// members stay where they are. Storing the register type instead would raise
+// the alignment of the vectors, and with it the size of Vector3d, which holds
+// a ConstantVector<T, 2> in its union. The packets are therefore loaded and
+// stored unaligned, which costs nothing on current hardware once the data is
+// in L1.
+//
+namespace impl {
+
+template <typename T, std::size_t N>
+struct fixed_packet
+{
+    static constexpr bool value = false;
+};
+
+template <>
+struct fixed_packet<float, 4>
+{
+    static constexpr bool value = true;
+
+    typedef float        type __attribute__((vector_size (16), aligned (4), may_alias));
+    typedef std::int32_t mask __attribute__((vector_size (16)));
+};
+
+template <>
+struct fixed_packet<double, 2>
+{
+    static constexpr bool value = true;
+
+    typedef double       type __attribute__((vector_size (16), aligned (8), may_alias));
+    typedef std::int64_t mask __attribute__((vector_size (16)));
+};
+
+template <>
+struct fixed_packet<double, 4>
+{
+    static constexpr bool value = true;
+
+    typedef double       type __attribute__((vector_size (32), aligned (8), may_alias));
+    typedef std::int64_t mask __attribute__((vector_size (32)));
+};
+
+template <typename T, std::size_t N>
+using fixed_packet_t = typename fixed_packet<T, N>::type;
+
+// through the may_alias types, GCC lowers a memcpy of the under-aligned types
+// through the stack
+template <typename T, std::size_t N>
+inline fixed_packet_t<T, N> packet_load(const T * data)
+{
+    return *reinterpret_cast<const fixed_packet_t<T, N> *>(data);
+}
+
+template <typename T, std::size_t N>
+inline void packet_store(T * data, const fixed_packet_t<T, N>& p)
+{
+    *reinterpret_cast<fixed_packet_t<T, N> *>(data) = p;
+}
+
+template <typename T, std::size_t N>
+inline fixed_packet_t<T, N> packet_broadcast(const T value)
+{
+    fixed_packet_t<T, N> p;
+    for (std::size_t i = 0; i < N; ++i)
+        p[i] = value;
+    return p;
+}
+
+// in the order of the scalar sum, so that the result doesn't change
+template <typename T, std::size_t N>
+inline T packet_sum(const fixed_packet_t<T, N>& p)
+{
+    T sum = p[0];
+    for (std::size_t i = 1; i < N; ++i)
+        sum += p[i];
+    return sum;
+}
+
+// one bit per lane of a comparison
+template <typename T, std::size_t N>
+inline unsigned long long packet_bits(const typename fixed_packet<T, N>::mask& m)
+{
+    unsigned long long bits = 0;
+    for (std::size_t i = 0; i < N; ++i)
+        bits |= (unsigned long long)(m[i] != 0) << i;
+    return bits;
+}
+
+// fused on hardware with FMA, the lanes are rounded as by std::fma
+template <typename T, std::size_t N>
+inline fixed_packet_t<T, N> packet_fma(const fixed_packet_t<T, N>& x, const fixed_packet_t<T, N>& y,
+                                       const fixed_packet_t<T, N>& z)
+{
+#if defined(__FMA__)
+    if constexpr (std::is_same<T, float>::value)
+        return fixed_packet_t<T, N>(_mm_fmadd_ps(__m128(x), __m128(y), __m128(z)));
+    else if constexpr (N == 2)
+        return fixed_packet_t<T, N>(_mm_fmadd_pd(__m128d(x), __m128d(y), __m128d(z)));
+    else
+        return fixed_packet_t<T, N>(_mm256_fmadd_pd(__m256d(x), __m256d(y), __m256d(z)));
+#else
+    fixed_packet_t<T, N> r;
+    for (std::size_t i = 0; i < N; ++i)
+        r[i] = std::fma(x[i], y[i], z[i]);
+    return r;
+#endif
+}
+
+} // end namespace
+
+#endif